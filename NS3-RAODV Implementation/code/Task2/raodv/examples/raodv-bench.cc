@@ -0,0 +1,658 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Microbenchmarks of the raodv data structures.
+ */
+
+#include "ns3/raodv-id-cache.h"
+#include "ns3/raodv-neighbor.h"
+#include "ns3/raodv-rqueue.h"
+#include "ns3/raodv-rtable.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+using namespace ns3::raodv;
+
+/**
+ * \ingroup raodv-examples
+ * \ingroup examples
+ * \brief Microbenchmarks of the raodv data structures.
+ *
+ * RoutingTable, RequestQueue, Neighbors and IdCache are driven directly, without nodes or
+ * packets on the air. Each structure is filled with a given number of entries and then runs an
+ * operation mix. The simulated clock advances by a fixed step per operation, so expiry and
+ * purging behave as in a simulation. Every (structure, mix, size) combination writes one CSV
+ * line with the wall time, heap allocations per operation and the peak heap bytes of the
+ * structure:
+ *
+ * \code
+ * ./ns3 run "raodv-bench --sizes=10,1000,100000 --label=$(git rev-parse --short HEAD)"
+ * \endcode
+ *
+ * Lines of runs at different commits can be concatenated and compared by label.
+ */
+
+/// Heap allocations since the start of the program
+static uint64_t g_allocations = 0;
+/// Bytes currently allocated on the heap
+static uint64_t g_liveBytes = 0;
+/// Largest value of g_liveBytes since the last reset
+static uint64_t g_peakBytes = 0;
+
+/// Room in front of each allocation to keep its size, keeps the maximum alignment
+static constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+
+void*
+operator new(size_t size)
+{
+    auto block = static_cast<char*>(std::malloc(size + ALLOCATION_HEADER));
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    g_allocations++;
+    g_liveBytes += size;
+    g_peakBytes = std::max(g_peakBytes, g_liveBytes);
+    return block + ALLOCATION_HEADER;
+}
+
+void*
+operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+    if (!p)
+    {
+        return;
+    }
+    char* block = static_cast<char*>(p) - ALLOCATION_HEADER;
+    g_liveBytes -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+    operator delete(p);
+}
+
+void
+operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+void
+operator delete[](void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+/// Operations of a benchmark mix
+enum Operation
+{
+    OP_LOOKUP, ///< Look up an existing entry
+    OP_UPDATE, ///< Refresh an existing entry
+    OP_INSERT, ///< Add a new entry
+    OP_REMOVE, ///< Remove the oldest entry
+    OPERATIONS ///< Number of operations
+};
+
+/// Operation mix
+struct Mix
+{
+    const char* name;           ///< Name in the output
+    uint32_t share[OPERATIONS]; ///< Percentage of each operation
+    bool recent;                ///< Lookups and updates hit the most recent entries
+};
+
+/// Mixes run on every structure
+static const Mix MIXES[] = {
+    // Forwarding: routes and neighbors are looked up per packet and rarely change
+    {"lookup-heavy", {80, 10, 5, 5}, false},
+    // Mobility: routes and neighbors come and go
+    {"churn-heavy", {20, 10, 35, 35}, false},
+    // Flooding: every RREQ is new once and then heard again from the other neighbors
+    {"flood-heavy", {60, 10, 30, 0}, true},
+};
+
+/**
+ * \ingroup raodv-examples
+ * \brief One data structure under benchmark.
+ *
+ * Entries are identified by consecutive keys. Structures without a delete operation drop their
+ * entries by expiry, with a lifetime chosen by the driver to keep the requested size.
+ */
+class StructureBench
+{
+  public:
+    virtual ~StructureBench() = default;
+
+    /// \returns the name of the structure in the output
+    virtual std::string GetName() const = 0;
+    /// \returns true if the structure has a delete operation
+    virtual bool CanRemove() const = 0;
+    /**
+     * Create the empty structure
+     * \param size the number of entries the benchmark keeps
+     * \param lifetime the lifetime of the entries
+     * \param inserts an upper bound of the entries added, fill included
+     */
+    virtual void Create(uint32_t size, Time lifetime, uint32_t inserts) = 0;
+    /// Destroy the structure
+    virtual void Destroy() = 0;
+    /**
+     * Run one operation
+     * \param op the operation
+     * \param key the key of the entry
+     */
+    virtual void Run(Operation op, uint32_t key) = 0;
+
+  protected:
+    /**
+     * \param key the key of an entry
+     * \returns the address standing for the key
+     */
+    static Ipv4Address GetAddress(uint32_t key)
+    {
+        return Ipv4Address(Ipv4Address("10.0.0.1").Get() + key);
+    }
+};
+
+/// RoutingTable benchmark: routes to destinations
+class RoutingTableBench : public StructureBench
+{
+  public:
+    std::string GetName() const override
+    {
+        return "routing-table";
+    }
+
+    bool CanRemove() const override
+    {
+        return true;
+    }
+
+    void Create(uint32_t, Time lifetime, uint32_t) override
+    {
+        m_lifetime = lifetime;
+        m_table = new RoutingTable(Seconds(5));
+    }
+
+    void Destroy() override
+    {
+        delete m_table;
+        m_table = nullptr;
+    }
+
+    void Run(Operation op, uint32_t key) override
+    {
+        RoutingTableEntry rt;
+        switch (op)
+        {
+        case OP_LOOKUP:
+            m_table->LookupValidRoute(GetAddress(key), rt);
+            break;
+        case OP_UPDATE:
+            if (m_table->LookupRoute(GetAddress(key), rt))
+            {
+                rt.SetLifeTime(m_lifetime);
+                m_table->Update(rt);
+            }
+            break;
+        case OP_INSERT: {
+            RoutingTableEntry entry(nullptr,
+                                    GetAddress(key),
+                                    true,
+                                    key,
+                                    Ipv4InterfaceAddress(Ipv4Address("10.255.255.254"),
+                                                         Ipv4Mask("255.0.0.0")),
+                                    3,
+                                    GetAddress(key % 16),
+                                    m_lifetime);
+            m_table->AddRoute(entry);
+            break;
+        }
+        case OP_REMOVE:
+            m_table->DeleteRoute(GetAddress(key));
+            break;
+        default:
+            break;
+        }
+    }
+
+  private:
+    RoutingTable* m_table{nullptr}; ///< Structure under benchmark
+    Time m_lifetime;                ///< Route lifetime
+};
+
+/// RequestQueue benchmark: packets waiting for routes to destinations
+class RequestQueueBench : public StructureBench
+{
+  public:
+    std::string GetName() const override
+    {
+        return "request-queue";
+    }
+
+    bool CanRemove() const override
+    {
+        return true;
+    }
+
+    void Create(uint32_t size, Time lifetime, uint32_t inserts) override
+    {
+        m_queue = new RequestQueue(size, lifetime);
+        // Packets are created up front, so the measurements only cover the queue
+        m_packets.reserve(inserts);
+        for (uint32_t i = 0; i < inserts; ++i)
+        {
+            m_packets.push_back(ns3::Create<Packet>(64));
+        }
+        m_next = 0;
+    }
+
+    void Destroy() override
+    {
+        delete m_queue;
+        m_queue = nullptr;
+        m_packets.clear();
+        m_packets.shrink_to_fit();
+    }
+
+    void Run(Operation op, uint32_t key) override
+    {
+        QueueEntry entry;
+        switch (op)
+        {
+        case OP_LOOKUP:
+            m_queue->Find(GetAddress(key));
+            break;
+        case OP_UPDATE:
+        // Another packet for the same destination
+        case OP_INSERT:
+            Enqueue(key);
+            break;
+        case OP_REMOVE:
+            m_queue->Dequeue(GetAddress(key), entry);
+            break;
+        default:
+            break;
+        }
+    }
+
+  private:
+    /**
+     * Enqueue the next packet of the pool
+     * \param key the key of the destination
+     */
+    void Enqueue(uint32_t key)
+    {
+        Ipv4Header header;
+        header.SetDestination(GetAddress(key));
+        QueueEntry entry(m_packets[m_next++ % m_packets.size()], header);
+        m_queue->Enqueue(entry);
+    }
+
+    RequestQueue* m_queue{nullptr};     ///< Structure under benchmark
+    std::vector<Ptr<Packet>> m_packets; ///< Packets to enqueue
+    uint32_t m_next{0};                 ///< Next packet of the pool
+};
+
+/// Neighbors benchmark: neighbors heard from, dropped by expiry
+class NeighborsBench : public StructureBench
+{
+  public:
+    std::string GetName() const override
+    {
+        return "neighbors";
+    }
+
+    bool CanRemove() const override
+    {
+        return false;
+    }
+
+    void Create(uint32_t, Time lifetime, uint32_t) override
+    {
+        m_lifetime = lifetime;
+        m_nb = new Neighbors();
+    }
+
+    void Destroy() override
+    {
+        delete m_nb;
+        m_nb = nullptr;
+    }
+
+    void Run(Operation op, uint32_t key) override
+    {
+        switch (op)
+        {
+        case OP_LOOKUP:
+            m_nb->IsNeighbor(GetAddress(key));
+            break;
+        case OP_UPDATE:
+        case OP_INSERT:
+            m_nb->Update(GetAddress(key), m_lifetime);
+            break;
+        default:
+            break;
+        }
+    }
+
+  private:
+    Neighbors* m_nb{nullptr}; ///< Structure under benchmark
+    Time m_lifetime;          ///< Neighbor lifetime
+};
+
+/// IdCache benchmark: RREQ IDs of 64 originators, dropped by expiry
+class IdCacheBench : public StructureBench
+{
+  public:
+    std::string GetName() const override
+    {
+        return "id-cache";
+    }
+
+    bool CanRemove() const override
+    {
+        return false;
+    }
+
+    void Create(uint32_t, Time lifetime, uint32_t) override
+    {
+        m_cache = new IdCache(lifetime);
+    }
+
+    void Destroy() override
+    {
+        delete m_cache;
+        m_cache = nullptr;
+    }
+
+    void Run(Operation op, uint32_t key) override
+    {
+        if (op != OP_REMOVE)
+        {
+            // Inserts the ID the first time, finds it afterwards
+            m_cache->IsDuplicate(GetAddress(key % 64), key);
+        }
+    }
+
+  private:
+    IdCache* m_cache{nullptr}; ///< Structure under benchmark
+};
+
+/// Result of one benchmark
+struct BenchResult
+{
+    double nsPerOp;     ///< Wall time per operation, ns
+    double allocsPerOp; ///< Heap allocations per operation
+    uint64_t peakBytes; ///< Peak heap bytes of the structure, fill included
+};
+
+/**
+ * \ingroup raodv-examples
+ * \brief Runs the structures under a simulated clock and writes the results.
+ */
+class RaodvBench
+{
+  public:
+    RaodvBench();
+    /**
+     * \brief Configure script parameters
+     * \param argc is the command line argument count
+     * \param argv is the command line arguments
+     * \return true on successful configuration
+     */
+    bool Configure(int argc, char** argv);
+    /// Run all benchmarks
+    void Run();
+
+  private:
+    /**
+     * Run one benchmark
+     * \param bench the structure
+     * \param mix the operation mix
+     * \param size the number of entries
+     * \returns the measurements
+     */
+    BenchResult RunBench(StructureBench& bench, const Mix& mix, uint32_t size);
+    /**
+     * Run a batch of operations at the current simulated time and schedule the next one
+     * \param bench the structure
+     * \param first the first operation of the batch
+     */
+    void RunBatch(StructureBench* bench, size_t first);
+
+    // parameters
+    /// Comma separated numbers of entries
+    std::string sizes;
+    /// Comma separated structure names, or all
+    std::string structures;
+    /// Operations per benchmark
+    uint32_t ops;
+    /// Operations between clock advances
+    uint32_t batch;
+    /// Simulated time per operation
+    Time step;
+    /// Label written in the first column
+    std::string label;
+    /// CSV file name, standard output if empty
+    std::string output;
+
+    // state of the running benchmark
+    /// Operations with their keys
+    std::vector<std::pair<Operation, uint32_t>> m_ops;
+    /// Wall time spent in operations
+    std::chrono::nanoseconds m_wall;
+    /// Heap allocations made by operations
+    uint64_t m_allocations;
+};
+
+int
+main(int argc, char** argv)
+{
+    RaodvBench bench;
+    if (!bench.Configure(argc, argv))
+    {
+        NS_FATAL_ERROR("Configuration failed. Aborted.");
+    }
+
+    bench.Run();
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+RaodvBench::RaodvBench()
+    : sizes("10,100,1000,10000,100000"),
+      structures("all"),
+      ops(10000),
+      batch(100),
+      step(MicroSeconds(100)),
+      label("raodv"),
+      output(""),
+      m_wall(0),
+      m_allocations(0)
+{
+}
+
+bool
+RaodvBench::Configure(int argc, char** argv)
+{
+    CommandLine cmd(__FILE__);
+
+    cmd.AddValue("sizes", "Comma separated numbers of entries.", sizes);
+    cmd.AddValue("structures",
+                 "Comma separated routing-table, request-queue, neighbors, id-cache, or all.",
+                 structures);
+    cmd.AddValue("ops", "Operations per benchmark.", ops);
+    cmd.AddValue("batch", "Operations between clock advances.", batch);
+    cmd.AddValue("step", "Simulated time per operation.", step);
+    cmd.AddValue("label", "Label of the run, e.g. the commit.", label);
+    cmd.AddValue("output", "CSV file name, standard output if empty.", output);
+
+    cmd.Parse(argc, argv);
+    return ops > 0 && batch > 0 && step.IsStrictlyPositive();
+}
+
+void
+RaodvBench::Run()
+{
+    std::vector<uint32_t> sizeList;
+    std::istringstream is(sizes);
+    for (std::string size; std::getline(is, size, ',');)
+    {
+        sizeList.push_back(std::stoul(size));
+    }
+    RoutingTableBench routingTable;
+    RequestQueueBench requestQueue;
+    NeighborsBench neighbors;
+    IdCacheBench idCache;
+    StructureBench* benches[] = {&routingTable, &requestQueue, &neighbors, &idCache};
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+    os << "label,structure,mix,size,ops,ns_per_op,allocs_per_op,peak_bytes\n";
+    for (StructureBench* bench : benches)
+    {
+        if (structures != "all" &&
+            ("," + structures + ",").find("," + bench->GetName() + ",") == std::string::npos)
+        {
+            continue;
+        }
+        for (const Mix& mix : MIXES)
+        {
+            for (uint32_t size : sizeList)
+            {
+                BenchResult result = RunBench(*bench, mix, size);
+                os << label << "," << bench->GetName() << "," << mix.name << "," << size << ","
+                   << ops << "," << result.nsPerOp << "," << result.allocsPerOp << ","
+                   << result.peakBytes << std::endl;
+            }
+        }
+    }
+}
+
+BenchResult
+RaodvBench::RunBench(StructureBench& bench, const Mix& mix, uint32_t size)
+{
+    uint32_t share[OPERATIONS];
+    std::copy(std::begin(mix.share), std::end(mix.share), std::begin(share));
+    Time lifetime = Seconds(1e6);
+    if (!bench.CanRemove())
+    {
+        // Entries expire instead, at the rate new ones come in
+        share[OP_INSERT] += share[OP_REMOVE];
+        share[OP_REMOVE] = 0;
+        if (share[OP_INSERT] > 0)
+        {
+            lifetime = step * size * 100 / share[OP_INSERT];
+        }
+    }
+
+    // Draw the operations up front, keys are taken from the window of live entries
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+    random->SetStream(1);
+    m_ops.clear();
+    m_ops.reserve(ops);
+    uint32_t lo = 0;
+    uint32_t hi = size;
+    for (uint32_t i = 0; i < ops; ++i)
+    {
+        uint32_t r = random->GetInteger(0, 99);
+        uint32_t op = 0;
+        while (r >= share[op])
+        {
+            r -= share[op++];
+        }
+        if (!bench.CanRemove())
+        {
+            lo = hi > size ? hi - size : 0;
+        }
+        if (op == OP_REMOVE && lo == hi)
+        {
+            op = OP_INSERT;
+        }
+        uint32_t key = 0;
+        switch (op)
+        {
+        case OP_LOOKUP:
+        case OP_UPDATE: {
+            uint32_t live = hi - lo;
+            uint32_t window = mix.recent ? std::min<uint32_t>(live, 8) : live;
+            key = window > 0 ? hi - 1 - random->GetInteger(0, window - 1) : hi;
+            break;
+        }
+        case OP_INSERT:
+            key = hi++;
+            break;
+        case OP_REMOVE:
+            key = lo++;
+            break;
+        }
+        m_ops.emplace_back(static_cast<Operation>(op), key);
+    }
+
+    bench.Create(size, lifetime, size + ops);
+    uint64_t baseline = g_liveBytes;
+    g_peakBytes = g_liveBytes;
+    for (uint32_t key = 0; key < size; ++key)
+    {
+        bench.Run(OP_INSERT, key);
+    }
+    m_wall = std::chrono::nanoseconds(0);
+    m_allocations = 0;
+    Simulator::ScheduleNow(&RaodvBench::RunBatch, this, &bench, size_t(0));
+    Simulator::Run();
+    BenchResult result;
+    result.nsPerOp = double(m_wall.count()) / ops;
+    result.allocsPerOp = double(m_allocations) / ops;
+    result.peakBytes = g_peakBytes - baseline;
+    bench.Destroy();
+    Simulator::Destroy();
+    return result;
+}
+
+void
+RaodvBench::RunBatch(StructureBench* bench, size_t first)
+{
+    size_t last = std::min(first + batch, m_ops.size());
+    uint64_t allocations = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = first; i < last; ++i)
+    {
+        bench->Run(m_ops[i].first, m_ops[i].second);
+    }
+    m_wall += std::chrono::steady_clock::now() - start;
+    m_allocations += g_allocations - allocations;
+    if (last < m_ops.size())
+    {
+        Simulator::Schedule(step * (last - first), &RaodvBench::RunBatch, this, bench, last);
+    }
+}
@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Replays operation traces of the raodv data structures.
+ */
+
+#include "ns3/raodv-id-cache.h"
+#include "ns3/raodv-neighbor.h"
+#include "ns3/raodv-op-recorder.h"
+#include "ns3/raodv-rqueue.h"
+#include "ns3/raodv-rtable.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ns3;
+using namespace ns3::raodv;
+
+/**
+ * \ingroup raodv-examples
+ * \ingroup examples
+ * \brief Replays operation traces of the raodv data structures.
+ *
+ * A trace is recorded from a simulation with OperationRecorder, e.g. with the --recordOps
+ * option of manet-routing-compare. The replay applies the operations of every node to a backend
+ * at their recorded times, without nodes, devices or packets on the air, and writes the wall
+ * time per operation as CSV:
+ *
+ * \code
+ * ./ns3 run "raodv-replay --trace=ops.bin --label=$(git rev-parse --short HEAD)"
+ * \endcode
+ *
+ * A different implementation of the data structures is compared by adding a ReplayBackend
+ * and selecting it with --backend.
+ */
+
+/**
+ * \ingroup raodv-examples
+ * \brief Data structure implementation the operations are replayed on.
+ */
+class ReplayBackend
+{
+  public:
+    virtual ~ReplayBackend() = default;
+
+    /**
+     * Called once before the replay, outside the measurements
+     * \param records all records of the trace
+     */
+    virtual void Prepare(const std::vector<OperationRecord>& /* records */)
+    {
+    }
+
+    /**
+     * Apply one operation at the current simulated time
+     * \param record the operation
+     */
+    virtual void Apply(const OperationRecord& record) = 0;
+};
+
+/**
+ * \ingroup raodv-examples
+ * \brief Backend running the raodv data structures of this tree.
+ *
+ * The structures are created with the default attribute values of RoutingProtocol.
+ */
+class RaodvBackend : public ReplayBackend
+{
+  public:
+    void Prepare(const std::vector<OperationRecord>& records) override
+    {
+        // Enqueued packets are created up front, one per packet UID of the trace
+        std::unordered_map<uint32_t, Ptr<Packet>> packets;
+        for (const OperationRecord& record : records)
+        {
+            if (record.op == OP_RQ_ENQUEUE)
+            {
+                Ptr<Packet>& packet = packets[record.arg];
+                if (!packet)
+                {
+                    packet = Create<Packet>(64);
+                }
+                m_packets.push_back(packet);
+            }
+        }
+        m_nextPacket = 0;
+    }
+
+    void Apply(const OperationRecord& record) override
+    {
+        std::unique_ptr<NodeState>& node = m_nodes[record.instance];
+        if (!node)
+        {
+            node = std::make_unique<NodeState>();
+        }
+        RoutingTableEntry rt;
+        QueueEntry queueEntry;
+        switch (record.op)
+        {
+        case OP_RT_LOOKUP:
+            node->table.LookupRoute(record.key, rt);
+            break;
+        case OP_RT_ADD:
+            rt = CreateRoute(record);
+            node->table.AddRoute(rt);
+            break;
+        case OP_RT_UPDATE:
+            rt = CreateRoute(record);
+            node->table.Update(rt);
+            break;
+        case OP_RT_DELETE:
+            node->table.DeleteRoute(record.key);
+            break;
+        case OP_RT_SET_STATE:
+            node->table.SetEntryState(record.key, static_cast<RouteFlags>(record.arg));
+            break;
+        case OP_RT_NEXT_HOP_SCAN:
+            node->table.GetListOfDestinationWithNextHop(record.key, node->unreachable);
+            break;
+        case OP_RT_INVALIDATE:
+            node->invalidate.insert(std::make_pair(record.key, 0));
+            if (record.arg <= 1)
+            {
+                node->table.InvalidateRoutesWithDst(node->invalidate);
+                node->invalidate.clear();
+            }
+            break;
+        case OP_RT_DELETE_BACKUPS:
+            node->table.DeleteBackupsWithNextHop(record.key);
+            break;
+        case OP_RT_MARK_UNIDIRECTIONAL:
+            node->table.MarkLinkAsUnidirectional(record.key, MilliSeconds(record.arg));
+            break;
+        case OP_RQ_ENQUEUE: {
+            Ipv4Header header;
+            header.SetDestination(record.key);
+            QueueEntry entry(m_packets[m_nextPacket++], header);
+            node->queue.Enqueue(entry);
+            break;
+        }
+        case OP_RQ_DEQUEUE:
+            node->queue.Dequeue(record.key, queueEntry);
+            break;
+        case OP_RQ_FIND:
+            node->queue.Find(record.key);
+            break;
+        case OP_RQ_DROP:
+            node->queue.DropPacketWithDst(record.key);
+            break;
+        case OP_ID_IS_DUPLICATE:
+            node->ids.IsDuplicate(record.key, record.arg);
+            break;
+        case OP_NB_IS_NEIGHBOR:
+            node->nb.IsNeighbor(record.key);
+            break;
+        case OP_NB_UPDATE:
+            node->nb.Update(record.key, MilliSeconds(record.arg));
+            break;
+        case OP_NB_GET_EXPIRE:
+            node->nb.GetExpireTime(record.key);
+            break;
+        default:
+            break;
+        }
+    }
+
+  private:
+    /// Data structures of one node, with the default RoutingProtocol attributes
+    struct NodeState
+    {
+        RoutingTable table{Seconds(15)};             ///< DeletePeriod
+        RequestQueue queue{64, Seconds(30)};         ///< MaxQueueLen, MaxQueueTime
+        IdCache ids{Seconds(5.6)};                   ///< PathDiscoveryTime
+        Neighbors nb;                                ///< Neighbors
+        std::map<Ipv4Address, uint32_t> unreachable; ///< Result of next hop scans
+        std::map<Ipv4Address, uint32_t> invalidate;  ///< Destinations of an invalidation
+    };
+
+    /**
+     * \param record an add or update record
+     * \returns the route of the record
+     */
+    static RoutingTableEntry CreateRoute(const OperationRecord& record)
+    {
+        RoutingTableEntry rt(nullptr,
+                             record.key,
+                             true,
+                             0,
+                             Ipv4InterfaceAddress(),
+                             1,
+                             record.key,
+                             OperationRecorder::UnpackLifetime(record.arg));
+        rt.SetFlag(static_cast<RouteFlags>(OperationRecorder::UnpackFlag(record.arg)));
+        return rt;
+    }
+
+    std::map<uint32_t, std::unique_ptr<NodeState>> m_nodes; ///< Structures per node
+    std::vector<Ptr<Packet>> m_packets;                     ///< Packet of each enqueue record
+    size_t m_nextPacket{0};                                 ///< Next enqueue record
+};
+
+/**
+ * \ingroup raodv-examples
+ * \brief Reads a trace, replays it on a backend and writes the results.
+ */
+class RaodvReplay
+{
+  public:
+    RaodvReplay();
+    /**
+     * \brief Configure script parameters
+     * \param argc is the command line argument count
+     * \param argv is the command line arguments
+     * \return true on successful configuration
+     */
+    bool Configure(int argc, char** argv);
+    /**
+     * Replay the trace
+     * \return false if the trace cannot be read
+     */
+    bool Run();
+
+  private:
+    /**
+     * Apply the records of the current simulated time and schedule the next ones
+     * \param first the first record of the batch
+     */
+    void RunBatch(size_t first);
+
+    // parameters
+    /// Trace file
+    std::string trace;
+    /// Backend name
+    std::string backend;
+    /// Label written in the first column
+    std::string label;
+    /// CSV file name, standard output if empty
+    std::string output;
+
+    // state of the replay
+    /// Records of the trace
+    std::vector<OperationRecord> m_records;
+    /// Backend under measurement
+    std::unique_ptr<ReplayBackend> m_backend;
+    /// Wall time per operation
+    std::chrono::nanoseconds m_wall[RECORDED_OPERATIONS];
+    /// Number of records per operation
+    uint64_t m_count[RECORDED_OPERATIONS];
+    /// Wall time of all batches, clock reads between operations included
+    std::chrono::nanoseconds m_total;
+};
+
+int
+main(int argc, char** argv)
+{
+    RaodvReplay replay;
+    if (!replay.Configure(argc, argv) || !replay.Run())
+    {
+        NS_FATAL_ERROR("Replay failed. Aborted.");
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+RaodvReplay::RaodvReplay()
+    : trace(""),
+      backend("raodv"),
+      label("raodv"),
+      output(""),
+      m_wall{},
+      m_count{},
+      m_total(0)
+{
+}
+
+bool
+RaodvReplay::Configure(int argc, char** argv)
+{
+    CommandLine cmd(__FILE__);
+
+    cmd.AddValue("trace", "Operation trace written by OperationRecorder.", trace);
+    cmd.AddValue("backend", "Data structure implementation: raodv.", backend);
+    cmd.AddValue("label", "Label of the run, e.g. the commit.", label);
+    cmd.AddValue("output", "CSV file name, standard output if empty.", output);
+
+    cmd.Parse(argc, argv);
+    if (backend == "raodv")
+    {
+        m_backend = std::make_unique<RaodvBackend>();
+    }
+    return !trace.empty() && m_backend;
+}
+
+bool
+RaodvReplay::Run()
+{
+    OperationTraceReader reader;
+    if (!reader.Open(trace))
+    {
+        return false;
+    }
+    OperationRecord record;
+    while (reader.Read(record))
+    {
+        m_records.push_back(record);
+    }
+    std::cerr << "Replaying " << m_records.size() << " operations on " << backend << "\n";
+    if (m_records.empty())
+    {
+        return true;
+    }
+
+    m_backend->Prepare(m_records);
+    Simulator::Schedule(m_records.front().time, &RaodvReplay::RunBatch, this, size_t(0));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+    os << "label,backend,operation,count,ns_per_op\n";
+    for (uint32_t op = 0; op < RECORDED_OPERATIONS; ++op)
+    {
+        if (m_count[op] > 0)
+        {
+            os << label << "," << backend << "," << static_cast<RecordedOperation>(op) << ","
+               << m_count[op] << "," << double(m_wall[op].count()) / m_count[op] << "\n";
+        }
+    }
+    os << label << "," << backend << ",all," << m_records.size() << ","
+       << double(m_total.count()) / m_records.size() << "\n";
+    return true;
+}
+
+void
+RaodvReplay::RunBatch(size_t first)
+{
+    size_t last = first;
+    auto batchStart = std::chrono::steady_clock::now();
+    for (; last < m_records.size() && m_records[last].time == m_records[first].time; ++last)
+    {
+        const OperationRecord& record = m_records[last];
+        auto start = std::chrono::steady_clock::now();
+        m_backend->Apply(record);
+        if (record.op < RECORDED_OPERATIONS)
+        {
+            m_wall[record.op] += std::chrono::steady_clock::now() - start;
+            m_count[record.op]++;
+        }
+    }
+    m_total += std::chrono::steady_clock::now() - batchStart;
+    if (last < m_records.size())
+    {
+        Simulator::Schedule(m_records[last].time - Simulator::Now(),
+                            &RaodvReplay::RunBatch,
+                            this,
+                            last);
+    }
+}
@@ -8,11 +8,13 @@
  */
 #include "raodv-helper.h"
 
+#include "ns3/raodv-profiler.h"
 #include "ns3/raodv-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/names.h"
 #include "ns3/node-list.h"
 #include "ns3/ptr.h"
+#include "ns3/simulator.h"
 
 namespace ns3
 {
@@ -83,4 +85,75 @@ RaodvHelper::AssignStreams(NodeContainer c, int64_t stream)
     return (currentStream - stream);
 }
 
+raodv::RoutingStats
+RaodvHelper::GetStats(NodeContainer c)
+{
+    raodv::RoutingStats stats;
+    for (auto i = c.Begin(); i != c.End(); ++i)
+    {
+        Ptr<raodv::RoutingProtocol> raodv = (*i)->GetObject<raodv::RoutingProtocol>();
+        if (raodv)
+        {
+            stats += raodv->GetStats();
+        }
+    }
+    return stats;
+}
+
+raodv::MemoryFootprint
+RaodvHelper::GetMemoryFootprint(NodeContainer c)
+{
+    raodv::MemoryFootprint footprint;
+    for (auto i = c.Begin(); i != c.End(); ++i)
+    {
+        Ptr<raodv::RoutingProtocol> raodv = (*i)->GetObject<raodv::RoutingProtocol>();
+        if (raodv)
+        {
+            footprint += raodv->GetMemoryFootprint();
+        }
+    }
+    return footprint;
+}
+
+void
+RaodvHelper::PrintMemoryFootprintAllEvery(Time printInterval, Ptr<OutputStreamWrapper> stream)
+{
+    *stream->GetStream()
+        << "time,node,routing_table,request_queue,id_caches,dpd,neighbors,request_timers,total\n";
+    Simulator::Schedule(printInterval,
+                        &RaodvHelper::PrintMemoryFootprintEvery,
+                        printInterval,
+                        stream);
+}
+
+void
+RaodvHelper::PrintProfile(Ptr<OutputStreamWrapper> stream)
+{
+    raodv::Profiler::Print(*stream->GetStream());
+}
+
+void
+RaodvHelper::PrintMemoryFootprintEvery(Time printInterval, Ptr<OutputStreamWrapper> stream)
+{
+    std::ostream* os = stream->GetStream();
+    for (uint32_t i = 0; i < NodeList::GetNNodes(); i++)
+    {
+        Ptr<Node> node = NodeList::GetNode(i);
+        Ptr<raodv::RoutingProtocol> raodv = node->GetObject<raodv::RoutingProtocol>();
+        if (!raodv)
+        {
+            continue;
+        }
+        raodv::MemoryFootprint footprint = raodv->GetMemoryFootprint();
+        *os << Simulator::Now().GetSeconds() << "," << node->GetId() << ","
+            << footprint.routingTable << "," << footprint.requestQueue << ","
+            << footprint.idCaches << "," << footprint.dpd << "," << footprint.neighbors << ","
+            << footprint.requestTimers << "," << footprint.GetTotal() << "\n";
+    }
+    Simulator::Schedule(printInterval,
+                        &RaodvHelper::PrintMemoryFootprintEvery,
+                        printInterval,
+                        stream);
+}
+
 } // namespace ns3
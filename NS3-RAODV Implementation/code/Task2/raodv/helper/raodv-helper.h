@@ -14,6 +14,7 @@
 #include "ns3/node-container.h"
 #include "ns3/node.h"
 #include "ns3/object-factory.h"
+#include "ns3/raodv-stats.h"
 
 namespace ns3
 {
@@ -64,7 +65,53 @@ class RaodvHelper : public Ipv4RoutingHelper
      */
     int64_t AssignStreams(NodeContainer c, int64_t stream);
 
+    /**
+     * Sum the control plane counters of the raodv instances installed on a set of nodes.
+     *
+     * \param c NodeContainer of the nodes to collect the counters of
+     * \return the summed counters
+     */
+    static raodv::RoutingStats GetStats(NodeContainer c);
+
+    /**
+     * Sum the estimated memory footprints of the raodv instances installed on a set of nodes.
+     *
+     * \param c NodeContainer of the nodes to collect the footprints of
+     * \return the summed footprint
+     */
+    static raodv::MemoryFootprint GetMemoryFootprint(NodeContainer c);
+
+    /**
+     * Write the estimated memory footprint of every raodv instance at regular intervals.
+     *
+     * The stream receives a CSV header, then one row per node and sample: time in seconds,
+     * node ID, the bytes of each MemoryFootprint component and their total.
+     *
+     * \param printInterval the time between two samples
+     * \param stream the output stream
+     */
+    static void PrintMemoryFootprintAllEvery(Time printInterval, Ptr<OutputStreamWrapper> stream);
+
+    /**
+     * Print the time spent in the raodv handlers so far, the most expensive first.
+     *
+     * The handlers are only timed when the module is built with RAODV_PROFILE, see
+     * raodv::Profiler; otherwise the report is empty.
+     *
+     * \param stream the output stream
+     */
+    static void PrintProfile(Ptr<OutputStreamWrapper> stream);
+
   private:
+    /**
+     * Write one sample of all nodes and schedule the next one.
+     *
+     * \param printInterval the time between two samples
+     * \param stream the output stream
+     */
+    static void PrintMemoryFootprintEvery(Time printInterval, Ptr<OutputStreamWrapper> stream);
+
+
     /** the factory to create raodv routing object */
     ObjectFactory m_agentFactory;
 };
@@ -33,5 +33,11 @@ DuplicatePacketDetection::GetLifetime() const
     return m_idCache.GetLifeTime();
 }
 
+uint64_t
+DuplicatePacketDetection::GetMemoryUsage() const
+{
+    return m_idCache.GetMemoryUsage();
+}
+
 } // namespace raodv
 } // namespace ns3
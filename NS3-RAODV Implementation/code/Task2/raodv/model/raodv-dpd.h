@@ -59,6 +59,11 @@ class DuplicatePacketDetection
      * \returns the duplicate record lifetime
      */
     Time GetLifetime() const;
+    /**
+     * Estimate the memory held by the duplicate records
+     * \returns the estimate in bytes
+     */
+    uint64_t GetMemoryUsage() const;
 
   private:
     /// Impl
@@ -24,6 +24,10 @@ namespace raodv
 bool
 IdCache::IsDuplicate(Ipv4Address addr, uint32_t id)
 {
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_ID_IS_DUPLICATE, addr, id);
+    }
     Purge();
     for (auto i = m_idCache.begin(); i != m_idCache.end(); ++i)
     {
@@ -50,5 +54,11 @@ IdCache::GetSize()
     return m_idCache.size();
 }
 
+uint64_t
+IdCache::GetMemoryUsage() const
+{
+    return m_idCache.capacity() * sizeof(UniqueId);
+}
+
 } // namespace raodv
 } // namespace ns3
@@ -17,6 +17,8 @@
 #ifndef RAODV_ID_CACHE_H
 #define RAODV_ID_CACHE_H
 
+#include "raodv-op-recorder.h"
+
 #include "ns3/ipv4-address.h"
 #include "ns3/simulator.h"
 
@@ -39,7 +41,9 @@ class IdCache
      * \param lifetime the lifetime for added entries
      */
     IdCache(Time lifetime)
-        : m_lifetime(lifetime)
+        : m_lifetime(lifetime),
+          m_record(false),
+          m_recordInstance(0)
     {
     }
 
@@ -56,6 +60,11 @@ class IdCache
      * \returns number of entries in cache
      */
     uint32_t GetSize();
+    /**
+     * Estimate the memory held by the cache
+     * \returns the estimate in bytes
+     */
+    uint64_t GetMemoryUsage() const;
 
     /**
      * Set lifetime for future added entries.
@@ -75,6 +84,16 @@ class IdCache
         return m_lifetime;
     }
 
+    /**
+     * Record every operation with OperationRecorder
+     * \param instance the node owning the cache
+     */
+    void EnableRecording(uint32_t instance)
+    {
+        m_record = true;
+        m_recordInstance = instance;
+    }
+
   private:
     /// Unique packet ID
     struct UniqueId
@@ -108,6 +127,10 @@ class IdCache
     std::vector<UniqueId> m_idCache;
     /// Default lifetime for ID records
     Time m_lifetime;
+    /// Record operations with OperationRecorder
+    bool m_record;
+    /// Node written in the records
+    uint32_t m_recordInstance;
 };
 
 } // namespace raodv
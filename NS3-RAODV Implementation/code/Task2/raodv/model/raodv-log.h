@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+/*
+ * Compile-time log level of the raodv module.
+ *
+ * Included by the raodv sources instead of "ns3/log.h", after all other headers. When
+ * RAODV_LOG_MAX_LEVEL is defined, e.g. by the NS3_RAODV_LOG_LEVEL CMake option, the log macros
+ * more verbose than that level are replaced by statements that are never executed: their
+ * arguments are not evaluated and no LogComponent check is left, but they still compile, so
+ * variables only used in log messages do not become unused. Without RAODV_LOG_MAX_LEVEL the
+ * macros of ns3/log.h are unchanged.
+ *
+ * The header is private to the module. Including it last keeps the inline functions of other
+ * headers identical in every translation unit.
+ */
+
+#ifndef RAODV_LOG_H
+#define RAODV_LOG_H
+
+#include "ns3/log.h"
+
+/// Levels of RAODV_LOG_MAX_LEVEL, in the order of ns3::LogLevel
+/// \{
+#define RAODV_LOG_LEVEL_NONE 0
+#define RAODV_LOG_LEVEL_ERROR 1
+#define RAODV_LOG_LEVEL_WARN 2
+#define RAODV_LOG_LEVEL_DEBUG 3
+#define RAODV_LOG_LEVEL_INFO 4
+#define RAODV_LOG_LEVEL_FUNCTION 5
+#define RAODV_LOG_LEVEL_LOGIC 6
+/// \}
+
+#ifdef RAODV_LOG_MAX_LEVEL
+
+/// \cond
+#define RAODV_LOG_NOOP(msg)                                                                        \
+    do                                                                                             \
+    {                                                                                              \
+        if (false)                                                                                 \
+        {                                                                                          \
+            std::clog << msg;                                                                      \
+        }                                                                                          \
+    } while (false)
+/// \endcond
+
+#if RAODV_LOG_MAX_LEVEL < RAODV_LOG_LEVEL_LOGIC
+#undef NS_LOG_LOGIC
+#define NS_LOG_LOGIC(msg) RAODV_LOG_NOOP(msg)
+#endif
+
+#if RAODV_LOG_MAX_LEVEL < RAODV_LOG_LEVEL_FUNCTION
+#undef NS_LOG_FUNCTION
+#define NS_LOG_FUNCTION(parameters) RAODV_LOG_NOOP(parameters)
+#undef NS_LOG_FUNCTION_NOARGS
+#define NS_LOG_FUNCTION_NOARGS()                                                                   \
+    do                                                                                             \
+    {                                                                                              \
+    } while (false)
+#endif
+
+#if RAODV_LOG_MAX_LEVEL < RAODV_LOG_LEVEL_INFO
+#undef NS_LOG_INFO
+#define NS_LOG_INFO(msg) RAODV_LOG_NOOP(msg)
+#endif
+
+#if RAODV_LOG_MAX_LEVEL < RAODV_LOG_LEVEL_DEBUG
+#undef NS_LOG_DEBUG
+#define NS_LOG_DEBUG(msg) RAODV_LOG_NOOP(msg)
+#endif
+
+#if RAODV_LOG_MAX_LEVEL < RAODV_LOG_LEVEL_WARN
+#undef NS_LOG_WARN
+#define NS_LOG_WARN(msg) RAODV_LOG_NOOP(msg)
+#endif
+
+#if RAODV_LOG_MAX_LEVEL < RAODV_LOG_LEVEL_ERROR
+#undef NS_LOG_ERROR
+#define NS_LOG_ERROR(msg) RAODV_LOG_NOOP(msg)
+#endif
+
+#endif /* RAODV_LOG_MAX_LEVEL */
+
+#endif /* RAODV_LOG_H */
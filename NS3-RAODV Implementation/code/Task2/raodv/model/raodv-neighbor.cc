@@ -16,11 +16,13 @@
 
 #include "raodv-neighbor.h"
 
-#include "ns3/log.h"
 #include "ns3/wifi-mac-header.h"
 
 #include <algorithm>
 
+// Last, so that only the log statements of this file are affected
+#include "raodv-log.h"
+
 namespace ns3
 {
 
@@ -28,17 +30,22 @@ NS_LOG_COMPONENT_DEFINE("RaodvNeighbors");
 
 namespace raodv
 {
-Neighbors::Neighbors(Time delay)
-    : m_ntimer(Timer::CANCEL_ON_DESTROY)
+Neighbors::Neighbors()
+    : m_breakRssi(0),
+      m_breakHorizon(Seconds(0)),
+      m_record(false),
+      m_recordInstance(0)
 {
-    m_ntimer.SetDelay(delay);
-    m_ntimer.SetFunction(&Neighbors::Purge, this);
     m_txErrorCallback = MakeCallback(&Neighbors::ProcessTxError, this);
 }
 
 bool
 Neighbors::IsNeighbor(Ipv4Address addr)
 {
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_NB_IS_NEIGHBOR, addr);
+    }
     Purge();
     for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
     {
@@ -53,6 +60,10 @@ Neighbors::IsNeighbor(Ipv4Address addr)
 Time
 Neighbors::GetExpireTime(Ipv4Address addr)
 {
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_NB_GET_EXPIRE, addr);
+    }
     Purge();
     for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
     {
@@ -67,6 +78,10 @@ Neighbors::GetExpireTime(Ipv4Address addr)
 void
 Neighbors::Update(Ipv4Address addr, Time expire)
 {
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_NB_UPDATE, addr, expire.GetMilliSeconds());
+    }
     for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
     {
         if (i->m_neighborAddress == addr)
@@ -86,6 +101,175 @@ Neighbors::Update(Ipv4Address addr, Time expire)
     Purge();
 }
 
+void
+Neighbors::SetCapabilities(Ipv4Address addr, uint8_t caps)
+{
+    for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
+    {
+        if (i->m_neighborAddress == addr)
+        {
+            i->m_capabilities = caps;
+            return;
+        }
+    }
+}
+
+bool
+Neighbors::AllCapable(uint8_t caps)
+{
+    Purge();
+    if (m_nb.empty())
+    {
+        return false;
+    }
+    for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
+    {
+        if ((i->m_capabilities & caps) != caps)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+Neighbors::IsCapable(Ipv4Address addr, uint8_t caps) const
+{
+    for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
+    {
+        if (i->m_neighborAddress == addr)
+        {
+            return i->m_expireTime >= Simulator::Now() && (i->m_capabilities & caps) == caps;
+        }
+    }
+    return false;
+}
+
+/// Weight of a new sample in the smoothed signal strength
+static const double RSSI_GAIN = 0.3;
+/// Weight of a new slope in the smoothed trend
+static const double RSSI_SLOPE_GAIN = 0.3;
+/// Minimum seconds between two trend updates, shorter intervals only add noise to the slope
+static const double RSSI_TREND_INTERVAL = 0.1;
+
+void
+Neighbors::SetLinkBreakPrediction(double rssi, Time horizon, Callback<void, Ipv4Address> cb)
+{
+    m_breakRssi = rssi;
+    m_breakHorizon = horizon;
+    m_handleLinkBreaking = cb;
+}
+
+void
+Neighbors::UpdateRssi(Mac48Address addr, double rssi)
+{
+    for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
+    {
+        if (i->m_hardwareAddress == addr)
+        {
+            UpdateRssi(*i, rssi);
+            return;
+        }
+    }
+}
+
+void
+Neighbors::UpdateRssi(Ipv4Address addr, double rssi)
+{
+    for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
+    {
+        if (i->m_neighborAddress == addr)
+        {
+            UpdateRssi(*i, rssi);
+            return;
+        }
+    }
+}
+
+void
+Neighbors::UpdateRssi(Neighbor& nb, double rssi)
+{
+    if (m_breakHorizon.IsZero())
+    {
+        return;
+    }
+    if (!nb.m_rssiValid)
+    {
+        nb.m_rssiValid = true;
+        nb.m_rssi = rssi;
+        nb.m_trendRssi = rssi;
+        nb.m_trendTime = Simulator::Now();
+        return;
+    }
+    nb.m_rssi += RSSI_GAIN * (rssi - nb.m_rssi);
+    double elapsed = (Simulator::Now() - nb.m_trendTime).GetSeconds();
+    if (elapsed < RSSI_TREND_INTERVAL)
+    {
+        return;
+    }
+    double slope = (nb.m_rssi - nb.m_trendRssi) / elapsed;
+    nb.m_rssiSlope += RSSI_SLOPE_GAIN * (slope - nb.m_rssiSlope);
+    nb.m_trendRssi = nb.m_rssi;
+    nb.m_trendTime = Simulator::Now();
+
+    // Hysteresis keeps a link hovering around the horizon from triggering again and again
+    Time timeToBreak = PredictBreak(nb);
+    if (!nb.m_linkBreaking && timeToBreak < m_breakHorizon)
+    {
+        NS_LOG_LOGIC("Link to " << nb.m_neighborAddress << " predicted to break in "
+                                << timeToBreak.As(Time::S));
+        nb.m_linkBreaking = true;
+        if (!m_handleLinkBreaking.IsNull())
+        {
+            m_handleLinkBreaking(nb.m_neighborAddress);
+        }
+    }
+    else if (nb.m_linkBreaking && timeToBreak > 2 * m_breakHorizon)
+    {
+        nb.m_linkBreaking = false;
+    }
+}
+
+Time
+Neighbors::PredictBreak(const Neighbor& nb) const
+{
+    if (nb.m_rssi <= m_breakRssi)
+    {
+        return Seconds(0);
+    }
+    if (nb.m_rssiSlope >= 0)
+    {
+        return Simulator::GetMaximumSimulationTime();
+    }
+    return Seconds((m_breakRssi - nb.m_rssi) / nb.m_rssiSlope);
+}
+
+bool
+Neighbors::IsLinkBreaking(Ipv4Address addr) const
+{
+    for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
+    {
+        if (i->m_neighborAddress == addr)
+        {
+            return i->m_linkBreaking;
+        }
+    }
+    return false;
+}
+
+Time
+Neighbors::GetTimeToBreak(Ipv4Address addr) const
+{
+    for (auto i = m_nb.begin(); i != m_nb.end(); ++i)
+    {
+        if (i->m_neighborAddress == addr && i->m_rssiValid)
+        {
+            return PredictBreak(*i);
+        }
+    }
+    return Simulator::GetMaximumSimulationTime();
+}
+
 /**
  * \brief CloseNeighbor structure
  */
@@ -124,15 +308,12 @@ Neighbors::Purge()
         }
     }
     m_nb.erase(std::remove_if(m_nb.begin(), m_nb.end(), pred), m_nb.end());
-    m_ntimer.Cancel();
-    m_ntimer.Schedule();
 }
 
-void
-Neighbors::ScheduleTimer()
+uint64_t
+Neighbors::GetMemoryUsage() const
 {
-    m_ntimer.Cancel();
-    m_ntimer.Schedule();
+    return m_nb.capacity() * sizeof(Neighbor) + m_arp.capacity() * sizeof(Ptr<ArpCache>);
 }
 
 void
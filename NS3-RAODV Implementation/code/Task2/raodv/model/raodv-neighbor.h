@@ -17,11 +17,12 @@
 #ifndef RAODVNEIGHBOR_H
 #define RAODVNEIGHBOR_H
 
+#include "raodv-op-recorder.h"
+
 #include "ns3/arp-cache.h"
 #include "ns3/callback.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/simulator.h"
-#include "ns3/timer.h"
 
 #include <vector>
 
@@ -42,11 +43,16 @@ class RoutingProtocol;
 class Neighbors
 {
   public:
-    /**
-     * constructor
-     * \param delay the delay time for purging the list of neighbors
-     */
-    Neighbors(Time delay);
+    /// constructor
+    Neighbors();
+
+    /// Optional protocol features a neighbor advertises in its hello
+    enum Capability : uint8_t
+    {
+        COMPACT_RREQ = (1 << 0),  ///< Accepts CompactRreqHeader messages
+        COALESCING = (1 << 1),    ///< Accepts aggregated control datagrams
+        ROUTE_REFRESH = (1 << 2), ///< Accepts and forwards refresh RREQs
+    };
 
     /// Neighbor description
     struct Neighbor
@@ -59,6 +65,20 @@ class Neighbors
         Time m_expireTime;
         /// Neighbor close indicator
         bool close;
+        /// Capability bits advertised in the neighbor's last hello
+        uint8_t m_capabilities;
+        /// Whether m_rssi holds a sample
+        bool m_rssiValid;
+        /// Smoothed received signal strength in dBm
+        double m_rssi;
+        /// Smoothed received signal strength trend in dB/s
+        double m_rssiSlope;
+        /// m_rssi at the last trend update
+        double m_trendRssi;
+        /// Time of the last trend update
+        Time m_trendTime;
+        /// Whether the link is predicted to break soon
+        bool m_linkBreaking;
 
         /**
          * \brief Neighbor structure constructor
@@ -71,7 +91,13 @@ class Neighbors
             : m_neighborAddress(ip),
               m_hardwareAddress(mac),
               m_expireTime(t),
-              close(false)
+              close(false),
+              m_capabilities(0),
+              m_rssiValid(false),
+              m_rssi(0),
+              m_rssiSlope(0),
+              m_trendRssi(0),
+              m_linkBreaking(false)
         {
         }
     };
@@ -94,10 +120,64 @@ class Neighbors
      * \param expire the expire time for the address
      */
     void Update(Ipv4Address addr, Time expire);
+    /**
+     * Record the capabilities advertised by neighbor addr
+     * \param addr the IP address of the neighbor node
+     * \param caps bitwise OR of Capability values
+     */
+    void SetCapabilities(Ipv4Address addr, uint8_t caps);
+    /**
+     * Check that every current neighbor advertised all capabilities in caps
+     * \param caps bitwise OR of Capability values
+     * \returns true if the list is not empty and all neighbors are capable
+     */
+    bool AllCapable(uint8_t caps);
+    /**
+     * Check that neighbor addr advertised all capabilities in caps
+     * \param addr the IP address of the neighbor node
+     * \param caps bitwise OR of Capability values
+     * \returns true if addr is a neighbor and is capable
+     */
+    bool IsCapable(Ipv4Address addr, uint8_t caps) const;
+    /**
+     * Enable link break prediction from the received signal strength
+     * \param rssi signal strength in dBm below which a link is considered broken
+     * \param horizon a link is predicted to break if its trend reaches rssi within this time
+     * \param cb called once with the neighbor address when its link is predicted to break
+     */
+    void SetLinkBreakPrediction(double rssi, Time horizon, Callback<void, Ipv4Address> cb);
+    /**
+     * Account a frame received from neighbor addr
+     * \param addr the MAC address of the neighbor node
+     * \param rssi signal strength of the frame in dBm
+     */
+    void UpdateRssi(Mac48Address addr, double rssi);
+    /**
+     * Account a frame received from neighbor addr
+     * \param addr the IP address of the neighbor node
+     * \param rssi signal strength of the frame in dBm
+     */
+    void UpdateRssi(Ipv4Address addr, double rssi);
+    /**
+     * Check whether the link to neighbor addr is predicted to break soon
+     * \param addr the IP address of the neighbor node
+     * \returns true if the link is predicted to break
+     */
+    bool IsLinkBreaking(Ipv4Address addr) const;
+    /**
+     * Predict when the link to neighbor addr breaks
+     * \param addr the IP address of the neighbor node
+     * \returns the time until the signal strength trend reaches the break threshold, or the
+     * maximum simulation time if it does not fall
+     */
+    Time GetTimeToBreak(Ipv4Address addr) const;
     /// Remove all expired entries
     void Purge();
-    /// Schedule m_ntimer.
-    void ScheduleTimer();
+    /**
+     * Estimate the memory held by the neighbor list and the list of ARP caches
+     * \returns the estimate in bytes
+     */
+    uint64_t GetMemoryUsage() const;
 
     /// Remove all entries
     void Clear()
@@ -143,17 +223,47 @@ class Neighbors
         return m_handleLinkFailure;
     }
 
+    /**
+     * Record every operation with OperationRecorder
+     * \param instance the node owning the list
+     */
+    void EnableRecording(uint32_t instance)
+    {
+        m_record = true;
+        m_recordInstance = instance;
+    }
+
   private:
     /// link failure callback
     Callback<void, Ipv4Address> m_handleLinkFailure;
     /// TX error callback
     Callback<void, const WifiMacHeader&> m_txErrorCallback;
-    /// Timer for neighbor's list. Schedule Purge().
-    Timer m_ntimer;
+    /// link break predicted callback
+    Callback<void, Ipv4Address> m_handleLinkBreaking;
+    /// Signal strength in dBm below which a link is considered broken
+    double m_breakRssi;
+    /// Prediction horizon of link breaks, zero if prediction is off
+    Time m_breakHorizon;
+    /**
+     * Add a signal strength sample to the trend of a neighbor
+     * \param nb the neighbor
+     * \param rssi signal strength of the frame in dBm
+     */
+    void UpdateRssi(Neighbor& nb, double rssi);
+    /**
+     * Predict when the link to a neighbor breaks
+     * \param nb the neighbor
+     * \returns the time until the trend reaches m_breakRssi
+     */
+    Time PredictBreak(const Neighbor& nb) const;
     /// vector of entries
     std::vector<Neighbor> m_nb;
     /// list of ARP cached to be used for layer 2 notifications processing
     std::vector<Ptr<ArpCache>> m_arp;
+    /// Record operations with OperationRecorder
+    bool m_record;
+    /// Node written in the records
+    uint32_t m_recordInstance;
 
     /**
      * Find MAC address by IP using list of ARP caches
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "raodv-op-recorder.h"
+
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Last, so that only the log statements of this file are affected
+#include "raodv-log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("RaodvOperationRecorder");
+
+namespace raodv
+{
+
+namespace
+{
+
+/// State of the open trace file
+struct RecorderState
+{
+    std::ofstream file; ///< The trace file
+    Time last;          ///< Time of the last record written
+};
+
+/// \returns the recorder state
+RecorderState&
+GetState()
+{
+    static RecorderState state;
+    return state;
+}
+
+/**
+ * Write an unsigned LEB128 varint
+ * \param os output stream
+ * \param value the value
+ */
+void
+WriteVarint(std::ostream& os, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        os.put(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    os.put(static_cast<char>(value));
+}
+
+/**
+ * Read an unsigned LEB128 varint
+ * \param is input stream
+ * \param value the value read
+ * \returns false at the end of the stream
+ */
+bool
+ReadVarint(std::istream& is, uint64_t& value)
+{
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        int c = is.get();
+        if (c == std::char_traits<char>::eof())
+        {
+            return false;
+        }
+        value |= uint64_t(c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+const char OperationRecorder::MAGIC[8] = {'R', 'A', 'O', 'D', 'V', 'O', 'P', '1'};
+
+std::ostream&
+operator<<(std::ostream& os, RecordedOperation op)
+{
+    switch (op)
+    {
+    case OP_RT_LOOKUP:
+        return os << "rt-lookup";
+    case OP_RT_ADD:
+        return os << "rt-add";
+    case OP_RT_UPDATE:
+        return os << "rt-update";
+    case OP_RT_DELETE:
+        return os << "rt-delete";
+    case OP_RT_SET_STATE:
+        return os << "rt-set-state";
+    case OP_RT_NEXT_HOP_SCAN:
+        return os << "rt-next-hop-scan";
+    case OP_RT_INVALIDATE:
+        return os << "rt-invalidate";
+    case OP_RT_DELETE_BACKUPS:
+        return os << "rt-delete-backups";
+    case OP_RT_MARK_UNIDIRECTIONAL:
+        return os << "rt-mark-unidirectional";
+    case OP_RQ_ENQUEUE:
+        return os << "rq-enqueue";
+    case OP_RQ_DEQUEUE:
+        return os << "rq-dequeue";
+    case OP_RQ_FIND:
+        return os << "rq-find";
+    case OP_RQ_DROP:
+        return os << "rq-drop";
+    case OP_ID_IS_DUPLICATE:
+        return os << "id-is-duplicate";
+    case OP_NB_IS_NEIGHBOR:
+        return os << "nb-is-neighbor";
+    case OP_NB_UPDATE:
+        return os << "nb-update";
+    case OP_NB_GET_EXPIRE:
+        return os << "nb-get-expire";
+    default:
+        return os << "unknown";
+    }
+}
+
+bool
+OperationRecorder::Open(const std::string& filename)
+{
+    RecorderState& state = GetState();
+    Close();
+    state.file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!state.file.is_open())
+    {
+        NS_LOG_WARN("Cannot open operation trace " << filename);
+        return false;
+    }
+    state.file.write(MAGIC, sizeof(MAGIC));
+    state.last = Seconds(0);
+    return true;
+}
+
+void
+OperationRecorder::Close()
+{
+    RecorderState& state = GetState();
+    if (state.file.is_open())
+    {
+        state.file.close();
+    }
+}
+
+bool
+OperationRecorder::IsOpen()
+{
+    return GetState().file.is_open();
+}
+
+void
+OperationRecorder::Record(uint32_t instance, RecordedOperation op, Ipv4Address key, uint32_t arg)
+{
+    RecorderState& state = GetState();
+    if (!state.file.is_open())
+    {
+        return;
+    }
+    Time now = Simulator::Now();
+    WriteVarint(state.file, (now - state.last).GetNanoSeconds());
+    state.last = now;
+    WriteVarint(state.file, instance);
+    state.file.put(static_cast<char>(op));
+    uint32_t address = key.Get();
+    char bytes[4] = {static_cast<char>(address >> 24),
+                     static_cast<char>(address >> 16),
+                     static_cast<char>(address >> 8),
+                     static_cast<char>(address)};
+    state.file.write(bytes, sizeof(bytes));
+    WriteVarint(state.file, arg);
+}
+
+uint32_t
+OperationRecorder::PackRoute(Time lifetime, uint8_t flag)
+{
+    int64_t ms = std::clamp<int64_t>(lifetime.GetMilliSeconds(), 0, (1 << 30) - 1);
+    return (static_cast<uint32_t>(ms) << 2) | (flag & 0x3);
+}
+
+Time
+OperationRecorder::UnpackLifetime(uint32_t arg)
+{
+    return MilliSeconds(arg >> 2);
+}
+
+uint8_t
+OperationRecorder::UnpackFlag(uint32_t arg)
+{
+    return arg & 0x3;
+}
+
+OperationTraceReader::OperationTraceReader()
+    : m_last(Seconds(0))
+{
+}
+
+bool
+OperationTraceReader::Open(const std::string& filename)
+{
+    m_file.open(filename, std::ios::binary);
+    char magic[sizeof(OperationRecorder::MAGIC)];
+    if (!m_file.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, OperationRecorder::MAGIC, sizeof(magic)) != 0)
+    {
+        NS_LOG_WARN(filename << " is not an operation trace");
+        return false;
+    }
+    m_last = Seconds(0);
+    return true;
+}
+
+bool
+OperationTraceReader::Read(OperationRecord& record)
+{
+    uint64_t delta;
+    uint64_t instance;
+    uint64_t arg;
+    if (!ReadVarint(m_file, delta) || !ReadVarint(m_file, instance))
+    {
+        return false;
+    }
+    int op = m_file.get();
+    unsigned char bytes[4];
+    if (op == std::char_traits<char>::eof() ||
+        !m_file.read(reinterpret_cast<char*>(bytes), sizeof(bytes)) || !ReadVarint(m_file, arg))
+    {
+        return false;
+    }
+    m_last += NanoSeconds(delta);
+    record.time = m_last;
+    record.instance = instance;
+    record.op = static_cast<RecordedOperation>(op);
+    record.key = Ipv4Address((uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) |
+                             (uint32_t(bytes[2]) << 8) | bytes[3]);
+    record.arg = arg;
+    return true;
+}
+
+} // namespace raodv
+} // namespace ns3
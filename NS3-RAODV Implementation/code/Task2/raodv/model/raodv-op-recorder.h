@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RAODV_OP_RECORDER_H
+#define RAODV_OP_RECORDER_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace ns3
+{
+namespace raodv
+{
+
+/// Operations on the routing data structures that can be recorded
+enum RecordedOperation : uint8_t
+{
+    OP_RT_LOOKUP,              ///< RoutingTable::LookupRoute
+    OP_RT_ADD,                 ///< RoutingTable::AddRoute, argument from PackRoute
+    OP_RT_UPDATE,              ///< RoutingTable::Update, argument from PackRoute
+    OP_RT_DELETE,              ///< RoutingTable::DeleteRoute
+    OP_RT_SET_STATE,           ///< RoutingTable::SetEntryState, argument is the flag
+    OP_RT_NEXT_HOP_SCAN,       ///< RoutingTable::GetListOfDestinationWithNextHop
+    OP_RT_INVALIDATE,          ///< One destination of RoutingTable::InvalidateRoutesWithDst,
+                               ///< argument is the number of destinations left in the call
+    OP_RT_DELETE_BACKUPS,      ///< RoutingTable::DeleteBackupsWithNextHop
+    OP_RT_MARK_UNIDIRECTIONAL, ///< RoutingTable::MarkLinkAsUnidirectional, argument in ms
+    OP_RQ_ENQUEUE,             ///< RequestQueue::Enqueue, argument is the packet UID
+    OP_RQ_DEQUEUE,             ///< RequestQueue::Dequeue
+    OP_RQ_FIND,                ///< RequestQueue::Find
+    OP_RQ_DROP,                ///< RequestQueue::DropPacketWithDst
+    OP_ID_IS_DUPLICATE,        ///< IdCache::IsDuplicate, argument is the ID
+    OP_NB_IS_NEIGHBOR,         ///< Neighbors::IsNeighbor
+    OP_NB_UPDATE,              ///< Neighbors::Update, argument is the lifetime in ms
+    OP_NB_GET_EXPIRE,          ///< Neighbors::GetExpireTime
+    RECORDED_OPERATIONS,       ///< Number of operations
+};
+
+/**
+ * \brief Stream output operator
+ * \param os output stream
+ * \param op the operation
+ * \return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, RecordedOperation op);
+
+/// One recorded operation
+struct OperationRecord
+{
+    Time time;            ///< Simulation time of the operation
+    uint32_t instance;    ///< Node owning the data structure
+    RecordedOperation op; ///< The operation
+    Ipv4Address key;      ///< Destination, neighbor or originator address
+    uint32_t arg;         ///< Operation specific argument
+};
+
+/**
+ * \ingroup raodv
+ *
+ * \brief Records the operations on the routing data structures of all nodes to a file.
+ *
+ * Recording is off unless Open is called before the simulation starts. RoutingProtocol then
+ * enables it on its routing table, request queue, RREQ ID cache and neighbor list, and every
+ * operation on them writes one record. Records are a varint time delta in ns, a varint node,
+ * the operation byte, the key address and a varint argument, usually 8 to 12 bytes.
+ * OperationTraceReader reads them back, e.g. to replay the trace with raodv-replay.
+ */
+class OperationRecorder
+{
+  public:
+    /**
+     * Start recording
+     * \param filename the trace file, truncated
+     * \returns false if the file cannot be opened
+     */
+    static bool Open(const std::string& filename);
+    /// Flush and close the trace file
+    static void Close();
+    /// \returns true while a trace file is open
+    static bool IsOpen();
+    /**
+     * Write a record at the current simulation time
+     * \param instance the node owning the data structure
+     * \param op the operation
+     * \param key the key address
+     * \param arg the operation specific argument
+     */
+    static void Record(uint32_t instance, RecordedOperation op, Ipv4Address key, uint32_t arg = 0);
+
+    /**
+     * Pack the state of a route into a record argument
+     * \param lifetime the remaining lifetime of the route
+     * \param flag the route flag
+     * \returns the lifetime in ms, saturated at 2^30 - 1, shifted left by 2, or-ed with the flag
+     */
+    static uint32_t PackRoute(Time lifetime, uint8_t flag);
+    /**
+     * \param arg a record argument from PackRoute
+     * \returns the lifetime of the route
+     */
+    static Time UnpackLifetime(uint32_t arg);
+    /**
+     * \param arg a record argument from PackRoute
+     * \returns the flag of the route
+     */
+    static uint8_t UnpackFlag(uint32_t arg);
+
+    /// Magic string at the start of a trace file
+    static const char MAGIC[8];
+};
+
+/**
+ * \ingroup raodv
+ *
+ * \brief Reads a trace file written by OperationRecorder.
+ */
+class OperationTraceReader
+{
+  public:
+    OperationTraceReader();
+
+    /**
+     * Open a trace file
+     * \param filename the trace file
+     * \returns false if the file cannot be opened or is not a trace
+     */
+    bool Open(const std::string& filename);
+    /**
+     * Read the next record
+     * \param record the record read
+     * \returns false at the end of the file or on a truncated record
+     */
+    bool Read(OperationRecord& record);
+
+  private:
+    std::ifstream m_file; ///< The trace file
+    Time m_last;          ///< Time of the last record read
+};
+
+} // namespace raodv
+} // namespace ns3
+
+#endif /* RAODV_OP_RECORDER_H */
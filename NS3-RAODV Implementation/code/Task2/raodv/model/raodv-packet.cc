@@ -18,6 +18,9 @@
 #include "ns3/address-utils.h"
 #include "ns3/packet.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3
 {
 namespace raodv
@@ -71,7 +74,11 @@ TypeHeader::Deserialize(Buffer::Iterator start)
     case RAODVTYPE_RREP:
     case RAODVTYPE_RERR:
     case RAODVTYPE_RREP_ACK:
-    case RAODVTYPE_REVREQUEST: {
+    case RAODVTYPE_REVREQUEST:
+    case RAODVTYPE_RREQ_COMPACT:
+    case RAODVTYPE_REVREQUEST_COMPACT:
+    case RAODVTYPE_AGGREGATE:
+    case RAODVTYPE_RREQ_REFRESH: {
         m_type = (MessageType)type;
         break;
     }
@@ -108,6 +115,22 @@ TypeHeader::Print(std::ostream& os) const
         os << "REVREQ";
         break;
     }
+    case RAODVTYPE_RREQ_COMPACT: {
+        os << "RREQ_COMPACT";
+        break;
+    }
+    case RAODVTYPE_REVREQUEST_COMPACT: {
+        os << "REVREQ_COMPACT";
+        break;
+    }
+    case RAODVTYPE_AGGREGATE: {
+        os << "AGGREGATE";
+        break;
+    }
+    case RAODVTYPE_RREQ_REFRESH: {
+        os << "RREQ_REFRESH";
+        break;
+    }
     default:
         os << "UNKNOWN_TYPE";
     }
@@ -455,6 +478,577 @@ RevRreqHeader::operator==(const RevRreqHeader& o) const
 
 //---------------------------------END-----------------------------------------
 
+//-----------------------------------------------------------------------------
+// Compact RREQ / RevRREQ
+//-----------------------------------------------------------------------------
+
+namespace
+{
+/// Flag bit telling that the originator address equals the IP source
+const uint8_t COMPACT_ORIGIN_ELIDED = (1 << 0);
+/// Flag bits shared with RreqHeader (|J|R|G|D|U|)
+const uint8_t COMPACT_RREQ_FLAGS = 0xf8;
+/// Unknown sequence number flag, see RreqHeader::SetUnknownSeqno
+const uint8_t COMPACT_UNKNOWN_SEQNO = (1 << 3);
+
+/**
+ * \param v value
+ * \return number of bytes of the LEB128 encoding of v
+ */
+uint32_t
+VarintSize(uint32_t v)
+{
+    uint32_t n = 1;
+    while (v >= 0x80)
+    {
+        v >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * \brief Write v as an unsigned LEB128 varint
+ * \param i buffer iterator
+ * \param v value
+ */
+void
+WriteVarint(Buffer::Iterator& i, uint32_t v)
+{
+    while (v >= 0x80)
+    {
+        i.WriteU8(uint8_t(v | 0x80));
+        v >>= 7;
+    }
+    i.WriteU8(uint8_t(v));
+}
+
+/**
+ * \brief Read an unsigned LEB128 varint
+ * \param i buffer iterator
+ * \return value
+ */
+uint32_t
+ReadVarint(Buffer::Iterator& i)
+{
+    uint32_t v = 0;
+    for (uint32_t shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t b = i.ReadU8();
+        v |= uint32_t(b & 0x7f) << shift;
+        if (!(b & 0x80))
+        {
+            break;
+        }
+    }
+    return v;
+}
+
+/**
+ * \param a the value
+ * \param b the base
+ * \return zigzag mapping of the signed difference a - b (mod 2^32)
+ */
+uint32_t
+ZigzagDelta(uint32_t a, uint32_t b)
+{
+    auto d = int32_t(a - b);
+    return (uint32_t(d) << 1) ^ uint32_t(d >> 31);
+}
+
+/**
+ * \param z zigzag encoded delta
+ * \param b the base
+ * \return b plus the decoded delta (mod 2^32)
+ */
+uint32_t
+UnZigzagDelta(uint32_t z, uint32_t b)
+{
+    return b + ((z >> 1) ^ (0U - (z & 1)));
+}
+} // namespace
+
+CompactRreqHeader::CompactRreqHeader(Ipv4Address ipSrc)
+    : m_flags(0),
+      m_hopCount(0),
+      m_requestID(0),
+      m_dstSeqNo(0),
+      m_originSeqNo(0),
+      m_ipSrc(ipSrc)
+{
+}
+
+CompactRreqHeader::CompactRreqHeader(const RreqHeader& h, Ipv4Address ipSrc)
+    : m_flags((h.GetGratuitousRrep() ? (1 << 5) : 0) | (h.GetDestinationOnly() ? (1 << 4) : 0) |
+              (h.GetUnknownSeqno() ? COMPACT_UNKNOWN_SEQNO : 0)),
+      m_hopCount(h.GetHopCount()),
+      m_requestID(h.GetId()),
+      m_dst(h.GetDst()),
+      m_dstSeqNo(h.GetDstSeqno()),
+      m_origin(h.GetOrigin()),
+      m_originSeqNo(h.GetOriginSeqno()),
+      m_ipSrc(ipSrc)
+{
+}
+
+CompactRreqHeader::CompactRreqHeader(const RevRreqHeader& h, Ipv4Address ipSrc)
+    : m_flags((h.GetGratuitousRrep() ? (1 << 5) : 0) | (h.GetDestinationOnly() ? (1 << 4) : 0) |
+              (h.GetUnknownSeqno() ? COMPACT_UNKNOWN_SEQNO : 0)),
+      m_hopCount(h.GetHopCount()),
+      m_requestID(h.GetId()),
+      m_dst(h.GetDst()),
+      m_dstSeqNo(h.GetDstSeqno()),
+      m_origin(h.GetOrigin()),
+      m_originSeqNo(h.GetOriginSeqno()),
+      m_ipSrc(ipSrc)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED(CompactRreqHeader);
+
+TypeId
+CompactRreqHeader::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::raodv::CompactRreqHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("raodv")
+                            .AddConstructor<CompactRreqHeader>();
+    return tid;
+}
+
+TypeId
+CompactRreqHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+bool
+CompactRreqHeader::IsOriginElided() const
+{
+    return m_origin == m_ipSrc;
+}
+
+uint32_t
+CompactRreqHeader::GetSerializedSize() const
+{
+    uint32_t size = 2 + VarintSize(m_requestID) + 4;
+    if (!(m_flags & COMPACT_UNKNOWN_SEQNO))
+    {
+        size += VarintSize(m_dstSeqNo);
+    }
+    if (!IsOriginElided())
+    {
+        size += 4;
+    }
+    return size + VarintSize(ZigzagDelta(m_originSeqNo, m_requestID));
+}
+
+void
+CompactRreqHeader::Serialize(Buffer::Iterator i) const
+{
+    bool elided = IsOriginElided();
+    i.WriteU8((m_flags & COMPACT_RREQ_FLAGS) | (elided ? COMPACT_ORIGIN_ELIDED : 0));
+    i.WriteU8(m_hopCount);
+    WriteVarint(i, m_requestID);
+    WriteTo(i, m_dst);
+    if (!(m_flags & COMPACT_UNKNOWN_SEQNO))
+    {
+        WriteVarint(i, m_dstSeqNo);
+    }
+    if (!elided)
+    {
+        WriteTo(i, m_origin);
+    }
+    WriteVarint(i, ZigzagDelta(m_originSeqNo, m_requestID));
+}
+
+uint32_t
+CompactRreqHeader::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t flags = i.ReadU8();
+    m_flags = flags & COMPACT_RREQ_FLAGS;
+    m_hopCount = i.ReadU8();
+    m_requestID = ReadVarint(i);
+    ReadFrom(i, m_dst);
+    m_dstSeqNo = 0;
+    if (!(m_flags & COMPACT_UNKNOWN_SEQNO))
+    {
+        m_dstSeqNo = ReadVarint(i);
+    }
+    if (flags & COMPACT_ORIGIN_ELIDED)
+    {
+        m_origin = m_ipSrc;
+    }
+    else
+    {
+        ReadFrom(i, m_origin);
+    }
+    m_originSeqNo = UnZigzagDelta(ReadVarint(i), m_requestID);
+
+    uint32_t dist = i.GetDistanceFrom(start);
+    NS_ASSERT(dist == GetSerializedSize());
+    return dist;
+}
+
+void
+CompactRreqHeader::Print(std::ostream& os) const
+{
+    os << "RREQ ID " << m_requestID << " destination: ipv4 " << m_dst << " sequence number "
+       << m_dstSeqNo << " source: ipv4 " << m_origin << " sequence number " << m_originSeqNo
+       << " origin elided " << IsOriginElided();
+}
+
+RreqHeader
+CompactRreqHeader::GetRreqHeader() const
+{
+    RreqHeader h(/*flags*/ 0,
+                 /*reserved*/ 0,
+                 m_hopCount,
+                 m_requestID,
+                 m_dst,
+                 m_dstSeqNo,
+                 m_origin,
+                 m_originSeqNo);
+    h.SetGratuitousRrep(m_flags & (1 << 5));
+    h.SetDestinationOnly(m_flags & (1 << 4));
+    h.SetUnknownSeqno(m_flags & COMPACT_UNKNOWN_SEQNO);
+    return h;
+}
+
+RevRreqHeader
+CompactRreqHeader::GetRevRreqHeader() const
+{
+    RevRreqHeader h(/*flags*/ 0,
+                    /*reserved*/ 0,
+                    m_hopCount,
+                    m_requestID,
+                    m_dst,
+                    m_dstSeqNo,
+                    m_origin,
+                    m_originSeqNo);
+    h.SetGratuitousRrep(m_flags & (1 << 5));
+    h.SetDestinationOnly(m_flags & (1 << 4));
+    h.SetUnknownSeqno(m_flags & COMPACT_UNKNOWN_SEQNO);
+    return h;
+}
+
+bool
+CompactRreqHeader::operator==(const CompactRreqHeader& o) const
+{
+    return (m_flags == o.m_flags && m_hopCount == o.m_hopCount && m_requestID == o.m_requestID &&
+            m_dst == o.m_dst && m_dstSeqNo == o.m_dstSeqNo && m_origin == o.m_origin &&
+            m_originSeqNo == o.m_originSeqNo);
+}
+
+std::ostream&
+operator<<(std::ostream& os, const CompactRreqHeader& h)
+{
+    h.Print(os);
+    return os;
+}
+
+//-----------------------------------------------------------------------------
+// Aggregate record
+//-----------------------------------------------------------------------------
+
+AggregateRecordHeader::AggregateRecordHeader(uint8_t ttl, uint16_t length)
+    : m_ttl(ttl),
+      m_length(length)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED(AggregateRecordHeader);
+
+TypeId
+AggregateRecordHeader::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::raodv::AggregateRecordHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("raodv")
+                            .AddConstructor<AggregateRecordHeader>();
+    return tid;
+}
+
+TypeId
+AggregateRecordHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+AggregateRecordHeader::GetSerializedSize() const
+{
+    return 3;
+}
+
+void
+AggregateRecordHeader::Serialize(Buffer::Iterator i) const
+{
+    i.WriteU8(m_ttl);
+    i.WriteHtonU16(m_length);
+}
+
+uint32_t
+AggregateRecordHeader::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    m_ttl = i.ReadU8();
+    m_length = i.ReadNtohU16();
+
+    uint32_t dist = i.GetDistanceFrom(start);
+    NS_ASSERT(dist == GetSerializedSize());
+    return dist;
+}
+
+void
+AggregateRecordHeader::Print(std::ostream& os) const
+{
+    os << "record TTL " << (uint32_t)m_ttl << " length " << m_length;
+}
+
+bool
+AggregateRecordHeader::operator==(const AggregateRecordHeader& o) const
+{
+    return (m_ttl == o.m_ttl && m_length == o.m_length);
+}
+
+std::ostream&
+operator<<(std::ostream& os, const AggregateRecordHeader& h)
+{
+    h.Print(os);
+    return os;
+}
+
+//-----------------------------------------------------------------------------
+// Location extension
+//-----------------------------------------------------------------------------
+
+LocationExtension::LocationExtension(Vector sourcePosition, double sourceSpeed, Time sourceTime)
+    : m_sourcePosition(sourcePosition),
+      m_sourceSpeed(sourceSpeed),
+      m_sourceTime(sourceTime),
+      m_zone(false),
+      m_targetSpeed(0),
+      m_valid(true)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED(LocationExtension);
+
+TypeId
+LocationExtension::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::raodv::LocationExtension")
+                            .SetParent<Header>()
+                            .SetGroupName("raodv")
+                            .AddConstructor<LocationExtension>();
+    return tid;
+}
+
+TypeId
+LocationExtension::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+LocationExtension::GetSerializedSize() const
+{
+    return 32;
+}
+
+/**
+ * Write a coordinate in centimeters
+ * \param i buffer iterator
+ * \param meters the coordinate in meters
+ */
+static void
+WriteCentimeters(Buffer::Iterator& i, double meters)
+{
+    i.WriteHtonU32(static_cast<uint32_t>(static_cast<int32_t>(std::round(meters * 100))));
+}
+
+/**
+ * Read a coordinate written by WriteCentimeters
+ * \param i buffer iterator
+ * \return the coordinate in meters
+ */
+static double
+ReadCentimeters(Buffer::Iterator& i)
+{
+    return static_cast<int32_t>(i.ReadNtohU32()) / 100.0;
+}
+
+/**
+ * Convert a speed to cm/s, saturating at the largest value the field holds
+ * \param speed the speed in m/s
+ * \return the speed in cm/s
+ */
+static uint16_t
+SpeedToCentimeters(double speed)
+{
+    return static_cast<uint16_t>(std::min(std::round(speed * 100), 65535.0));
+}
+
+void
+LocationExtension::Serialize(Buffer::Iterator i) const
+{
+    i.WriteU8(EXTENSION_TYPE);
+    i.WriteU8(GetSerializedSize() - 2);
+    i.WriteU8(m_zone ? (1 << 7) : 0);
+    i.WriteU8(0);
+    WriteCentimeters(i, m_sourcePosition.x);
+    WriteCentimeters(i, m_sourcePosition.y);
+    i.WriteHtonU32(m_sourceTime.GetMilliSeconds());
+    i.WriteHtonU16(SpeedToCentimeters(m_sourceSpeed));
+    i.WriteHtonU16(SpeedToCentimeters(m_targetSpeed));
+    WriteCentimeters(i, m_targetPosition.x);
+    WriteCentimeters(i, m_targetPosition.y);
+    i.WriteHtonU32(m_targetTime.GetMilliSeconds());
+}
+
+uint32_t
+LocationExtension::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t type = i.ReadU8();
+    uint8_t length = i.ReadU8();
+    m_valid = (type == EXTENSION_TYPE && length == GetSerializedSize() - 2);
+    m_zone = (i.ReadU8() & (1 << 7));
+    i.ReadU8();
+    m_sourcePosition.x = ReadCentimeters(i);
+    m_sourcePosition.y = ReadCentimeters(i);
+    m_sourcePosition.z = 0;
+    m_sourceTime = MilliSeconds(i.ReadNtohU32());
+    m_sourceSpeed = i.ReadNtohU16() / 100.0;
+    m_targetSpeed = i.ReadNtohU16() / 100.0;
+    m_targetPosition.x = ReadCentimeters(i);
+    m_targetPosition.y = ReadCentimeters(i);
+    m_targetPosition.z = 0;
+    m_targetTime = MilliSeconds(i.ReadNtohU32());
+
+    uint32_t dist = i.GetDistanceFrom(start);
+    NS_ASSERT(dist == GetSerializedSize());
+    return dist;
+}
+
+void
+LocationExtension::Print(std::ostream& os) const
+{
+    os << "source " << m_sourcePosition << " speed " << m_sourceSpeed << " at "
+       << m_sourceTime.As(Time::S);
+    if (m_zone)
+    {
+        os << " target " << m_targetPosition << " speed " << m_targetSpeed << " at "
+           << m_targetTime.As(Time::S);
+    }
+}
+
+void
+LocationExtension::SetTarget(Vector position, double speed, Time time)
+{
+    m_zone = true;
+    m_targetPosition = position;
+    m_targetSpeed = speed;
+    m_targetTime = time;
+}
+
+bool
+LocationExtension::operator==(const LocationExtension& o) const
+{
+    return (m_sourcePosition.x == o.m_sourcePosition.x &&
+            m_sourcePosition.y == o.m_sourcePosition.y && m_sourceSpeed == o.m_sourceSpeed &&
+            m_sourceTime == o.m_sourceTime && m_zone == o.m_zone &&
+            m_targetPosition.x == o.m_targetPosition.x &&
+            m_targetPosition.y == o.m_targetPosition.y && m_targetSpeed == o.m_targetSpeed &&
+            m_targetTime == o.m_targetTime);
+}
+
+std::ostream&
+operator<<(std::ostream& os, const LocationExtension& h)
+{
+    h.Print(os);
+    return os;
+}
+
+//-----------------------------------------------------------------------------
+// Load extension
+//-----------------------------------------------------------------------------
+
+LoadExtension::LoadExtension(uint32_t load)
+    : m_load(load),
+      m_valid(true)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED(LoadExtension);
+
+TypeId
+LoadExtension::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::raodv::LoadExtension")
+                            .SetParent<Header>()
+                            .SetGroupName("raodv")
+                            .AddConstructor<LoadExtension>();
+    return tid;
+}
+
+TypeId
+LoadExtension::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+LoadExtension::GetSerializedSize() const
+{
+    return 8;
+}
+
+void
+LoadExtension::Serialize(Buffer::Iterator i) const
+{
+    i.WriteU8(EXTENSION_TYPE);
+    i.WriteU8(GetSerializedSize() - 2);
+    i.WriteHtonU16(0);
+    i.WriteHtonU32(m_load);
+}
+
+uint32_t
+LoadExtension::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t type = i.ReadU8();
+    uint8_t length = i.ReadU8();
+    m_valid = (type == EXTENSION_TYPE && length == GetSerializedSize() - 2);
+    i.ReadNtohU16();
+    m_load = i.ReadNtohU32();
+
+    uint32_t dist = i.GetDistanceFrom(start);
+    NS_ASSERT(dist == GetSerializedSize());
+    return dist;
+}
+
+void
+LoadExtension::Print(std::ostream& os) const
+{
+    os << "path load " << m_load;
+}
+
+bool
+LoadExtension::operator==(const LoadExtension& o) const
+{
+    return m_load == o.m_load;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const LoadExtension& h)
+{
+    h.Print(os);
+    return os;
+}
+
 //-----------------------------------------------------------------------------
 // RREP
 //-----------------------------------------------------------------------------
@@ -573,6 +1167,63 @@ RrepHeader::GetAckRequired() const
     return (m_flags & (1 << 6));
 }
 
+void
+RrepHeader::SetCompactCapable(bool f)
+{
+    if (f)
+    {
+        m_flags |= (1 << 0);
+    }
+    else
+    {
+        m_flags &= ~(1 << 0);
+    }
+}
+
+bool
+RrepHeader::GetCompactCapable() const
+{
+    return (m_flags & (1 << 0));
+}
+
+void
+RrepHeader::SetCoalesceCapable(bool f)
+{
+    if (f)
+    {
+        m_flags |= (1 << 1);
+    }
+    else
+    {
+        m_flags &= ~(1 << 1);
+    }
+}
+
+bool
+RrepHeader::GetCoalesceCapable() const
+{
+    return (m_flags & (1 << 1));
+}
+
+void
+RrepHeader::SetRefreshCapable(bool f)
+{
+    if (f)
+    {
+        m_flags |= (1 << 2);
+    }
+    else
+    {
+        m_flags &= ~(1 << 2);
+    }
+}
+
+bool
+RrepHeader::GetRefreshCapable() const
+{
+    return (m_flags & (1 << 2));
+}
+
 void
 RrepHeader::SetPrefixSize(uint8_t sz)
 {
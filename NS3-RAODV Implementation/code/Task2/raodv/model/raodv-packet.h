@@ -20,6 +20,7 @@
 #include "ns3/header.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/nstime.h"
+#include "ns3/vector.h"
 
 #include <iostream>
 #include <map>
@@ -39,7 +40,11 @@ enum MessageType
     RAODVTYPE_RREP = 2,    //!< RAODVTYPE_RREP
     RAODVTYPE_RERR = 3,    //!< RAODVTYPE_RERR
     RAODVTYPE_RREP_ACK = 4, //!< RAODVTYPE_RREP_ACK
-    RAODVTYPE_REVREQUEST =5 
+    RAODVTYPE_REVREQUEST =5,
+    RAODVTYPE_RREQ_COMPACT = 6,      //!< RAODVTYPE_RREQ in compact encoding
+    RAODVTYPE_REVREQUEST_COMPACT = 7, //!< RAODVTYPE_REVREQUEST in compact encoding
+    RAODVTYPE_AGGREGATE = 8,          //!< Several control messages in one datagram
+    RAODVTYPE_RREQ_REFRESH = 9        //!< RREQ unicast along an existing route to refresh it
 };
 
 /**
@@ -326,6 +331,323 @@ class RreqHeader : public Header
  */
 std::ostream& operator<<(std::ostream& os, const RreqHeader&);
 
+/**
+* \ingroup raodv
+* \brief Record header inside a RAODVTYPE_AGGREGATE datagram
+*
+* An aggregated datagram is a TypeHeader of type RAODVTYPE_AGGREGATE followed
+* by one or more records. Each record is this header followed by Length bytes
+* holding a complete control message (TypeHeader + payload). TTL carries the
+* IP TTL the message would have been sent with on its own.
+  \verbatim
+  0                   1                   2
+  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |      TTL      |            Length             |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  \endverbatim
+*/
+class AggregateRecordHeader : public Header
+{
+  public:
+    /**
+     * constructor
+     * \param ttl the IP TTL of the enclosed message
+     * \param length the size of the enclosed message in bytes
+     */
+    AggregateRecordHeader(uint8_t ttl = 0, uint16_t length = 0);
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    void Print(std::ostream& os) const override;
+
+    /**
+     * \brief Get the TTL of the enclosed message
+     * \return the TTL
+     */
+    uint8_t GetTtl() const
+    {
+        return m_ttl;
+    }
+
+    /**
+     * \brief Get the size of the enclosed message
+     * \return the size in bytes
+     */
+    uint16_t GetLength() const
+    {
+        return m_length;
+    }
+
+    /**
+     * \brief Comparison operator
+     * \param o header to compare
+     * \return true if the headers are equal
+     */
+    bool operator==(const AggregateRecordHeader& o) const;
+
+  private:
+    uint8_t m_ttl;     ///< IP TTL of the enclosed message
+    uint16_t m_length; ///< Size of the enclosed message
+};
+
+/**
+ * \brief Stream output operator
+ * \param os output stream
+ * \return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, const AggregateRecordHeader&);
+
+/**
+* \ingroup raodv
+* \brief Location extension appended to RREQ and reverse request messages
+  \verbatim
+  0                   1                   2                   3
+  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |     Type      |    Length     |Z|  Reserved   |   Reserved    |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |                      Source X position (cm)                   |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |                      Source Y position (cm)                   |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |                       Source timestamp (ms)                   |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |      Source speed (cm/s)      |      Target speed (cm/s)      |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |                      Target X position (cm)                   |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |                      Target Y position (cm)                   |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |                       Target timestamp (ms)                   |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  \endverbatim
+  The source is the node that started the flood, the target is the node it looks for. The
+  target fields are only meaningful when the Z flag is set.
+*/
+class LocationExtension : public Header
+{
+  public:
+    /// Extension type
+    static constexpr uint8_t EXTENSION_TYPE = 1;
+
+    /**
+     * constructor
+     * \param sourcePosition position of the flood originator
+     * \param sourceSpeed speed of the flood originator in m/s
+     * \param sourceTime time at which sourcePosition was measured
+     */
+    LocationExtension(Vector sourcePosition = Vector(),
+                      double sourceSpeed = 0,
+                      Time sourceTime = Time());
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    void Print(std::ostream& os) const override;
+
+    /**
+     * \brief Get the position of the flood originator
+     * \return the position
+     */
+    Vector GetSourcePosition() const
+    {
+        return m_sourcePosition;
+    }
+
+    /**
+     * \brief Get the speed of the flood originator
+     * \return the speed in m/s
+     */
+    double GetSourceSpeed() const
+    {
+        return m_sourceSpeed;
+    }
+
+    /**
+     * \brief Get the time the source position was measured
+     * \return the time
+     */
+    Time GetSourceTime() const
+    {
+        return m_sourceTime;
+    }
+
+    /**
+     * \brief Set the last known location of the node the flood looks for and enable the zone
+     * \param position the position
+     * \param speed the speed in m/s
+     * \param time the time at which position was measured
+     */
+    void SetTarget(Vector position, double speed, Time time);
+
+    /**
+     * \brief Check whether the flood is limited to a request zone
+     * \return true if the target location is set
+     */
+    bool HasZone() const
+    {
+        return m_zone;
+    }
+
+    /**
+     * \brief Get the last known position of the target
+     * \return the position
+     */
+    Vector GetTargetPosition() const
+    {
+        return m_targetPosition;
+    }
+
+    /**
+     * \brief Get the last known speed of the target
+     * \return the speed in m/s
+     */
+    double GetTargetSpeed() const
+    {
+        return m_targetSpeed;
+    }
+
+    /**
+     * \brief Get the time the target position was measured
+     * \return the time
+     */
+    Time GetTargetTime() const
+    {
+        return m_targetTime;
+    }
+
+    /**
+     * \brief Check whether the header was read from a valid location extension
+     * \return true if the type and length matched
+     */
+    bool IsValid() const
+    {
+        return m_valid;
+    }
+
+    /**
+     * \brief Comparison operator
+     * \param o header to compare
+     * \return true if the headers are equal
+     */
+    bool operator==(const LocationExtension& o) const;
+
+  private:
+    Vector m_sourcePosition; ///< Position of the flood originator
+    double m_sourceSpeed;    ///< Speed of the flood originator
+    Time m_sourceTime;       ///< Time the source position was measured
+    bool m_zone;             ///< Whether the target fields are set
+    Vector m_targetPosition; ///< Last known position of the target
+    double m_targetSpeed;    ///< Last known speed of the target
+    Time m_targetTime;       ///< Time the target position was measured
+    bool m_valid;            ///< Whether the extension was deserialized correctly
+};
+
+/**
+ * \brief Stream output operator
+ * \param os output stream
+ * \return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, const LocationExtension&);
+
+/**
+* \ingroup raodv
+* \brief Path load extension appended to RREQ and reverse request messages
+  \verbatim
+  0                   1                   2                   3
+  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |     Type      |    Length     |           Reserved            |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |                      Path load (packets)                      |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  \endverbatim
+  The path load is the sum or the maximum of the packets queued at the nodes that forwarded
+  the message. It precedes the location extension when both are present.
+*/
+class LoadExtension : public Header
+{
+  public:
+    /// Extension type
+    static constexpr uint8_t EXTENSION_TYPE = 2;
+
+    /**
+     * constructor
+     * \param load the path load
+     */
+    LoadExtension(uint32_t load = 0);
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    void Print(std::ostream& os) const override;
+
+    /**
+     * \brief Set the path load
+     * \param load the path load
+     */
+    void SetLoad(uint32_t load)
+    {
+        m_load = load;
+    }
+
+    /**
+     * \brief Get the path load
+     * \return the path load
+     */
+    uint32_t GetLoad() const
+    {
+        return m_load;
+    }
+
+    /**
+     * \brief Check whether the header was read from a valid load extension
+     * \return true if the type and length matched
+     */
+    bool IsValid() const
+    {
+        return m_valid;
+    }
+
+    /**
+     * \brief Comparison operator
+     * \param o header to compare
+     * \return true if the headers are equal
+     */
+    bool operator==(const LoadExtension& o) const;
+
+  private:
+    uint32_t m_load; ///< Path load
+    bool m_valid;    ///< Whether the extension was deserialized correctly
+};
+
+/**
+ * \brief Stream output operator
+ * \param os output stream
+ * \return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, const LoadExtension&);
+
 /**
 * \ingroup raodv
 * \brief Route Reply (RREP) Message Format
@@ -549,6 +871,115 @@ class RevRreqHeader : public Header
 
 std::ostream& operator<<(std::ostream& os, const RevRreqHeader&);
 
+/**
+* \ingroup raodv
+* \brief Compact encoding of RREQ and reverse RREQ messages
+*
+* Carries the same fields as RreqHeader / RevRreqHeader in fewer bytes and is
+* sent with type RAODVTYPE_RREQ_COMPACT or RAODVTYPE_REVREQUEST_COMPACT. The
+* reserved byte is dropped, the RREQ ID and destination sequence number are
+* unsigned LEB128 varints, the destination sequence number is omitted when the
+* U flag is set, the originator address is omitted (O flag) when it equals the
+* source address of the IP header and the originator sequence number is sent as
+* a zigzag varint delta against the RREQ ID.
+  \verbatim
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |J|R|G|D|U|0|0|O|   Hop Count   |  RREQ ID (varint, 1-5 bytes) ...
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |                    Destination IP Address                     |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  | Destination Sequence Number (varint, absent if U)           ...
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |            Originator IP Address (absent if O)                |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  | Originator Sequence Number - RREQ ID (zigzag varint)        ...
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  \endverbatim
+*
+* The IP source address must be known on both sides: pass it to the
+* constructor when sending and call SetIpSource() before RemoveHeader().
+*/
+class CompactRreqHeader : public Header
+{
+  public:
+    /**
+     * constructor
+     * \param ipSrc the source address of the enclosing IP packet
+     */
+    CompactRreqHeader(Ipv4Address ipSrc = Ipv4Address());
+    /**
+     * constructor
+     * \param h the RREQ to encode
+     * \param ipSrc the source address of the enclosing IP packet
+     */
+    CompactRreqHeader(const RreqHeader& h, Ipv4Address ipSrc);
+    /**
+     * constructor
+     * \param h the reverse RREQ to encode
+     * \param ipSrc the source address of the enclosing IP packet
+     */
+    CompactRreqHeader(const RevRreqHeader& h, Ipv4Address ipSrc);
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    void Print(std::ostream& os) const override;
+
+    /**
+     * \brief Set the IP source address used to restore an elided originator
+     * \param a the source address of the enclosing IP packet
+     */
+    void SetIpSource(Ipv4Address a)
+    {
+        m_ipSrc = a;
+    }
+
+    /**
+     * \brief Check whether the originator address is elided on the wire
+     * \return true if the originator equals the IP source address
+     */
+    bool IsOriginElided() const;
+
+    /**
+     * \return the decoded message as a RREQ header
+     */
+    RreqHeader GetRreqHeader() const;
+    /**
+     * \return the decoded message as a reverse RREQ header
+     */
+    RevRreqHeader GetRevRreqHeader() const;
+
+    /**
+     * \brief Comparison operator
+     * \param o header to compare
+     * \return true if the headers are equal
+     */
+    bool operator==(const CompactRreqHeader& o) const;
+
+  private:
+    uint8_t m_flags;        ///< |J|R|G|D|U| bit flags, same positions as RreqHeader
+    uint8_t m_hopCount;     ///< Hop Count
+    uint32_t m_requestID;   ///< RREQ ID
+    Ipv4Address m_dst;      ///< Destination IP Address
+    uint32_t m_dstSeqNo;    ///< Destination Sequence Number
+    Ipv4Address m_origin;   ///< Originator IP Address
+    uint32_t m_originSeqNo; ///< Source Sequence Number
+    Ipv4Address m_ipSrc;    ///< Source address of the enclosing IP packet (not serialized)
+};
+
+/**
+ * \brief Stream output operator
+ * \param os output stream
+ * \return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, const CompactRreqHeader&);
+
 
 ///END-------------------------------------------------------------------
 
@@ -679,6 +1110,36 @@ class RrepHeader : public Header
      * \return the ack required flag
      */
     bool GetAckRequired() const;
+    /**
+     * \brief Advertise support for the compact RREQ encoding (hello only)
+     * \param f the compact capability flag
+     */
+    void SetCompactCapable(bool f);
+    /**
+     * \brief Get the compact capability flag
+     * \return true if the sender accepts CompactRreqHeader messages
+     */
+    bool GetCompactCapable() const;
+    /**
+     * \brief Advertise support for aggregated control datagrams (hello only)
+     * \param f the coalescing capability flag
+     */
+    void SetCoalesceCapable(bool f);
+    /**
+     * \brief Get the coalescing capability flag
+     * \return true if the sender accepts RAODVTYPE_AGGREGATE datagrams
+     */
+    bool GetCoalesceCapable() const;
+    /**
+     * \brief Advertise support for RAODVTYPE_RREQ_REFRESH messages (hello only)
+     * \param f the refresh capability flag
+     */
+    void SetRefreshCapable(bool f);
+    /**
+     * \brief Get the refresh capability flag
+     * \return true if the sender accepts and forwards refresh RREQs
+     */
+    bool GetRefreshCapable() const;
     /**
      * \brief Set the prefix size
      * \param sz the prefix size
@@ -707,7 +1168,8 @@ class RrepHeader : public Header
     bool operator==(const RrepHeader& o) const;
 
   private:
-    uint8_t m_flags;      ///< A - acknowledgment required flag
+    uint8_t m_flags;      ///< A - acknowledgment required flag, C - compact capable (bit 0),
+                          ///< G - coalescing capable (bit 1)
     uint8_t m_prefixSize; ///< Prefix Size
     uint8_t m_hopCount;   ///< Hop Count
     Ipv4Address m_dst;    ///< Destination IP Address
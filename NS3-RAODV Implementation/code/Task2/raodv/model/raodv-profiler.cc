@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "raodv-profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+namespace raodv
+{
+
+namespace
+{
+
+/// Compare C strings by content
+struct NameLess
+{
+    /**
+     * \param a a name
+     * \param b a name
+     * \returns true if a sorts before b
+     */
+    bool operator()(const char* a, const char* b) const
+    {
+        return std::strcmp(a, b) < 0;
+    }
+};
+
+/// \returns the sections by name; map nodes keep the references stable
+std::map<const char*, ProfileSection, NameLess>&
+GetSections()
+{
+    static std::map<const char*, ProfileSection, NameLess> sections;
+    return sections;
+}
+
+/// \returns the number of attached routing protocols
+uint32_t&
+GetUsers()
+{
+    static uint32_t users = 0;
+    return users;
+}
+
+} // namespace
+
+ProfileSection&
+Profiler::GetSection(const char* name)
+{
+    auto i = GetSections().try_emplace(name, ProfileSection{name, 0, {}, {}}).first;
+    return i->second;
+}
+
+void
+Profiler::Print(std::ostream& os)
+{
+    std::vector<const ProfileSection*> sections;
+    for (const auto& i : GetSections())
+    {
+        if (i.second.count > 0)
+        {
+            sections.push_back(&i.second);
+        }
+    }
+    std::sort(sections.begin(), sections.end(), [](const ProfileSection* a, const ProfileSection* b) {
+        return a->total > b->total;
+    });
+
+    std::ios oldState(nullptr);
+    oldState.copyfmt(os);
+    os << "RAODV profile, inclusive wall clock time\n"
+       << std::left << std::setw(32) << "Scope" << std::right << std::setw(12) << "Count"
+       << std::setw(14) << "Total (ms)" << std::setw(14) << "Mean (us)" << std::setw(14)
+       << "Max (us)"
+       << "\n"
+       << std::fixed << std::setprecision(3);
+    for (const ProfileSection* section : sections)
+    {
+        double total = section->total.count() / 1e6;
+        double mean = section->total.count() / 1e3 / section->count;
+        os << std::left << std::setw(32) << section->name << std::right << std::setw(12)
+           << section->count << std::setw(14) << total << std::setw(14) << mean << std::setw(14)
+           << section->max.count() / 1e3 << "\n";
+    }
+    os.copyfmt(oldState);
+}
+
+void
+Profiler::Reset()
+{
+    for (auto& i : GetSections())
+    {
+        i.second.count = 0;
+        i.second.total = std::chrono::nanoseconds(0);
+        i.second.max = std::chrono::nanoseconds(0);
+    }
+}
+
+void
+Profiler::Attach()
+{
+    GetUsers()++;
+}
+
+void
+Profiler::Detach()
+{
+    uint32_t& users = GetUsers();
+    if (users > 0 && --users == 0)
+    {
+        Print(std::clog);
+    }
+}
+
+} // namespace raodv
+} // namespace ns3
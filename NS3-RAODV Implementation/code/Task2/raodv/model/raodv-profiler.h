@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RAODV_PROFILER_H
+#define RAODV_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace ns3
+{
+namespace raodv
+{
+
+/// Wall clock time spent in a profiled scope, summed over all nodes
+struct ProfileSection
+{
+    const char* name;               ///< Name of the scope
+    uint64_t count;                 ///< Number of times the scope was entered
+    std::chrono::nanoseconds total; ///< Time spent in the scope, nested scopes included
+    std::chrono::nanoseconds max;   ///< Longest single visit
+};
+
+/**
+ * \ingroup raodv
+ *
+ * \brief Registry of the scopes timed with RAODV_PROFILE_SCOPE.
+ *
+ * The scopes are only timed when the module is built with RAODV_PROFILE defined, e.g. with the
+ * NS3_RAODV_PROFILE CMake option. Each RoutingProtocol attaches itself on construction and
+ * detaches in DoDispose; the last one to detach prints the report to std::clog.
+ */
+class Profiler
+{
+  public:
+    /**
+     * \param name the name of the scope, with static storage duration
+     * \returns the section of the scope, created on first use
+     */
+    static ProfileSection& GetSection(const char* name);
+    /**
+     * Print one line per section, the most expensive first: count, total, mean and max time
+     * \param os output stream
+     */
+    static void Print(std::ostream& os);
+    /// Set all sections to zero
+    static void Reset();
+    /// Register a routing protocol instance
+    static void Attach();
+    /// Unregister a routing protocol instance, and print the report after the last one
+    static void Detach();
+};
+
+/**
+ * \ingroup raodv
+ *
+ * \brief Adds the wall clock time from its construction to its destruction to a section.
+ */
+class ScopedTimer
+{
+  public:
+    /**
+     * Start timing
+     * \param section the section the time is added to
+     */
+    explicit ScopedTimer(ProfileSection& section)
+        : m_section(section),
+          m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer()
+    {
+        std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - m_start;
+        m_section.count++;
+        m_section.total += elapsed;
+        if (elapsed > m_section.max)
+        {
+            m_section.max = elapsed;
+        }
+    }
+
+  private:
+    ProfileSection& m_section;                     ///< Section the time is added to
+    std::chrono::steady_clock::time_point m_start; ///< Construction time
+};
+
+} // namespace raodv
+} // namespace ns3
+
+/// \cond
+#define RAODV_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RAODV_PROFILE_CONCAT(a, b) RAODV_PROFILE_CONCAT_IMPL(a, b)
+/// \endcond
+
+#ifdef RAODV_PROFILE
+/**
+ * \ingroup raodv
+ * Time the rest of the enclosing scope under a name. The section is looked up once per call
+ * site. Expands to nothing unless RAODV_PROFILE is defined.
+ * \param name the name of the scope, a string literal
+ */
+#define RAODV_PROFILE_SCOPE(name)                                                                  \
+    static ns3::raodv::ProfileSection& RAODV_PROFILE_CONCAT(raodvProfileSection, __LINE__) =     \
+        ns3::raodv::Profiler::GetSection(name);                                                    \
+    ns3::raodv::ScopedTimer RAODV_PROFILE_CONCAT(raodvProfileTimer, __LINE__)(                     \
+        RAODV_PROFILE_CONCAT(raodvProfileSection, __LINE__))
+#else
+#define RAODV_PROFILE_SCOPE(name)
+#endif
+
+#endif /* RAODV_PROFILER_H */
@@ -21,23 +21,35 @@
 
 #include "raodv-routing-protocol.h"
 
+#include "raodv-profiler.h"
+
 #include "ns3/adhoc-wifi-mac.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
 #include "ns3/inet-socket-address.h"
-#include "ns3/log.h"
+#include "ns3/mobility-model.h"
 #include "ns3/pointer.h"
+#include "ns3/queue-disc.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/string.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/traffic-control-layer.h"
 #include "ns3/udp-header.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mac-queue.h"
 #include "ns3/wifi-mpdu.h"
 #include "ns3/wifi-net-device.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
+// Last, so that only the log statements of this file are affected
+#include "raodv-log.h"
+
 namespace ns3
 {
 
@@ -49,6 +61,8 @@ NS_OBJECT_ENSURE_REGISTERED(RoutingProtocol);
 
 /// UDP Port for raodv control traffic
 const uint32_t RoutingProtocol::RAODV_PORT = 654;
+const uint32_t RoutingProtocol::MAX_AGGREGATE_SIZE = 1400;
+const uint32_t RoutingProtocol::RX_RSSI_HISTORY = 32;
 
 /**
  * \ingroup raodv
@@ -155,21 +169,45 @@ RoutingProtocol::RoutingProtocol()
       m_destinationOnly(false),
       m_gratuitousReply(true),
       m_enableHello(false),
+      m_enableCompactHeaders(false),
+      m_enableCoalescing(false),
+      m_rreqSuppression(SUPPRESSION_NONE),
+      m_rreqSuppressionThreshold(3),
+      m_rreqSuppressionRssi(-70),
+      m_revRreqRingSlack(2),
+      m_revRreqGossipProbability(1),
+      m_revRreqGossipHops(1),
+      m_enableLocalRepair(false),
+      m_localRepairHops(3),
+      m_localRepairTimeout(Seconds(0)),
+      m_maxBackupRoutes(0),
+      m_requestZone(ZONE_NONE),
+      m_requestZoneMargin(50),
+      m_adaptiveDiscovery(false),
+      m_enableRouteRefresh(false),
+      m_routeRefreshLead(MilliSeconds(500)),
+      m_linkBreakPrediction(false),
+      m_linkBreakRssi(-85),
+      m_linkBreakHorizon(Seconds(1)),
+      m_pathLoad(LOAD_NONE),
+      m_pathLoadPerHop(10),
+      m_pathLoadWindow(MilliSeconds(50)),
       m_routingTable(m_deletePeriod),
       m_queue(m_maxQueueLen, m_maxQueueTime),
       m_requestId(0),
       m_seqNo(0),
       m_rreqIdCache(m_pathDiscoveryTime),
+      m_revRreqIdCache(m_pathDiscoveryTime),
       m_dpd(m_pathDiscoveryTime),
-      m_nb(m_helloInterval),
-      m_rreqCount(0),
-      m_rerrCount(0),
-      m_htimer(Timer::CANCEL_ON_DESTROY),
-      m_rreqRateLimitTimer(Timer::CANCEL_ON_DESTROY),
-      m_rerrRateLimitTimer(Timer::CANCEL_ON_DESTROY),
+      m_diameterEstimate(0),
+      m_hopLatency(Seconds(0)),
+      m_hopLatencyVar(Seconds(0)),
       m_lastBcastTime(Seconds(0))
 {
     m_nb.SetCallback(MakeCallback(&RoutingProtocol::SendRerrWhenBreaksLinkToNextHop, this));
+#ifdef RAODV_PROFILE
+    Profiler::Attach();
+#endif
 }
 
 TypeId
@@ -321,11 +359,200 @@ RoutingProtocol::GetTypeId()
                           MakeBooleanAccessor(&RoutingProtocol::SetBroadcastEnable,
                                               &RoutingProtocol::GetBroadcastEnable),
                           MakeBooleanChecker())
+            .AddAttribute("EnableCompactHeaders",
+                          "Advertise the compact RREQ encoding in hellos and use it when every "
+                          "current neighbor advertised it as well.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_enableCompactHeaders),
+                          MakeBooleanChecker())
+            .AddAttribute("EnableCoalescing",
+                          "Advertise support for aggregated control datagrams in hellos and, when "
+                          "every current neighbor advertised it as well, send all broadcast "
+                          "control messages that fall into the same jitter window of an "
+                          "interface as one datagram.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_enableCoalescing),
+                          MakeBooleanChecker())
+            .AddAttribute("RreqSuppression",
+                          "Broadcast storm suppression applied to forwarded RREQs: None, Counter "
+                          "(drop the rebroadcast once RreqSuppressionThreshold copies were heard "
+                          "during the jitter delay) or Distance (drop it once a copy was heard "
+                          "at RreqSuppressionRssi or stronger).",
+                          EnumValue(SUPPRESSION_NONE),
+                          MakeEnumAccessor<RreqSuppressionMode>(&RoutingProtocol::m_rreqSuppression),
+                          MakeEnumChecker(SUPPRESSION_NONE,
+                                          "None",
+                                          SUPPRESSION_COUNTER,
+                                          "Counter",
+                                          SUPPRESSION_DISTANCE,
+                                          "Distance"))
+            .AddAttribute("RreqSuppressionThreshold",
+                          "Number of copies of a RREQ, including the first, that cancel the "
+                          "pending rebroadcast in Counter mode.",
+                          UintegerValue(3),
+                          MakeUintegerAccessor(&RoutingProtocol::m_rreqSuppressionThreshold),
+                          MakeUintegerChecker<uint32_t>(2, std::numeric_limits<uint32_t>::max()))
+            .AddAttribute("RreqSuppressionRssi",
+                          "Received signal strength (dBm) at or above which a RREQ copy comes from "
+                          "too close for the rebroadcast to add coverage, in Distance mode.",
+                          DoubleValue(-70),
+                          MakeDoubleAccessor(&RoutingProtocol::m_rreqSuppressionRssi),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("RevRreqRingSlack",
+                          "Hops the reverse request may travel beyond the hop count of the RREQ "
+                          "it answers.",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&RoutingProtocol::m_revRreqRingSlack),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("RevRreqGossipProbability",
+                          "Probability with which a node farther than RevRreqGossipHops from the "
+                          "destination rebroadcasts a reverse request.",
+                          DoubleValue(1),
+                          MakeDoubleAccessor(&RoutingProtocol::m_revRreqGossipProbability),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("RevRreqGossipHops",
+                          "Number of hops around the destination within which reverse requests "
+                          "are always rebroadcast.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&RoutingProtocol::m_revRreqGossipHops),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("EnableLocalRepair",
+                          "Repair a broken route at the node that detects the link break instead "
+                          "of sending a RERR to the source straight away.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_enableLocalRepair),
+                          MakeBooleanChecker())
+            .AddAttribute("LocalRepairHops",
+                          "Maximum number of hops to the destination for which a broken route is "
+                          "repaired locally.",
+                          UintegerValue(3),
+                          MakeUintegerAccessor(&RoutingProtocol::m_localRepairHops),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("LocalRepairTimeout",
+                          "Time a local repair may take before the buffered packets are dropped "
+                          "and the RERR is sent. Zero waits for the ring traversal time of the "
+                          "repair RREQ.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RoutingProtocol::m_localRepairTimeout),
+                          MakeTimeChecker())
+            .AddAttribute("MaxBackupRoutes",
+                          "Number of alternative next hops learned from reverse requests that "
+                          "are kept per destination for failover. Zero disables failover.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&RoutingProtocol::m_maxBackupRoutes),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("RequestZone",
+                          "Location-aided route discovery: None floods the whole network, "
+                          "Rectangle and Cone only rebroadcast RREQs and reverse requests inside "
+                          "a request zone around the last known location of the target.",
+                          EnumValue(ZONE_NONE),
+                          MakeEnumAccessor<RequestZoneMode>(&RoutingProtocol::m_requestZone),
+                          MakeEnumChecker(ZONE_NONE,
+                                          "None",
+                                          ZONE_RECTANGLE,
+                                          "Rectangle",
+                                          ZONE_CONE,
+                                          "Cone"))
+            .AddAttribute("RequestZoneMargin",
+                          "Distance in meters added around the expected zone of the target to "
+                          "absorb location errors.",
+                          DoubleValue(50),
+                          MakeDoubleAccessor(&RoutingProtocol::m_requestZoneMargin),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("AdaptiveDiscovery",
+                          "Start the expanding ring search at the last known hop count of the "
+                          "destination, limit the first network wide RREQ to the observed "
+                          "network diameter and derive the RREQ timeouts from the observed per "
+                          "hop latency instead of NodeTraversalTime.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_adaptiveDiscovery),
+                          MakeBooleanChecker())
+            .AddAttribute("EnableRouteRefresh",
+                          "Refresh the route of a flow this node originates with a unicast RREQ "
+                          "shortly before it expires, if the flow paused for no longer than "
+                          "twice its longest gap so far.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_enableRouteRefresh),
+                          MakeBooleanChecker())
+            .AddAttribute("RouteRefreshLead",
+                          "Time before the expiry of a route at which the refresh RREQ is sent.",
+                          TimeValue(MilliSeconds(500)),
+                          MakeTimeAccessor(&RoutingProtocol::m_routeRefreshLead),
+                          MakeTimeChecker())
+            .AddAttribute("LinkBreakPrediction",
+                          "Track the signal strength trend of every neighbor from the frames "
+                          "overheard on Wi-Fi devices and act before a link breaks: switch the "
+                          "routes through it to a backup, or rediscover them preemptively.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_linkBreakPrediction),
+                          MakeBooleanChecker())
+            .AddAttribute("LinkBreakRssi",
+                          "Signal strength (dBm) below which a link is considered broken. The "
+                          "default is about where 11 Mbit/s DSSS frames start to fail.",
+                          DoubleValue(-85),
+                          MakeDoubleAccessor(&RoutingProtocol::m_linkBreakRssi),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("LinkBreakHorizon",
+                          "A link whose signal strength trend reaches LinkBreakRssi within this "
+                          "time is predicted to break.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&RoutingProtocol::m_linkBreakHorizon),
+                          MakeTimeChecker())
+            .AddAttribute("PathLoadMetric",
+                          "Congestion-aware path selection: Sum or Max collects the packets "
+                          "queued at the forwarding nodes in RREQs and reverse requests and "
+                          "prefers the less loaded of the paths found by a discovery, None "
+                          "selects by hop count only.",
+                          EnumValue(LOAD_NONE),
+                          MakeEnumAccessor<PathLoadMode>(&RoutingProtocol::m_pathLoad),
+                          MakeEnumChecker(LOAD_NONE, "None", LOAD_SUM, "Sum", LOAD_MAX, "Max"))
+            .AddAttribute("PathLoadPerHop",
+                          "Path load, in queued packets, that costs as much as one extra hop.",
+                          UintegerValue(10),
+                          MakeUintegerAccessor(&RoutingProtocol::m_pathLoadPerHop),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("PathLoadWindow",
+                          "Time the originator collects the paths offered by reverse requests, "
+                          "and the destination the copies of a RREQ, before choosing one.",
+                          TimeValue(MilliSeconds(50)),
+                          MakeTimeAccessor(&RoutingProtocol::m_pathLoadWindow),
+                          MakeTimeChecker())
+            .AddAttribute("TimerWheelTick",
+                          "Resolution of the timing wheel the protocol timers share. Zero gives "
+                          "every timer its own simulator event and exact expiry times.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RoutingProtocol::SetTimerWheelTick,
+                                           &RoutingProtocol::GetTimerWheelTick),
+                          MakeTimeChecker())
             .AddAttribute("UniformRv",
                           "Access to the underlying UniformRandomVariable",
                           StringValue("ns3::UniformRandomVariable"),
                           MakePointerAccessor(&RoutingProtocol::m_uniformRandomVariable),
-                          MakePointerChecker<UniformRandomVariable>());
+                          MakePointerChecker<UniformRandomVariable>())
+            .AddTraceSource("TxControl",
+                            "A RAODV control packet is handed to the socket.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_txControlTrace),
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("Tx",
+                            "A RAODV control message is sent, alone or in an aggregate.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_txTrace),
+                            "ns3::raodv::RoutingProtocol::ControlTracedCallback")
+            .AddTraceSource("Rx",
+                            "A RAODV control message is received.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_rxTrace),
+                            "ns3::raodv::RoutingProtocol::ControlTracedCallback")
+            .AddTraceSource("Suppress",
+                            "A RREQ or reverse request is not rebroadcast.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_suppressTrace),
+                            "ns3::raodv::RoutingProtocol::ControlTracedCallback")
+            .AddTraceSource("Drop",
+                            "A RAODV control message is dropped, or not sent.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_dropTrace),
+                            "ns3::raodv::RoutingProtocol::DropTracedCallback")
+            .AddTraceSource("Discovery",
+                            "A route discovery for buffered packets ends.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_discoveryTrace),
+                            "ns3::raodv::RoutingProtocol::DiscoveryTracedCallback");
     return tid;
 }
 
@@ -350,7 +577,35 @@ RoutingProtocol::~RoutingProtocol()
 void
 RoutingProtocol::DoDispose()
 {
+    NS_LOG_INFO("Control plane statistics\n" << m_stats);
     m_ipv4 = nullptr;
+    m_discoveryStart.clear();
+    for (auto iter = m_pendingBroadcasts.begin(); iter != m_pendingBroadcasts.end(); iter++)
+    {
+        iter->second.m_flush.Cancel();
+    }
+    m_pendingBroadcasts.clear();
+    for (auto iter = m_pendingRreqForwards.begin(); iter != m_pendingRreqForwards.end(); iter++)
+    {
+        iter->second.m_forward.Cancel();
+    }
+    m_pendingRreqForwards.clear();
+    m_locations.clear();
+    m_hopHistory.clear();
+    m_discoveryAttempts.clear();
+    m_rreqRateLimitTimer.Cancel();
+    m_rateLimitedRreqs.clear();
+    m_rateLimitedRreqDsts.clear();
+    m_rerrRateLimitTimer.Cancel();
+    m_rateLimitedRerrs.clear();
+    m_addressReqTimer.clear();
+    m_localRepairTimer.clear();
+    m_routeRefreshTimer.clear();
+    m_flows.clear();
+    m_pathSelectionTimer.clear();
+    m_pathSelections.clear();
+    m_reverseSelections.clear();
+    m_timerWheel.Clear();
     for (auto iter = m_socketAddresses.begin(); iter != m_socketAddresses.end(); iter++)
     {
         iter->first->Close();
@@ -363,6 +618,11 @@ RoutingProtocol::DoDispose()
         iter->first->Close();
     }
     m_socketSubnetBroadcastAddresses.clear();
+    m_localAddresses.clear();
+    m_interfaceAddresses.clear();
+#ifdef RAODV_PROFILE
+    Profiler::Detach();
+#endif
     Ipv4RoutingProtocol::DoDispose();
 }
 
@@ -386,19 +646,45 @@ RoutingProtocol::AssignStreams(int64_t stream)
     return 1;
 }
 
+MemoryFootprint
+RoutingProtocol::GetMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.routingTable = m_routingTable.GetMemoryUsage();
+    footprint.requestQueue = m_queue.GetMemoryUsage();
+    footprint.idCaches = m_rreqIdCache.GetMemoryUsage() + m_revRreqIdCache.GetMemoryUsage();
+    footprint.dpd = m_dpd.GetMemoryUsage();
+    footprint.neighbors = m_nb.GetMemoryUsage();
+    // A std::map node holds the value, three links and the color
+    footprint.requestTimers =
+        m_addressReqTimer.size() *
+        (sizeof(std::map<Ipv4Address, WheelTimer>::value_type) + 4 * sizeof(void*));
+    return footprint;
+}
+
 void
 RoutingProtocol::Start()
 {
     NS_LOG_FUNCTION(this);
     if (m_enableHello)
     {
-        m_nb.ScheduleTimer();
+        m_nbPurgeTimer.SetFunction(MakeCallback(&RoutingProtocol::NeighborPurgeTimerExpire, this));
+        m_timerWheel.Schedule(m_nbPurgeTimer, m_helloInterval);
     }
-    m_rreqRateLimitTimer.SetFunction(&RoutingProtocol::RreqRateLimitTimerExpire, this);
-    m_rreqRateLimitTimer.Schedule(Seconds(1));
+    m_rreqBucket.SetRate(m_rreqRateLimit);
+    m_rreqRateLimitTimer.SetFunction(
+        MakeCallback(&RoutingProtocol::RreqRateLimitTimerExpire, this));
 
-    m_rerrRateLimitTimer.SetFunction(&RoutingProtocol::RerrRateLimitTimerExpire, this);
-    m_rerrRateLimitTimer.Schedule(Seconds(1));
+    m_rerrBucket.SetRate(m_rerrRateLimit);
+    m_rerrRateLimitTimer.SetFunction(
+        MakeCallback(&RoutingProtocol::RerrRateLimitTimerExpire, this));
+
+    if (m_linkBreakPrediction)
+    {
+        m_nb.SetLinkBreakPrediction(m_linkBreakRssi,
+                                    m_linkBreakHorizon,
+                                    MakeCallback(&RoutingProtocol::LinkBreakPredicted, this));
+    }
 }
 
 Ptr<Ipv4Route>
@@ -407,6 +693,7 @@ RoutingProtocol::RouteOutput(Ptr<Packet> p,
                              Ptr<NetDevice> oif,
                              Socket::SocketErrno& sockerr)
 {
+    RAODV_PROFILE_SCOPE("RouteOutput");
     NS_LOG_FUNCTION(this << header << (oif ? oif->GetIfIndex() : 0));
     if (!p)
     {
@@ -438,6 +725,11 @@ RoutingProtocol::RouteOutput(Ptr<Packet> p,
         }
         UpdateRouteLifeTime(dst, m_activeRouteTimeout);
         UpdateRouteLifeTime(route->GetGateway(), m_activeRouteTimeout);
+        // Control messages only go to neighbors, whose routes need no refresh
+        if (m_enableRouteRefresh && rt.GetHop() > 1)
+        {
+            TrackFlow(dst);
+        }
         return route;
     }
 
@@ -464,9 +756,16 @@ RoutingProtocol::DeferredRouteOutput(Ptr<const Packet> p,
     NS_ASSERT(p && p != Ptr<Packet>());
 
     QueueEntry newEntry(p, header, ucb, ecb);
+    Ipv4Address dst = header.GetDestination();
+    if (m_discoveryStart.find(dst) != m_discoveryStart.end() && !m_queue.Find(dst))
+    {
+        // The packets of the previous discovery expired in the queue
+        EndDiscovery(dst, false);
+    }
     bool result = m_queue.Enqueue(newEntry);
     if (result)
     {
+        m_discoveryStart.try_emplace(dst, Simulator::Now());
         NS_LOG_LOGIC("Add packet " << p->GetUid() << " to queue. Protocol "
                                    << (uint16_t)header.GetProtocol());
         RoutingTableEntry rt;
@@ -488,6 +787,7 @@ RoutingProtocol::RouteInput(Ptr<const Packet> p,
                             const LocalDeliverCallback& lcb,
                             const ErrorCallback& ecb)
 {
+    RAODV_PROFILE_SCOPE("RouteInput");
     NS_LOG_FUNCTION(this << p->GetUid() << header.GetDestination() << idev->GetAddress());
     if (m_socketAddresses.empty())
     {
@@ -527,68 +827,64 @@ RoutingProtocol::RouteInput(Ptr<const Packet> p,
     }
 
     // Broadcast local delivery/forwarding
-    for (auto j = m_socketAddresses.begin(); j != m_socketAddresses.end(); ++j)
+    Ipv4InterfaceAddress iface;
+    if (static_cast<uint32_t>(iif) < m_interfaceAddresses.size())
     {
-        Ipv4InterfaceAddress iface = j->second;
-        if (m_ipv4->GetInterfaceForAddress(iface.GetLocal()) == iif)
+        iface = m_interfaceAddresses[iif];
+    }
+    if (iface.GetLocal() != Ipv4Address() && (dst == iface.GetBroadcast() || dst.IsBroadcast()))
+    {
+        if (m_dpd.IsDuplicate(p, header))
+        {
+            NS_LOG_DEBUG("Duplicated packet " << p->GetUid() << " from " << origin << ". Drop.");
+            return true;
+        }
+        UpdateRouteLifeTime(origin, m_activeRouteTimeout);
+        Ptr<Packet> packet = p->Copy();
+        if (!lcb.IsNull())
+        {
+            NS_LOG_LOGIC("Broadcast local delivery to " << iface.GetLocal());
+            lcb(p, header, iif);
+            // Fall through to additional processing
+        }
+        else
+        {
+            NS_LOG_ERROR("Unable to deliver packet locally due to null callback "
+                         << p->GetUid() << " from " << origin);
+            ecb(p, header, Socket::ERROR_NOROUTETOHOST);
+        }
+        if (!m_enableBroadcast)
         {
-            if (dst == iface.GetBroadcast() || dst.IsBroadcast())
+            return true;
+        }
+        if (header.GetProtocol() == UdpL4Protocol::PROT_NUMBER)
+        {
+            UdpHeader udpHeader;
+            p->PeekHeader(udpHeader);
+            if (udpHeader.GetDestinationPort() == RAODV_PORT)
             {
-                if (m_dpd.IsDuplicate(p, header))
-                {
-                    NS_LOG_DEBUG("Duplicated packet " << p->GetUid() << " from " << origin
-                                                      << ". Drop.");
-                    return true;
-                }
-                UpdateRouteLifeTime(origin, m_activeRouteTimeout);
-                Ptr<Packet> packet = p->Copy();
-                if (!lcb.IsNull())
-                {
-                    NS_LOG_LOGIC("Broadcast local delivery to " << iface.GetLocal());
-                    lcb(p, header, iif);
-                    // Fall through to additional processing
-                }
-                else
-                {
-                    NS_LOG_ERROR("Unable to deliver packet locally due to null callback "
-                                 << p->GetUid() << " from " << origin);
-                    ecb(p, header, Socket::ERROR_NOROUTETOHOST);
-                }
-                if (!m_enableBroadcast)
-                {
-                    return true;
-                }
-                if (header.GetProtocol() == UdpL4Protocol::PROT_NUMBER)
-                {
-                    UdpHeader udpHeader;
-                    p->PeekHeader(udpHeader);
-                    if (udpHeader.GetDestinationPort() == RAODV_PORT)
-                    {
-                        // raodv packets sent in broadcast are already managed
-                        return true;
-                    }
-                }
-                if (header.GetTtl() > 1)
-                {
-                    NS_LOG_LOGIC("Forward broadcast. TTL " << (uint16_t)header.GetTtl());
-                    RoutingTableEntry toBroadcast;
-                    if (m_routingTable.LookupRoute(dst, toBroadcast))
-                    {
-                        Ptr<Ipv4Route> route = toBroadcast.GetRoute();
-                        ucb(route, packet, header);
-                    }
-                    else
-                    {
-                        NS_LOG_DEBUG("No route to forward broadcast. Drop packet " << p->GetUid());
-                    }
-                }
-                else
-                {
-                    NS_LOG_DEBUG("TTL exceeded. Drop packet " << p->GetUid());
-                }
+                // raodv packets sent in broadcast are already managed
                 return true;
             }
         }
+        if (header.GetTtl() > 1)
+        {
+            NS_LOG_LOGIC("Forward broadcast. TTL " << (uint16_t)header.GetTtl());
+            RoutingTableEntry toBroadcast;
+            if (m_routingTable.LookupRoute(dst, toBroadcast))
+            {
+                Ptr<Ipv4Route> route = toBroadcast.GetRoute();
+                ucb(route, packet, header);
+            }
+            else
+            {
+                NS_LOG_DEBUG("No route to forward broadcast. Drop packet " << p->GetUid());
+            }
+        }
+        else
+        {
+            NS_LOG_DEBUG("TTL exceeded. Drop packet " << p->GetUid());
+        }
     }
 
     // Unicast local delivery
@@ -633,6 +929,7 @@ RoutingProtocol::Forwarding(Ptr<const Packet> p,
                             UnicastForwardCallback ucb,
                             ErrorCallback ecb)
 {
+    RAODV_PROFILE_SCOPE("Forwarding");
     NS_LOG_FUNCTION(this);
     Ipv4Address dst = header.GetDestination();
     Ipv4Address origin = header.GetSource();
@@ -671,6 +968,18 @@ RoutingProtocol::Forwarding(Ptr<const Packet> p,
             ucb(route, p, header);
             return true;
         }
+        else if (toDst.GetFlag() == INVALID && FailOver(toDst))
+        {
+            return Forwarding(p, header, ucb, ecb);
+        }
+        else if (toDst.GetFlag() == IN_SEARCH &&
+                 m_localRepairTimer.find(dst) != m_localRepairTimer.end())
+        {
+            NS_LOG_LOGIC("Route to " << dst << " in repair, buffer packet " << p->GetUid());
+            QueueEntry newEntry(p, header, ucb, ecb);
+            m_queue.Enqueue(newEntry);
+            return true;
+        }
         else
         {
             if (toDst.GetValidSeqNo())
@@ -733,7 +1042,7 @@ RoutingProtocol::NotifyInterfaceUp(uint32_t i)
     // Create a socket to listen only on this interface
     Ptr<Socket> socket = Socket::CreateSocket(GetObject<Node>(), UdpSocketFactory::GetTypeId());
     NS_ASSERT(socket);
-    socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this));
+    socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this).Bind(i));
     socket->BindToNetDevice(l3->GetNetDevice(i));
     socket->Bind(InetSocketAddress(iface.GetLocal(), RAODV_PORT));
     socket->SetAllowBroadcast(true);
@@ -743,12 +1052,13 @@ RoutingProtocol::NotifyInterfaceUp(uint32_t i)
     // create also a subnet broadcast socket
     socket = Socket::CreateSocket(GetObject<Node>(), UdpSocketFactory::GetTypeId());
     NS_ASSERT(socket);
-    socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this));
+    socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this).Bind(i));
     socket->BindToNetDevice(l3->GetNetDevice(i));
     socket->Bind(InetSocketAddress(iface.GetBroadcast(), RAODV_PORT));
     socket->SetAllowBroadcast(true);
     socket->SetIpRecvTtl(true);
     m_socketSubnetBroadcastAddresses.insert(std::make_pair(socket, iface));
+    UpdateAddressCache();
 
     // Add local broadcast record to the routing table
     Ptr<NetDevice> dev = m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(iface.GetLocal()));
@@ -781,6 +1091,52 @@ RoutingProtocol::NotifyInterfaceUp(uint32_t i)
 
     mac->TraceConnectWithoutContext("DroppedMpdu",
                                     MakeCallback(&RoutingProtocol::NotifyTxError, this));
+    if ((m_rreqSuppression == SUPPRESSION_DISTANCE || m_linkBreakPrediction) && wifi->GetPhy())
+    {
+        wifi->GetPhy()->TraceConnectWithoutContext(
+            "MonitorSnifferRx",
+            MakeCallback(&RoutingProtocol::NotifyMonitorSnifferRx, this));
+    }
+}
+
+void
+RoutingProtocol::NotifyMonitorSnifferRx(Ptr<const Packet> packet,
+                                        uint16_t channelFreqMhz,
+                                        WifiTxVector txVector,
+                                        MpduInfo aMpdu,
+                                        SignalNoiseDbm signalNoise,
+                                        uint16_t staId)
+{
+    m_rxRssi.emplace_back(packet->GetUid(), signalNoise.signal);
+    if (m_rxRssi.size() > RX_RSSI_HISTORY)
+    {
+        m_rxRssi.pop_front();
+    }
+    // Every data frame a neighbor sends is a sample, including those overheard for other nodes.
+    // Only frames outside an A-MPDU are sampled: a single or aggregated MPDU starts with an
+    // A-MPDU subframe header instead of the MAC header.
+    if (m_linkBreakPrediction && aMpdu.type == NORMAL_MPDU)
+    {
+        WifiMacHeader hdr;
+        packet->PeekHeader(hdr);
+        if (hdr.IsData())
+        {
+            m_nb.UpdateRssi(hdr.GetAddr2(), signalNoise.signal);
+        }
+    }
+}
+
+double
+RoutingProtocol::GetRxRssi(Ptr<const Packet> packet) const
+{
+    for (auto i = m_rxRssi.rbegin(); i != m_rxRssi.rend(); ++i)
+    {
+        if (i->first == packet->GetUid())
+        {
+            return i->second;
+        }
+    }
+    return -std::numeric_limits<double>::infinity();
 }
 
 void
@@ -807,6 +1163,12 @@ RoutingProtocol::NotifyInterfaceDown(uint32_t i)
                                                MakeCallback(&RoutingProtocol::NotifyTxError, this));
             m_nb.DelArpCache(l3->GetInterface(i)->GetArpCache());
         }
+        if ((m_rreqSuppression == SUPPRESSION_DISTANCE || m_linkBreakPrediction) && wifi->GetPhy())
+        {
+            wifi->GetPhy()->TraceDisconnectWithoutContext(
+                "MonitorSnifferRx",
+                MakeCallback(&RoutingProtocol::NotifyMonitorSnifferRx, this));
+        }
     }
 
     // Close socket
@@ -820,6 +1182,7 @@ RoutingProtocol::NotifyInterfaceDown(uint32_t i)
     NS_ASSERT(socket);
     socket->Close();
     m_socketSubnetBroadcastAddresses.erase(socket);
+    UpdateAddressCache();
 
     if (m_socketAddresses.empty())
     {
@@ -855,7 +1218,7 @@ RoutingProtocol::NotifyAddAddress(uint32_t i, Ipv4InterfaceAddress address)
             Ptr<Socket> socket =
                 Socket::CreateSocket(GetObject<Node>(), UdpSocketFactory::GetTypeId());
             NS_ASSERT(socket);
-            socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this));
+            socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this).Bind(i));
             socket->BindToNetDevice(l3->GetNetDevice(i));
             socket->Bind(InetSocketAddress(iface.GetLocal(), RAODV_PORT));
             socket->SetAllowBroadcast(true);
@@ -864,12 +1227,13 @@ RoutingProtocol::NotifyAddAddress(uint32_t i, Ipv4InterfaceAddress address)
             // create also a subnet directed broadcast socket
             socket = Socket::CreateSocket(GetObject<Node>(), UdpSocketFactory::GetTypeId());
             NS_ASSERT(socket);
-            socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this));
+            socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this).Bind(i));
             socket->BindToNetDevice(l3->GetNetDevice(i));
             socket->Bind(InetSocketAddress(iface.GetBroadcast(), RAODV_PORT));
             socket->SetAllowBroadcast(true);
             socket->SetIpRecvTtl(true);
             m_socketSubnetBroadcastAddresses.insert(std::make_pair(socket, iface));
+            UpdateAddressCache();
 
             // Add local broadcast record to the routing table
             Ptr<NetDevice> dev =
@@ -907,8 +1271,9 @@ RoutingProtocol::NotifyRemoveAddress(uint32_t i, Ipv4InterfaceAddress address)
         if (unicastSocket)
         {
             unicastSocket->Close();
-            m_socketAddresses.erase(unicastSocket);
+            m_socketSubnetBroadcastAddresses.erase(unicastSocket);
         }
+        UpdateAddressCache();
 
         Ptr<Ipv4L3Protocol> l3 = m_ipv4->GetObject<Ipv4L3Protocol>();
         if (l3->GetNAddresses(i))
@@ -918,7 +1283,7 @@ RoutingProtocol::NotifyRemoveAddress(uint32_t i, Ipv4InterfaceAddress address)
             Ptr<Socket> socket =
                 Socket::CreateSocket(GetObject<Node>(), UdpSocketFactory::GetTypeId());
             NS_ASSERT(socket);
-            socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this));
+            socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this).Bind(i));
             // Bind to any IP address so that broadcasts can be received
             socket->BindToNetDevice(l3->GetNetDevice(i));
             socket->Bind(InetSocketAddress(iface.GetLocal(), RAODV_PORT));
@@ -929,12 +1294,13 @@ RoutingProtocol::NotifyRemoveAddress(uint32_t i, Ipv4InterfaceAddress address)
             // create also a unicast socket
             socket = Socket::CreateSocket(GetObject<Node>(), UdpSocketFactory::GetTypeId());
             NS_ASSERT(socket);
-            socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this));
+            socket->SetRecvCallback(MakeCallback(&RoutingProtocol::RecvRaodv, this).Bind(i));
             socket->BindToNetDevice(l3->GetNetDevice(i));
             socket->Bind(InetSocketAddress(iface.GetBroadcast(), RAODV_PORT));
             socket->SetAllowBroadcast(true);
             socket->SetIpRecvTtl(true);
             m_socketSubnetBroadcastAddresses.insert(std::make_pair(socket, iface));
+            UpdateAddressCache();
 
             // Add local broadcast record to the routing table
             Ptr<NetDevice> dev =
@@ -968,15 +1334,30 @@ bool
 RoutingProtocol::IsMyOwnAddress(Ipv4Address src)
 {
     NS_LOG_FUNCTION(this << src);
+    return m_localAddresses.find(src) != m_localAddresses.end();
+}
+
+void
+RoutingProtocol::UpdateAddressCache()
+{
+    NS_LOG_FUNCTION(this);
+    m_localAddresses.clear();
+    m_interfaceAddresses.clear();
     for (auto j = m_socketAddresses.begin(); j != m_socketAddresses.end(); ++j)
     {
         Ipv4InterfaceAddress iface = j->second;
-        if (src == iface.GetLocal())
+        m_localAddresses.insert(iface.GetLocal());
+        int32_t interface = m_ipv4->GetInterfaceForAddress(iface.GetLocal());
+        if (interface < 0)
         {
-            return true;
+            continue;
+        }
+        if (static_cast<uint32_t>(interface) >= m_interfaceAddresses.size())
+        {
+            m_interfaceAddresses.resize(interface + 1);
         }
+        m_interfaceAddresses[interface] = iface;
     }
-    return false;
 }
 
 Ptr<Ipv4Route>
@@ -1032,18 +1413,31 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
     // A node SHOULD NOT originate more than RREQ_RATELIMIT RREQ messages per second.
-    if (m_rreqCount == m_rreqRateLimit)
+    if (m_rateLimitedRreqDsts.find(dst) != m_rateLimitedRreqDsts.end())
     {
-        Simulator::Schedule(m_rreqRateLimitTimer.GetDelayLeft() + MicroSeconds(100),
-                            &RoutingProtocol::SendRequest,
-                            this,
-                            dst);
+        NS_LOG_LOGIC("RREQ to " << dst << " is already waiting for the rate limit");
         return;
     }
-    else
+    if (!m_rateLimitedRreqs.empty() || !m_rreqBucket.Consume())
     {
-        m_rreqCount++;
+        NS_LOG_LOGIC("RreqRateLimit reached at " << Simulator::Now().As(Time::S)
+                                                 << "; queue RREQ to " << dst);
+        m_rateLimitedRreqs.push_back(dst);
+        m_rateLimitedRreqDsts.insert(dst);
+        if (!m_rreqRateLimitTimer.IsRunning() && m_rreqBucket.GetRate() != 0)
+        {
+            m_timerWheel.Schedule(m_rreqRateLimitTimer, m_rreqBucket.GetDelay());
+        }
+        return;
     }
+    OriginateRequest(dst);
+    ScheduleRreqRetry(dst);
+}
+
+void
+RoutingProtocol::OriginateRequest(Ipv4Address dst)
+{
+    NS_LOG_FUNCTION(this << dst);
     // Create RREQ header
     RreqHeader rreqHeader;
     rreqHeader.SetDst(dst);
@@ -1053,19 +1447,20 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
     uint16_t ttl = m_ttlStart;
     if (m_routingTable.LookupRoute(dst, rt))//if dst matches,copy the entire row in rt
     {
+        uint16_t diameter = GetDiscoveryDiameter(rt.GetRreqCnt());
         if (rt.GetFlag() != IN_SEARCH)
         {
-            ttl = std::min<uint16_t>(rt.GetHop() + m_ttlIncrement, m_netDiameter);
+            ttl = std::min<uint16_t>(rt.GetHop() + m_ttlIncrement, diameter);
         }
         else
         {
             ttl = rt.GetHop() + m_ttlIncrement;
-            if (ttl > m_ttlThreshold)
+            if (ttl > m_ttlThreshold || ttl > diameter)
             {
-                ttl = m_netDiameter;
+                ttl = diameter;
             }
         }
-        if (ttl == m_netDiameter)
+        if (ttl == diameter)
         {
             rt.IncrementRreqCnt();
         }
@@ -1084,6 +1479,13 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
     }
     else
     {
+        uint16_t diameter = GetDiscoveryDiameter(0);
+        auto history = m_hopHistory.find(dst);
+        if (history != m_hopHistory.end())
+        {
+            ttl = history->second + m_ttlIncrement;
+        }
+        ttl = std::min(ttl, diameter);
         rreqHeader.SetUnknownSeqno(true);
         Ptr<NetDevice> dev = nullptr;
         RoutingTableEntry newEntry(/*dev=*/dev,
@@ -1095,13 +1497,21 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
                                    /*nextHop=*/Ipv4Address(),
                                    /*lifetime=*/m_pathDiscoveryTime);
         // Check if TtlStart == NetDiameter
-        if (ttl == m_netDiameter)
+        if (ttl == diameter)
         {
             newEntry.IncrementRreqCnt();
         }
         newEntry.SetFlag(IN_SEARCH);
         m_routingTable.AddRoute(newEntry);
     }
+    // The request zone covers the expanding ring and the first network wide attempt, the
+    // retries flood the whole network in case the target left its expected zone.
+    m_routingTable.LookupRoute(dst, rt);
+    Ptr<Packet> extension = CreateLocationExtension(dst, rt.GetRreqCnt() <= 1);
+    if (m_pathLoad != LOAD_NONE)
+    {
+        extension = AddLoadExtension(extension, 0);
+    }
 
     if (m_gratuitousReply)
     {
@@ -1116,6 +1526,10 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
     rreqHeader.SetOriginSeqno(m_seqNo);
     m_requestId++;
     rreqHeader.SetId(m_requestId);
+    if (m_adaptiveDiscovery)
+    {
+        m_discoveryAttempts[dst] = std::make_pair(m_requestId, Simulator::Now());
+    }
 
     // Send RREQ as subnet directed broadcast from each interface used by raodv
     for (auto j = m_socketAddresses.begin(); j != m_socketAddresses.end(); ++j)
@@ -1126,13 +1540,11 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
         rreqHeader.SetOrigin(iface.GetLocal());
         m_rreqIdCache.IsDuplicate(iface.GetLocal(), m_requestId);
 
-        Ptr<Packet> packet = Create<Packet>();
+        Ptr<Packet> packet = extension ? extension->Copy() : Create<Packet>();
         SocketIpTtlTag tag;
         tag.SetTtl(ttl);
         packet->AddPacketTag(tag);
-        packet->AddHeader(rreqHeader);
-        TypeHeader tHeader(RAODVTYPE_RREQ);
-        packet->AddHeader(tHeader);
+        AddRequestHeaders(packet, rreqHeader, iface.GetLocal());
         // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
         Ipv4Address destination;
         if (iface.GetMask() == Ipv4Mask::GetOnes())
@@ -1145,92 +1557,355 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
         }
         NS_LOG_DEBUG("Send RREQ with id " << rreqHeader.GetId() << " to socket");
         m_lastBcastTime = Simulator::Now();
-        Simulator::Schedule(Time(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10))),
-                            &RoutingProtocol::SendTo,
-                            this,
-                            socket,
-                            packet,
-                            destination);
+        ScheduleBroadcast(socket, packet, destination);
     }
-    ScheduleRreqRetry(dst);
+}
+
+bool
+RoutingProtocol::StartLocalRepair(Ipv4Address dst)
+{
+    NS_LOG_FUNCTION(this << dst);
+    if (!m_rateLimitedRreqs.empty() || !m_rreqBucket.Consume())
+    {
+        NS_LOG_LOGIC("RreqRateLimit reached, no local repair for " << dst);
+        TraceDrop(RAODVTYPE_RREQ, DROP_RATE_LIMIT, dst);
+        return false;
+    }
+    // RFC 3561 6.12: increment the destination sequence number before the repair RREQ, so that
+    // no node can answer with the route that just broke
+    RoutingTableEntry toDst;
+    if (m_routingTable.LookupRoute(dst, toDst))
+    {
+        toDst.SetSeqNo(toDst.GetSeqNo() + 1);
+        toDst.SetValidSeqNo(true);
+        m_routingTable.Update(toDst);
+    }
+    OriginateRequest(dst);
+    auto timer = m_localRepairTimer.try_emplace(dst);
+    if (timer.second)
+    {
+        timer.first->second.SetFunction(
+            MakeCallback(&RoutingProtocol::LocalRepairTimerExpire, this).Bind(dst));
+    }
+    Time timeout = m_localRepairTimeout;
+    if (timeout.IsZero())
+    {
+        RoutingTableEntry rt;
+        m_routingTable.LookupRoute(dst, rt);
+        timeout = 2 * m_nodeTraversalTime * (rt.GetHop() + m_timeoutBuffer);
+    }
+    m_timerWheel.Schedule(timer.first->second, timeout);
+    NS_LOG_LOGIC("Local repair of route to " << dst << " for " << timeout.As(Time::S));
+    return true;
+}
+
+void
+RoutingProtocol::TraceTx(MessageType type, Ipv4Address destination)
+{
+    m_stats.CountTx(type);
+    m_txTrace(type, destination);
+}
+
+void
+RoutingProtocol::TraceRx(MessageType type, Ipv4Address sender)
+{
+    m_stats.CountRx(type);
+    m_rxTrace(type, sender);
+}
+
+void
+RoutingProtocol::TraceSuppressed(MessageType type, Ipv4Address origin)
+{
+    m_stats.CountSuppressed(type);
+    m_suppressTrace(type, origin);
+}
+
+void
+RoutingProtocol::TraceDrop(MessageType type, DropReason reason, Ipv4Address address)
+{
+    m_stats.CountDropped(type, reason);
+    m_dropTrace(type, reason, address);
+}
+
+void
+RoutingProtocol::EndDiscovery(Ipv4Address dst, bool success)
+{
+    auto start = m_discoveryStart.find(dst);
+    if (start == m_discoveryStart.end())
+    {
+        return;
+    }
+    Time latency = Simulator::Now() - start->second;
+    m_discoveryStart.erase(start);
+    NS_LOG_LOGIC("Discovery of " << dst << (success ? " succeeded" : " failed") << " after "
+                                 << latency.As(Time::MS));
+    m_stats.CountDiscovery(latency, success);
+    m_discoveryTrace(dst, latency, success);
 }
 
 void
 RoutingProtocol::SendTo(Ptr<Socket> socket, Ptr<Packet> packet, Ipv4Address destination)
 {
+    TypeHeader tHeader;
+    packet->PeekHeader(tHeader);
+    TraceTx(tHeader.Get(), destination);
+    m_txControlTrace(packet);
     socket->SendTo(packet, 0, InetSocketAddress(destination, RAODV_PORT));
 }
 
+void
+RoutingProtocol::ScheduleBroadcast(Ptr<Socket> socket, Ptr<Packet> packet, Ipv4Address destination)
+{
+    ScheduleBroadcast(socket,
+                      packet,
+                      destination,
+                      Time(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10))));
+}
+
+void
+RoutingProtocol::ScheduleBroadcast(Ptr<Socket> socket,
+                                   Ptr<Packet> packet,
+                                   Ipv4Address destination,
+                                   Time jitter)
+{
+    if (!m_enableCoalescing || !m_nb.AllCapable(Neighbors::COALESCING))
+    {
+        Simulator::Schedule(jitter, &RoutingProtocol::SendTo, this, socket, packet, destination);
+        return;
+    }
+    // Join the batch already waiting on this interface, or open a new one
+    PendingBroadcast& pending = m_pendingBroadcasts[socket];
+    pending.m_packets.push_back(packet);
+    pending.m_destination = destination;
+    if (!pending.m_flush.IsPending())
+    {
+        pending.m_flush =
+            Simulator::Schedule(jitter, &RoutingProtocol::FlushBroadcasts, this, socket);
+    }
+}
+
+void
+RoutingProtocol::FlushBroadcasts(Ptr<Socket> socket)
+{
+    auto pending = m_pendingBroadcasts.find(socket);
+    if (pending == m_pendingBroadcasts.end())
+    {
+        return;
+    }
+    std::vector<Ptr<Packet>> packets;
+    packets.swap(pending->second.m_packets);
+    Ipv4Address destination = pending->second.m_destination;
+    m_pendingBroadcasts.erase(pending);
+    if (m_socketAddresses.find(socket) == m_socketAddresses.end())
+    {
+        NS_LOG_LOGIC("Interface closed, drop " << packets.size() << " pending control messages");
+        return;
+    }
+    if (packets.size() == 1)
+    {
+        SendTo(socket, packets.front(), destination);
+        return;
+    }
+
+    NS_LOG_LOGIC("Coalesce " << packets.size() << " control messages to " << destination);
+    TypeHeader tHeader(RAODVTYPE_AGGREGATE);
+    Ptr<Packet> aggregate;
+    for (auto i = packets.begin(); i != packets.end(); ++i)
+    {
+        Ptr<Packet> record = *i;
+        TypeHeader recordType;
+        record->PeekHeader(recordType);
+        TraceTx(recordType.Get(), destination);
+        SocketIpTtlTag tag;
+        record->RemovePacketTag(tag);
+        AggregateRecordHeader recordHeader(tag.GetTtl(), record->GetSize());
+        record->AddHeader(recordHeader);
+        if (aggregate && tHeader.GetSerializedSize() + aggregate->GetSize() + record->GetSize() >
+                             MAX_AGGREGATE_SIZE)
+        {
+            SendAggregate(socket, aggregate, destination);
+            aggregate = nullptr;
+        }
+        if (!aggregate)
+        {
+            aggregate = Create<Packet>();
+        }
+        aggregate->AddAtEnd(record);
+    }
+    SendAggregate(socket, aggregate, destination);
+}
+
+void
+RoutingProtocol::SendAggregate(Ptr<Socket> socket, Ptr<Packet> aggregate, Ipv4Address destination)
+{
+    // Records carry their own TTL; the datagram itself only crosses one hop
+    SocketIpTtlTag tag;
+    tag.SetTtl(1);
+    aggregate->AddPacketTag(tag);
+    TypeHeader tHeader(RAODVTYPE_AGGREGATE);
+    aggregate->AddHeader(tHeader);
+    SendTo(socket, aggregate, destination);
+}
+
+void
+RoutingProtocol::AddRequestHeaders(Ptr<Packet> packet,
+                                   const RreqHeader& rreqHeader,
+                                   Ipv4Address ipSrc)
+{
+    if (m_enableCompactHeaders && m_nb.AllCapable(Neighbors::COMPACT_RREQ))
+    {
+        packet->AddHeader(CompactRreqHeader(rreqHeader, ipSrc));
+        packet->AddHeader(TypeHeader(RAODVTYPE_RREQ_COMPACT));
+        return;
+    }
+    packet->AddHeader(rreqHeader);
+    packet->AddHeader(TypeHeader(RAODVTYPE_RREQ));
+}
+
+void
+RoutingProtocol::AddRevRequestHeaders(Ptr<Packet> packet,
+                                      const RevRreqHeader& revRreqHeader,
+                                      Ipv4Address ipSrc)
+{
+    if (m_enableCompactHeaders && m_nb.AllCapable(Neighbors::COMPACT_RREQ))
+    {
+        packet->AddHeader(CompactRreqHeader(revRreqHeader, ipSrc));
+        packet->AddHeader(TypeHeader(RAODVTYPE_REVREQUEST_COMPACT));
+        return;
+    }
+    packet->AddHeader(revRreqHeader);
+    packet->AddHeader(TypeHeader(RAODVTYPE_REVREQUEST));
+}
+
 void
 RoutingProtocol::ScheduleRreqRetry(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
-    if (m_addressReqTimer.find(dst) == m_addressReqTimer.end())
+    auto timer = m_addressReqTimer.try_emplace(dst);
+    if (timer.second)
     {
-        Timer timer(Timer::CANCEL_ON_DESTROY);
-        m_addressReqTimer[dst] = timer;
+        timer.first->second.SetFunction(
+            MakeCallback(&RoutingProtocol::RouteRequestTimerExpire, this).Bind(dst));
     }
-    m_addressReqTimer[dst].SetFunction(&RoutingProtocol::RouteRequestTimerExpire, this);
-    m_addressReqTimer[dst].Cancel();
-    m_addressReqTimer[dst].SetArguments(dst);
     RoutingTableEntry rt;
     m_routingTable.LookupRoute(dst, rt);
     Time retry;
-    if (rt.GetHop() < m_netDiameter)
+    // The RREQ count only grows once the search reached the network diameter
+    if (rt.GetRreqCnt() == 0)
     {
-        retry = 2 * m_nodeTraversalTime * (rt.GetHop() + m_timeoutBuffer);
+        retry = 2 * GetNodeTraversalEstimate() * (rt.GetHop() + m_timeoutBuffer);
     }
     else
     {
-        NS_ABORT_MSG_UNLESS(rt.GetRreqCnt() > 0, "Unexpected value for GetRreqCount ()");
         uint16_t backoffFactor = rt.GetRreqCnt() - 1;
         NS_LOG_LOGIC("Applying binary exponential backoff factor " << backoffFactor);
-        retry = m_netTraversalTime * (1 << backoffFactor);
+        Time netTraversal = m_adaptiveDiscovery
+                                ? 2 * GetNodeTraversalEstimate() * (rt.GetHop() + m_timeoutBuffer)
+                                : m_netTraversalTime;
+        retry = netTraversal * (1 << backoffFactor);
     }
-    m_addressReqTimer[dst].Schedule(retry);
+    m_timerWheel.Schedule(timer.first->second, retry);
     NS_LOG_LOGIC("Scheduled RREQ retry in " << retry.As(Time::S));
 }
 
 void
-RoutingProtocol::RecvRaodv(Ptr<Socket> socket)
+RoutingProtocol::ObserveHopCount(Ipv4Address dst, uint16_t hops)
 {
-    NS_LOG_FUNCTION(this << socket);
-    Address sourceAddress;
-    Ptr<Packet> packet = socket->RecvFrom(sourceAddress);
-    InetSocketAddress inetSourceAddr = InetSocketAddress::ConvertFrom(sourceAddress);
-    Ipv4Address sender = inetSourceAddr.GetIpv4();
-    Ipv4Address receiver;
+    if (!m_adaptiveDiscovery)
+    {
+        return;
+    }
+    m_hopHistory[dst] = hops;
+    // Follow a longer path at once, decay slowly towards shorter ones so the estimate stays
+    // close to the longest paths seen lately
+    m_diameterEstimate = std::max<double>(hops, 0.95 * m_diameterEstimate + 0.05 * hops);
+}
 
-    if (m_socketAddresses.find(socket) != m_socketAddresses.end())
+void
+RoutingProtocol::ObserveDiscovery(Ipv4Address dst, uint32_t id, uint16_t hops)
+{
+    auto attempt = m_discoveryAttempts.find(dst);
+    if (attempt == m_discoveryAttempts.end() || attempt->second.first != id || hops == 0)
     {
-        receiver = m_socketAddresses[socket].GetLocal();
+        // The answer to an earlier attempt would overestimate the latency
+        return;
     }
-    else if (m_socketSubnetBroadcastAddresses.find(socket) !=
-             m_socketSubnetBroadcastAddresses.end())
+    // The RREQ and the reverse request each travelled the route once
+    Time sample = (Simulator::Now() - attempt->second.second) / (2 * hops);
+    m_discoveryAttempts.erase(attempt);
+    if (m_hopLatency.IsZero())
     {
-        receiver = m_socketSubnetBroadcastAddresses[socket].GetLocal();
+        m_hopLatency = sample;
+        m_hopLatencyVar = sample / 2;
     }
     else
     {
-        NS_ASSERT_MSG(false, "Received a packet from an unknown socket");
+        // Smoothed as the TCP round trip time estimator (RFC 6298)
+        m_hopLatencyVar = (3 * m_hopLatencyVar + Abs(m_hopLatency - sample)) / 4;
+        m_hopLatency = (7 * m_hopLatency + sample) / 8;
     }
-    NS_LOG_DEBUG("raodv node " << this << " received a raodv packet from " << sender << " to "
-                              << receiver);
+    NS_LOG_LOGIC("Per hop latency " << m_hopLatency.As(Time::MS) << " variation "
+                                    << m_hopLatencyVar.As(Time::MS));
+}
 
-    UpdateRouteToNeighbor(sender, receiver);
-    TypeHeader tHeader(RAODVTYPE_RREQ);
-    packet->RemoveHeader(tHeader);//remove
-    if (!tHeader.IsValid())
+uint16_t
+RoutingProtocol::GetDiscoveryDiameter(uint32_t rreqCnt) const
+{
+    // The retries cover the whole network in case the estimate missed a longer path
+    if (!m_adaptiveDiscovery || rreqCnt > 0 || m_diameterEstimate == 0)
     {
-        NS_LOG_DEBUG("raodv message " << packet->GetUid() << " with unknown type received: "
-                                     << tHeader.Get() << ". Drop");
-        return; // drop
+        return m_netDiameter;
     }
-    switch (tHeader.Get())
+    uint32_t diameter = static_cast<uint32_t>(std::ceil(m_diameterEstimate)) + m_ttlIncrement;
+    return std::min<uint32_t>(std::max<uint32_t>(diameter, m_ttlStart), m_netDiameter);
+}
+
+Time
+RoutingProtocol::GetNodeTraversalEstimate() const
+{
+    if (!m_adaptiveDiscovery || m_hopLatency.IsZero())
     {
-    case RAODVTYPE_RREQ: {
-        RecvRequest(packet, receiver, sender);
-        break;
+        return m_nodeTraversalTime;
+    }
+    return m_hopLatency + 4 * m_hopLatencyVar;
+}
+
+void
+RoutingProtocol::RecvRaodv(uint32_t interface, Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << interface << socket);
+    Address sourceAddress;
+    Ptr<Packet> packet = socket->RecvFrom(sourceAddress);
+    InetSocketAddress inetSourceAddr = InetSocketAddress::ConvertFrom(sourceAddress);
+    Ipv4Address sender = inetSourceAddr.GetIpv4();
+    NS_ASSERT_MSG(interface < m_interfaceAddresses.size() &&
+                      m_interfaceAddresses[interface].GetLocal() != Ipv4Address(),
+                  "Received a packet from an unknown socket");
+    Ipv4Address receiver = m_interfaceAddresses[interface].GetLocal();
+    NS_LOG_DEBUG("raodv node " << this << " received a raodv packet from " << sender << " to "
+                              << receiver);
+
+    UpdateRouteToNeighbor(sender, receiver);
+    DispatchRaodv(packet, receiver, sender);
+}
+
+void
+RoutingProtocol::DispatchRaodv(Ptr<Packet> packet, Ipv4Address receiver, Ipv4Address sender)
+{
+    TypeHeader tHeader(RAODVTYPE_RREQ);
+    packet->RemoveHeader(tHeader);//remove
+    if (!tHeader.IsValid())
+    {
+        NS_LOG_DEBUG("raodv message " << packet->GetUid() << " with unknown type received: "
+                                     << tHeader.Get() << ". Drop");
+        return; // drop
+    }
+    TraceRx(tHeader.Get(), sender);
+    switch (tHeader.Get())
+    {
+    case RAODVTYPE_RREQ: {
+        RecvRequest(packet, receiver, sender);
+        break;
     }
     case RAODVTYPE_RREP: {
         RecvReply(packet, receiver, sender);
@@ -1248,6 +1923,57 @@ RoutingProtocol::RecvRaodv(Ptr<Socket> socket)
         RecvRevRequest(packet, receiver, sender);
         break;
     }
+    case RAODVTYPE_RREQ_COMPACT: {
+        CompactRreqHeader compactHeader(sender);
+        packet->RemoveHeader(compactHeader);
+        packet->AddHeader(compactHeader.GetRreqHeader());
+        RecvRequest(packet, receiver, sender);
+        break;
+    }
+    case RAODVTYPE_RREQ_REFRESH: {
+        RecvRefreshRequest(packet, receiver, sender);
+        break;
+    }
+    case RAODVTYPE_REVREQUEST_COMPACT: {
+        CompactRreqHeader compactHeader(sender);
+        packet->RemoveHeader(compactHeader);
+        packet->AddHeader(compactHeader.GetRevRreqHeader());
+        RecvRevRequest(packet, receiver, sender);
+        break;
+    }
+    case RAODVTYPE_AGGREGATE: {
+        AggregateRecordHeader recordHeader;
+        while (packet->GetSize() >= recordHeader.GetSerializedSize())
+        {
+            packet->RemoveHeader(recordHeader);
+            if (recordHeader.GetLength() > packet->GetSize())
+            {
+                NS_LOG_DEBUG("Truncated aggregate record from " << sender << ". Drop");
+                return;
+            }
+            if (recordHeader.GetLength() == 0)
+            {
+                NS_LOG_DEBUG("Empty aggregate record from " << sender << ". Drop");
+                continue;
+            }
+            Ptr<Packet> record = packet->CreateFragment(0, recordHeader.GetLength());
+            packet->RemoveAtStart(recordHeader.GetLength());
+            TypeHeader recordType;
+            record->PeekHeader(recordType);
+            if (recordType.Get() == RAODVTYPE_AGGREGATE)
+            {
+                NS_LOG_DEBUG("Nested aggregate from " << sender << ". Drop");
+                continue;
+            }
+            // The fragment carries the TTL tag of the datagram; the record has its own
+            SocketIpTtlTag tag;
+            record->RemovePacketTag(tag);
+            tag.SetTtl(recordHeader.GetTtl());
+            record->AddPacketTag(tag);
+            DispatchRaodv(record, receiver, sender);
+        }
+        break;
+    }
     }
 }
 
@@ -1528,6 +2254,7 @@ RoutingProtocol::UpdateRouteToNeighbor(Ipv4Address sender, Ipv4Address receiver)
 void
 RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src)
 {
+    RAODV_PROFILE_SCOPE("RecvRequest");
     NS_LOG_FUNCTION(this);
     RreqHeader rreqHeader;
     p->RemoveHeader(rreqHeader);
@@ -1539,9 +2266,17 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
         if (toPrev.IsUnidirectional())
         {
             NS_LOG_DEBUG("Ignoring RREQ from node in blacklist");
+            TraceDrop(RAODVTYPE_RREQ, DROP_BLACKLIST, src);
             return;
         }
     }
+    // and builds no new route over a link that is about to break
+    if (m_linkBreakPrediction && m_nb.IsLinkBreaking(src))
+    {
+        NS_LOG_DEBUG("Ignoring RREQ over breaking link from " << src);
+        TraceDrop(RAODVTYPE_RREQ, DROP_BLACKLIST, src);
+        return;
+    }
 
     uint32_t id = rreqHeader.GetId();
     Ipv4Address origin = rreqHeader.GetOrigin();
@@ -1554,62 +2289,25 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
     if (m_rreqIdCache.IsDuplicate(origin, id))
     {
         NS_LOG_DEBUG("Ignoring RREQ due to duplicate");
+        TraceDrop(RAODVTYPE_RREQ, DROP_DUPLICATE, src);
+        SuppressRequestForward(origin, id, GetRxRssi(p));
+        if (m_pathLoad != LOAD_NONE && IsMyOwnAddress(rreqHeader.GetDst()))
+        {
+            SelectReverseRoute(p, rreqHeader, receiver, src);
+        }
         return;
     }
 
+    uint32_t load = 0;
+    bool hasLoad = ReadLoadExtension(p, load);
+    Ptr<Packet> extension = ReadLocationExtension(p, origin);
+
     // Increment RREQ hop count
     uint8_t hop = rreqHeader.GetHopCount() + 1;
     rreqHeader.SetHopCount(hop);
+    ObserveHopCount(origin, hop);
 
-    /*
-     *  When the reverse route is created or updated, the following actions on the route are also
-     * carried out:
-     *  1. the Originator Sequence Number from the RREQ is compared to the corresponding destination
-     * sequence number in the route table entry and copied if greater than the existing value there
-     *  2. the valid sequence number field is set to true;
-     *  3. the next hop in the routing table becomes the node from which the  RREQ was received
-     *  4. the hop count is copied from the Hop Count in the RREQ message;
-     *  5. the Lifetime is set to be the maximum of (ExistingLifetime, MinimalLifetime), where
-     *     MinimalLifetime = current time + 2*NetTraversalTime - 2*HopCount*NodeTraversalTime
-     */
-    RoutingTableEntry toOrigin;
-    if (!m_routingTable.LookupRoute(origin, toOrigin))
-    {
-        Ptr<NetDevice> dev = m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(receiver));
-        RoutingTableEntry newEntry(
-            /*dev=*/dev,
-            /*dst=*/origin,
-            /*vSeqNo=*/true,
-            /*seqNo=*/rreqHeader.GetOriginSeqno(),
-            /*iface=*/m_ipv4->GetAddress(m_ipv4->GetInterfaceForAddress(receiver), 0),
-            /*hops=*/hop,
-            /*nextHop=*/src,
-            /*lifetime=*/Time(2 * m_netTraversalTime - 2 * hop * m_nodeTraversalTime));
-        m_routingTable.AddRoute(newEntry);
-    }
-    else
-    {
-        if (toOrigin.GetValidSeqNo())
-        {
-            if (int32_t(rreqHeader.GetOriginSeqno()) - int32_t(toOrigin.GetSeqNo()) > 0)
-            {
-                toOrigin.SetSeqNo(rreqHeader.GetOriginSeqno());
-            }
-        }
-        else
-        {
-            toOrigin.SetSeqNo(rreqHeader.GetOriginSeqno());
-        }
-        toOrigin.SetValidSeqNo(true);
-        toOrigin.SetNextHop(src);
-        toOrigin.SetOutputDevice(m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(receiver)));
-        toOrigin.SetInterface(m_ipv4->GetAddress(m_ipv4->GetInterfaceForAddress(receiver), 0));
-        toOrigin.SetHop(hop);
-        toOrigin.SetLifeTime(std::max(Time(2 * m_netTraversalTime - 2 * hop * m_nodeTraversalTime),
-                                      toOrigin.GetLifeTime()));
-        m_routingTable.Update(toOrigin);
-        // m_nb.Update (src, Time (AllowedHelloLoss * HelloInterval));
-    }
+    UpdateReverseRoute(rreqHeader, receiver, src, load);
 
     RoutingTableEntry toNeighbor;
     if (!m_routingTable.LookupRoute(src, toNeighbor))
@@ -1648,8 +2346,13 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
     //  (i)  it is itself the destination,
     if (IsMyOwnAddress(rreqHeader.GetDst()))
     {
+        RoutingTableEntry toOrigin;
         m_routingTable.LookupRoute(origin, toOrigin);
         NS_LOG_DEBUG("Send reply since I am the destination");
+        if (m_pathLoad != LOAD_NONE)
+        {
+            m_reverseSelections[origin] = std::make_pair(id, Simulator::Now() + m_pathLoadWindow);
+        }
         SendReplytoAll(rreqHeader, toOrigin);
         return;
     }
@@ -1684,6 +2387,7 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
         {
             if (!rreqHeader.GetDestinationOnly() && toDst.GetFlag() == VALID)
             {
+                RoutingTableEntry toOrigin;
                 m_routingTable.LookupRoute(origin, toOrigin);
                 //SendReplyByIntermediateNode(toDst, toOrigin, rreqHeader.GetGratuitousRrep());
                 return;
@@ -1693,26 +2397,174 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
         }
     }
 
+    if (!IsInRequestZone(extension))
+    {
+        NS_LOG_DEBUG("Outside the request zone. Drop RREQ origin " << origin << " destination "
+                                                                   << dst);
+        TraceSuppressed(RAODVTYPE_RREQ, origin);
+        return;
+    }
+
     SocketIpTtlTag tag;
     p->RemovePacketTag(tag);
     if (tag.GetTtl() < 2)
     {
         NS_LOG_DEBUG("TTL exceeded. Drop RREQ origin " << src << " destination " << dst);
+        TraceDrop(RAODVTYPE_RREQ, DROP_TTL, src);
+        return;
+    }
+    if (hasLoad)
+    {
+        extension = AddLoadExtension(extension, AccumulateLoad(load));
+    }
+
+    if (m_rreqSuppression != SUPPRESSION_NONE)
+    {
+        ScheduleRequestForward(rreqHeader, tag.GetTtl() - 1, GetRxRssi(p), extension);
+        return;
+    }
+    ForwardRequest(rreqHeader, tag.GetTtl() - 1, true, extension);
+}
+
+void
+RoutingProtocol::UpdateReverseRoute(const RreqHeader& rreqHeader,
+                                    Ipv4Address receiver,
+                                    Ipv4Address src,
+                                    uint32_t load)
+{
+    Ipv4Address origin = rreqHeader.GetOrigin();
+    uint8_t hop = rreqHeader.GetHopCount();
+    /*
+     *  When the reverse route is created or updated, the following actions on the route are also
+     * carried out:
+     *  1. the Originator Sequence Number from the RREQ is compared to the corresponding destination
+     * sequence number in the route table entry and copied if greater than the existing value there
+     *  2. the valid sequence number field is set to true;
+     *  3. the next hop in the routing table becomes the node from which the  RREQ was received
+     *  4. the hop count is copied from the Hop Count in the RREQ message;
+     *  5. the Lifetime is set to be the maximum of (ExistingLifetime, MinimalLifetime), where
+     *     MinimalLifetime = current time + 2*NetTraversalTime - 2*HopCount*NodeTraversalTime
+     */
+    RoutingTableEntry toOrigin;
+    if (!m_routingTable.LookupRoute(origin, toOrigin))
+    {
+        Ptr<NetDevice> dev = m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(receiver));
+        RoutingTableEntry newEntry(
+            /*dev=*/dev,
+            /*dst=*/origin,
+            /*vSeqNo=*/true,
+            /*seqNo=*/rreqHeader.GetOriginSeqno(),
+            /*iface=*/m_ipv4->GetAddress(m_ipv4->GetInterfaceForAddress(receiver), 0),
+            /*hops=*/hop,
+            /*nextHop=*/src,
+            /*lifetime=*/Time(2 * m_netTraversalTime - 2 * hop * m_nodeTraversalTime));
+        newEntry.SetPathLoad(load);
+        m_routingTable.AddRoute(newEntry);
+    }
+    else
+    {
+        if (toOrigin.GetValidSeqNo())
+        {
+            if (int32_t(rreqHeader.GetOriginSeqno()) - int32_t(toOrigin.GetSeqNo()) > 0)
+            {
+                toOrigin.SetSeqNo(rreqHeader.GetOriginSeqno());
+            }
+        }
+        else
+        {
+            toOrigin.SetSeqNo(rreqHeader.GetOriginSeqno());
+        }
+        toOrigin.SetValidSeqNo(true);
+        toOrigin.SetNextHop(src);
+        toOrigin.SetOutputDevice(m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(receiver)));
+        toOrigin.SetInterface(m_ipv4->GetAddress(m_ipv4->GetInterfaceForAddress(receiver), 0));
+        toOrigin.SetHop(hop);
+        toOrigin.SetPathLoad(load);
+        toOrigin.SetLifeTime(std::max(Time(2 * m_netTraversalTime - 2 * hop * m_nodeTraversalTime),
+                                      toOrigin.GetLifeTime()));
+        m_routingTable.Update(toOrigin);
+        // m_nb.Update (src, Time (AllowedHelloLoss * HelloInterval));
+    }
+}
+
+void
+RoutingProtocol::RecvRefreshRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src)
+{
+    RAODV_PROFILE_SCOPE("RecvRefreshRequest");
+    NS_LOG_FUNCTION(this << src);
+    RreqHeader rreqHeader;
+    p->RemoveHeader(rreqHeader);
+    Ipv4Address origin = rreqHeader.GetOrigin();
+    Ipv4Address dst = rreqHeader.GetDst();
+    if (m_rreqIdCache.IsDuplicate(origin, rreqHeader.GetId()))
+    {
+        NS_LOG_DEBUG("Ignoring refresh RREQ due to duplicate");
+        TraceDrop(RAODVTYPE_RREQ_REFRESH, DROP_DUPLICATE, src);
+        return;
+    }
+    rreqHeader.SetHopCount(rreqHeader.GetHopCount() + 1);
+    UpdateReverseRoute(rreqHeader, receiver, src, 0);
+
+    // The destination answers with a RREP along the reverse route, which refreshes the route on
+    // every hop back to the originator
+    if (IsMyOwnAddress(dst))
+    {
+        RoutingTableEntry toOrigin;
+        m_routingTable.LookupRoute(origin, toOrigin);
+        NS_LOG_DEBUG("Send reply to refresh RREQ from " << origin);
+        SendReply(rreqHeader, toOrigin);
+        return;
+    }
+
+    RoutingTableEntry toDst;
+    SocketIpTtlTag tag;
+    p->RemovePacketTag(tag);
+    if (!m_routingTable.LookupValidRoute(dst, toDst) || toDst.GetNextHop() == src)
+    {
+        NS_LOG_DEBUG("No route, drop refresh RREQ origin " << origin << " destination " << dst);
+        TraceDrop(RAODVTYPE_RREQ_REFRESH, DROP_NO_ROUTE, src);
         return;
     }
+    if (tag.GetTtl() < 2)
+    {
+        NS_LOG_DEBUG("TTL exceeded. Drop refresh RREQ origin " << origin << " destination "
+                                                               << dst);
+        TraceDrop(RAODVTYPE_RREQ_REFRESH, DROP_TTL, src);
+        return;
+    }
+    // A next hop that did not advertise the refresh in its hellos would drop the unknown type
+    if (!m_nb.IsCapable(toDst.GetNextHop(), Neighbors::ROUTE_REFRESH))
+    {
+        NS_LOG_DEBUG("Next hop " << toDst.GetNextHop() << " does not refresh, drop refresh RREQ");
+        TraceDrop(RAODVTYPE_RREQ_REFRESH, DROP_NO_ROUTE, src);
+        return;
+    }
+    Ptr<Packet> packet = Create<Packet>();
+    SocketIpTtlTag ttl;
+    ttl.SetTtl(tag.GetTtl() - 1);
+    packet->AddPacketTag(ttl);
+    packet->AddHeader(rreqHeader);
+    packet->AddHeader(TypeHeader(RAODVTYPE_RREQ_REFRESH));
+    Ptr<Socket> socket = FindSocketWithInterfaceAddress(toDst.GetInterface());
+    NS_ASSERT(socket);
+    SendTo(socket, packet, toDst.GetNextHop());
+}
 
+void
+RoutingProtocol::ForwardRequest(const RreqHeader& rreqHeader,
+                                uint8_t ttl,
+                                bool jitter,
+                                Ptr<const Packet> extensions)
+{
     for (auto j = m_socketAddresses.begin(); j != m_socketAddresses.end(); ++j)
     {
         Ptr<Socket> socket = j->first;
         Ipv4InterfaceAddress iface = j->second;
-        Ptr<Packet> packet = Create<Packet>();
-        SocketIpTtlTag ttl;
-        ttl.SetTtl(tag.GetTtl() - 1);
-        packet->AddPacketTag(ttl);
-        packet->AddHeader(rreqHeader);
-        TypeHeader tHeader(RAODVTYPE_RREQ);
-
-        packet->AddHeader(tHeader);
+        Ptr<Packet> packet = extensions ? extensions->Copy() : Create<Packet>();
+        SocketIpTtlTag ttlTag;
+        ttlTag.SetTtl(ttl);
+        packet->AddPacketTag(ttlTag);
+        AddRequestHeaders(packet, rreqHeader, iface.GetLocal());
         // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
         Ipv4Address destination;
         if (iface.GetMask() == Ipv4Mask::GetOnes())
@@ -1724,12 +2576,77 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
             destination = iface.GetBroadcast();
         }
         m_lastBcastTime = Simulator::Now();
+        if (jitter)
+        {
+            ScheduleBroadcast(socket, packet, destination);
+        }
+        else
+        {
+            ScheduleBroadcast(socket, packet, destination, Seconds(0));
+        }
+    }
+}
+
+void
+RoutingProtocol::ScheduleRequestForward(const RreqHeader& rreqHeader,
+                                        uint8_t ttl,
+                                        double rssi,
+                                        Ptr<Packet> extensions)
+{
+    NS_LOG_FUNCTION(this << rreqHeader.GetOrigin() << rreqHeader.GetId());
+    if (m_rreqSuppression == SUPPRESSION_DISTANCE && rssi >= m_rreqSuppressionRssi)
+    {
+        NS_LOG_DEBUG("Suppress RREQ forward, previous hop heard at " << rssi << " dBm");
+        TraceSuppressed(RAODVTYPE_RREQ, rreqHeader.GetOrigin());
+        return;
+    }
+    PendingRreqForward& pending =
+        m_pendingRreqForwards[std::make_pair(rreqHeader.GetOrigin(), rreqHeader.GetId())];
+    pending.m_header = rreqHeader;
+    pending.m_extensions = extensions;
+    pending.m_ttl = ttl;
+    pending.m_copies = 1;
+    pending.m_forward =
         Simulator::Schedule(Time(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10))),
-                            &RoutingProtocol::SendTo,
+                            &RoutingProtocol::SendPendingRequestForward,
                             this,
-                            socket,
-                            packet,
-                            destination);
+                            rreqHeader.GetOrigin(),
+                            rreqHeader.GetId());
+}
+
+void
+RoutingProtocol::SendPendingRequestForward(Ipv4Address origin, uint32_t id)
+{
+    auto pending = m_pendingRreqForwards.find(std::make_pair(origin, id));
+    if (pending == m_pendingRreqForwards.end())
+    {
+        return;
+    }
+    RreqHeader rreqHeader = pending->second.m_header;
+    Ptr<Packet> extensions = pending->second.m_extensions;
+    uint8_t ttl = pending->second.m_ttl;
+    m_pendingRreqForwards.erase(pending);
+    ForwardRequest(rreqHeader, ttl, false, extensions);
+}
+
+void
+RoutingProtocol::SuppressRequestForward(Ipv4Address origin, uint32_t id, double rssi)
+{
+    auto pending = m_pendingRreqForwards.find(std::make_pair(origin, id));
+    if (pending == m_pendingRreqForwards.end())
+    {
+        return;
+    }
+    pending->second.m_copies++;
+    if ((m_rreqSuppression == SUPPRESSION_COUNTER &&
+         pending->second.m_copies >= m_rreqSuppressionThreshold) ||
+        (m_rreqSuppression == SUPPRESSION_DISTANCE && rssi >= m_rreqSuppressionRssi))
+    {
+        NS_LOG_DEBUG("Cancel forward of RREQ " << id << " from " << origin << " after "
+                                               << pending->second.m_copies << " copies");
+        pending->second.m_forward.Cancel();
+        m_pendingRreqForwards.erase(pending);
+        TraceSuppressed(RAODVTYPE_RREQ, origin);
     }
 }
 
@@ -1743,10 +2660,20 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
 void
 RoutingProtocol::RecvRevRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sender)
 {
+    RAODV_PROFILE_SCOPE("RecvRevRequest");
     NS_LOG_FUNCTION(this << " src " << sender);
     RevRreqHeader rrepHeader;
     p->RemoveHeader(rrepHeader);
     Ipv4Address dst = rrepHeader.GetDst();
+    if (m_linkBreakPrediction && m_nb.IsLinkBreaking(sender))
+    {
+        NS_LOG_DEBUG("Ignoring reverse request over breaking link from " << sender);
+        TraceDrop(RAODVTYPE_REVREQUEST, DROP_BLACKLIST, sender);
+        return;
+    }
+    uint32_t load = 0;
+    bool hasLoad = ReadLoadExtension(p, load);
+    Ptr<Packet> extension = ReadLocationExtension(p, dst);
     NS_LOG_LOGIC("RREP destination " << dst << " RREP origin " << rrepHeader.GetOrigin());
 
     uint8_t hop = rrepHeader.GetHopCount() + 1;
@@ -1758,6 +2685,7 @@ RoutingProtocol::RecvRevRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address
         //ProcessHello(rrepHeader, receiver);
         return;
     }
+    ObserveHopCount(dst, hop);
 
     /*
      * If the route table entry to the destination is created or updated, then the following actions
@@ -1782,6 +2710,13 @@ RoutingProtocol::RecvRevRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address
         /*hops=*/hop,
         /*nextHop=*/sender,
         /*lifetime=*/m_myRouteTimeout);
+    newEntry.SetPathLoad(load);
+    // The originator of a discovery waits for more paths before it chooses one
+    if (m_pathLoad != LOAD_NONE && IsMyOwnAddress(rrepHeader.GetOrigin()) &&
+        CollectPath(newEntry, rrepHeader.GetId()))
+    {
+        return;
+    }
     RoutingTableEntry toDst;
     if (m_routingTable.LookupRoute(dst, toDst))
     {
@@ -1799,11 +2734,19 @@ RoutingProtocol::RecvRevRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address
             (rrepHeader.GetDstSeqno() == toDst.GetSeqNo() && toDst.GetFlag() != VALID) ||
 
             // (iv) the sequence numbers are the same, and the New Hop Count is smaller than the
-            // hop count in route table entry.
-            (rrepHeader.GetDstSeqno() == toDst.GetSeqNo() && hop < toDst.GetHop()))
+            // hop count in route table entry (the path cost, if the load metric is on).
+            (rrepHeader.GetDstSeqno() == toDst.GetSeqNo() &&
+             GetPathCost(hop, load) < GetPathCost(toDst.GetHop(), toDst.GetPathLoad())))
         {
+            newEntry.InheritBackups(toDst, m_maxBackupRoutes);
             m_routingTable.Update(newEntry);
         }
+        // A path as fresh as the current route through another neighbor is kept as a backup
+        else if (rrepHeader.GetDstSeqno() == toDst.GetSeqNo() &&
+                 toDst.AddBackup(newEntry, m_maxBackupRoutes))
+        {
+            m_routingTable.Update(toDst);
+        }
     }
     else
     {
@@ -1823,9 +2766,10 @@ RoutingProtocol::RecvRevRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address
         if (toDst.GetFlag() == IN_SEARCH)
         {
             m_routingTable.Update(newEntry);
-            m_addressReqTimer[dst].Cancel();
             m_addressReqTimer.erase(dst);
+            m_localRepairTimer.erase(dst);
         }
+        ObserveDiscovery(dst, rrepHeader.GetId(), hop);
         m_routingTable.LookupRoute(dst, toDst);
         SendPacketFromQueue(dst, toDst.GetRoute());
         return;
@@ -1835,6 +2779,7 @@ RoutingProtocol::RecvRevRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address
     if (!m_routingTable.LookupRoute(rrepHeader.GetOrigin(), toOrigin) ||
         toOrigin.GetFlag() == IN_SEARCH)
     {
+        TraceDrop(RAODVTYPE_REVREQUEST, DROP_NO_ROUTE, sender);
         return; // Impossible! drop.
     }
     toOrigin.SetLifeTime(std::max(m_activeRouteTimeout, toOrigin.GetLifeTime()));
@@ -1865,21 +2810,44 @@ RoutingProtocol::RecvRevRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address
     {
         NS_LOG_DEBUG("TTL exceeded. Drop RREP destination " << dst << " origin "
                                                             << rrepHeader.GetOrigin());
+        TraceDrop(RAODVTYPE_REVREQUEST, DROP_TTL, sender);
         return;
     }
+    // Every copy may improve the route above, but each reverse request is rebroadcast only once
+    if (m_revRreqIdCache.IsDuplicate(rrepHeader.GetOrigin(), rrepHeader.GetId()))
+    {
+        NS_LOG_DEBUG("Reverse request " << rrepHeader.GetId() << " already forwarded");
+        TraceDrop(RAODVTYPE_REVREQUEST, DROP_DUPLICATE, sender);
+        return;
+    }
+    if (hop > m_revRreqGossipHops &&
+        m_uniformRandomVariable->GetValue(0, 1) >= m_revRreqGossipProbability)
+    {
+        NS_LOG_DEBUG("Gossip drops reverse request " << rrepHeader.GetId() << " at hop "
+                                                     << static_cast<uint32_t>(hop));
+        TraceSuppressed(RAODVTYPE_REVREQUEST, dst);
+        return;
+    }
+    if (!IsInRequestZone(extension))
+    {
+        NS_LOG_DEBUG("Outside the request zone. Drop reverse request " << rrepHeader.GetId());
+        TraceSuppressed(RAODVTYPE_REVREQUEST, dst);
+        return;
+    }
+    if (hasLoad)
+    {
+        extension = AddLoadExtension(extension, AccumulateLoad(load));
+    }
 
     for (auto j = m_socketAddresses.begin(); j != m_socketAddresses.end(); ++j)
     {
         Ptr<Socket> socket = j->first;
         Ipv4InterfaceAddress iface = j->second;
-        Ptr<Packet> packet = Create<Packet>();
+        Ptr<Packet> packet = extension ? extension->Copy() : Create<Packet>();
         SocketIpTtlTag ttl;
         ttl.SetTtl(tag.GetTtl() - 1);
         packet->AddPacketTag(ttl);
-        packet->AddHeader(rrepHeader);
-        TypeHeader tHeader(RAODVTYPE_RREQ);
-
-        packet->AddHeader(tHeader);
+        AddRevRequestHeaders(packet, rrepHeader, iface.GetLocal());
         // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
         Ipv4Address destination;
         if (iface.GetMask() == Ipv4Mask::GetOnes())
@@ -1891,12 +2859,7 @@ RoutingProtocol::RecvRevRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address
             destination = iface.GetBroadcast();
         }
         m_lastBcastTime = Simulator::Now();
-        Simulator::Schedule(Time(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10))),
-                            &RoutingProtocol::SendTo,
-                            this,
-                            socket,
-                            packet,
-                            destination);
+        ScheduleBroadcast(socket, packet, destination);
     }
 }
 
@@ -1930,53 +2893,341 @@ RoutingProtocol::SendReplytoAll(const RreqHeader& rreqHeader, const RoutingTable
 
 
 
-    RevRreqHeader rrepHeader(0,
-               0,
-               0,
-               rreqHeader.GetId(),rreqHeader.GetDst(),
-               rreqHeader.GetDstSeqno(),toOrigin.GetDestination(),m_seqNo);
+    RevRreqHeader rrepHeader(/*flags=*/0,
+                             /*reserved=*/0,
+                             /*hopCount=*/0,
+                             /*requestID=*/rreqHeader.GetId(),
+                             /*dst=*/rreqHeader.GetDst(),
+                             /*dstSeqNo=*/m_seqNo,
+                             /*origin=*/toOrigin.GetDestination(),
+                             /*originSeqNo=*/rreqHeader.GetOriginSeqno());
+    // The reverse request only needs to cover the ring the RREQ came through, plus some slack
+    // for alternative paths.
+    uint32_t ttl = std::min<uint32_t>(rreqHeader.GetHopCount() + m_revRreqRingSlack,
+                                      m_netDiameter);
+    m_revRreqIdCache.IsDuplicate(rrepHeader.GetOrigin(), rrepHeader.GetId());
+    Ptr<Packet> extension = CreateLocationExtension(rrepHeader.GetOrigin(), true);
+    if (m_pathLoad != LOAD_NONE)
+    {
+        extension = AddLoadExtension(extension, 0);
+    }
 
-    TypeHeader tHeader(RAODVTYPE_REVREQUEST);
     for (auto j = m_socketAddresses.begin(); j != m_socketAddresses.end(); ++j)
     {
         Ptr<Socket> socket = j->first;
         Ipv4InterfaceAddress iface = j->second;
 
-        rrepHeader.SetOrigin(iface.GetLocal());
-        m_rreqIdCache.IsDuplicate(iface.GetLocal(), m_requestId);
-
-        Ptr<Packet> packet = Create<Packet>();
+        Ptr<Packet> packet = extension ? extension->Copy() : Create<Packet>();
         SocketIpTtlTag tag;
-        tag.SetTtl(rrepHeader.GetHopCount());
+        tag.SetTtl(ttl);
         packet->AddPacketTag(tag);
-        packet->AddHeader(rreqHeader);
-        TypeHeader tHeader(RAODVTYPE_RREQ);
-        packet->AddHeader(tHeader);
+        AddRevRequestHeaders(packet, rrepHeader, iface.GetLocal());
         // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
         Ipv4Address destination;
         if (iface.GetMask() == Ipv4Mask::GetOnes())
         {
             destination = Ipv4Address("255.255.255.255");
         }
-        else
+        else
+        {
+            destination = iface.GetBroadcast();
+        }
+        NS_LOG_DEBUG("Send reverse RREQ with id " << rreqHeader.GetId() << " and TTL " << ttl
+                                                  << " to socket");
+        m_lastBcastTime = Simulator::Now();
+        ScheduleBroadcast(socket, packet, destination);
+    }
+}
+
+bool
+RoutingProtocol::GetOwnLocation(Vector& position, double& speed) const
+{
+    Ptr<MobilityModel> mobility = m_ipv4->GetObject<MobilityModel>();
+    if (!mobility)
+    {
+        return false;
+    }
+    position = mobility->GetPosition();
+    speed = mobility->GetVelocity().GetLength();
+    return true;
+}
+
+Ptr<Packet>
+RoutingProtocol::CreateLocationExtension(Ipv4Address target, bool zone) const
+{
+    Vector position;
+    double speed;
+    if (m_requestZone == ZONE_NONE || !GetOwnLocation(position, speed))
+    {
+        return nullptr;
+    }
+    LocationExtension locationExtension(position, speed, Simulator::Now());
+    auto location = m_locations.find(target);
+    if (zone && location != m_locations.end())
+    {
+        locationExtension.SetTarget(location->second.m_position,
+                                    location->second.m_speed,
+                                    location->second.m_time);
+    }
+    Ptr<Packet> extension = Create<Packet>();
+    extension->AddHeader(locationExtension);
+    return extension;
+}
+
+Ptr<Packet>
+RoutingProtocol::ReadLocationExtension(Ptr<const Packet> p, Ipv4Address source)
+{
+    LocationExtension locationExtension;
+    if (p->GetSize() < locationExtension.GetSerializedSize())
+    {
+        return nullptr;
+    }
+    p->PeekHeader(locationExtension);
+    if (!locationExtension.IsValid())
+    {
+        return nullptr;
+    }
+    // Reordered copies may carry an older location than the one already known
+    auto location = m_locations.find(source);
+    if (location == m_locations.end() || location->second.m_time < locationExtension.GetSourceTime())
+    {
+        m_locations[source] = {locationExtension.GetSourcePosition(),
+                               locationExtension.GetSourceSpeed(),
+                               locationExtension.GetSourceTime()};
+    }
+    Ptr<Packet> extension = Create<Packet>();
+    extension->AddHeader(locationExtension);
+    return extension;
+}
+
+bool
+RoutingProtocol::IsInRequestZone(Ptr<const Packet> extension) const
+{
+    Vector position;
+    double speed;
+    if (!extension || m_requestZone == ZONE_NONE || !GetOwnLocation(position, speed))
+    {
+        return true;
+    }
+    LocationExtension locationExtension;
+    extension->PeekHeader(locationExtension);
+    if (!locationExtension.HasZone())
+    {
+        return true;
+    }
+    // Expected zone: circle around the last known target location the target may have moved in
+    Vector target = locationExtension.GetTargetPosition();
+    double radius =
+        locationExtension.GetTargetSpeed() *
+            (Simulator::Now() - locationExtension.GetTargetTime()).GetSeconds() +
+        m_requestZoneMargin;
+    if (std::hypot(position.x - target.x, position.y - target.y) <= radius)
+    {
+        return true;
+    }
+    Vector source = locationExtension.GetSourcePosition();
+    if (m_requestZone == ZONE_RECTANGLE)
+    {
+        return position.x >= std::min(source.x, target.x - radius) &&
+               position.x <= std::max(source.x, target.x + radius) &&
+               position.y >= std::min(source.y, target.y - radius) &&
+               position.y <= std::max(source.y, target.y + radius);
+    }
+    // Cone from the source tangent to the expected zone
+    double sourceToTarget = std::hypot(target.x - source.x, target.y - source.y);
+    double sourceToNode = std::hypot(position.x - source.x, position.y - source.y);
+    if (sourceToTarget <= radius || sourceToNode == 0)
+    {
+        return true;
+    }
+    if (sourceToNode > sourceToTarget + radius)
+    {
+        return false;
+    }
+    double cosAngle = ((position.x - source.x) * (target.x - source.x) +
+                       (position.y - source.y) * (target.y - source.y)) /
+                      (sourceToNode * sourceToTarget);
+    double halfAngle = std::asin(radius / sourceToTarget);
+    return std::acos(std::clamp(cosAngle, -1.0, 1.0)) <= halfAngle;
+}
+
+
+
+
+//---------------------------------END-----------------------------------------
+
+uint32_t
+RoutingProtocol::GetQueueLoad() const
+{
+    uint32_t load = 0;
+    Ptr<TrafficControlLayer> tc = m_ipv4->GetObject<TrafficControlLayer>();
+    for (auto j = m_socketAddresses.begin(); j != m_socketAddresses.end(); ++j)
+    {
+        Ptr<NetDevice> dev =
+            m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(j->second.GetLocal()));
+        Ptr<QueueDisc> queueDisc = tc ? tc->GetRootQueueDiscOnDevice(dev) : nullptr;
+        if (queueDisc)
+        {
+            load += queueDisc->GetNPackets();
+        }
+        Ptr<WifiNetDevice> wifi = dev->GetObject<WifiNetDevice>();
+        if (!wifi || !wifi->GetMac())
+        {
+            continue;
+        }
+        Ptr<WifiMac> mac = wifi->GetMac();
+        Ptr<WifiMacQueue> queue = mac->GetTxopQueue(mac->GetQosSupported() ? AC_BE : AC_BE_NQOS);
+        if (queue)
+        {
+            load += queue->GetNPackets();
+        }
+    }
+    return load;
+}
+
+uint32_t
+RoutingProtocol::AccumulateLoad(uint32_t load) const
+{
+    switch (m_pathLoad)
+    {
+    case LOAD_SUM:
+        return load + GetQueueLoad();
+    case LOAD_MAX:
+        return std::max(load, GetQueueLoad());
+    default:
+        return load;
+    }
+}
+
+bool
+RoutingProtocol::ReadLoadExtension(Ptr<Packet> p, uint32_t& load) const
+{
+    LoadExtension loadExtension;
+    if (p->GetSize() < loadExtension.GetSerializedSize())
+    {
+        return false;
+    }
+    p->PeekHeader(loadExtension);
+    if (!loadExtension.IsValid())
+    {
+        return false;
+    }
+    p->RemoveHeader(loadExtension);
+    load = loadExtension.GetLoad();
+    return true;
+}
+
+Ptr<Packet>
+RoutingProtocol::AddLoadExtension(Ptr<const Packet> extensions, uint32_t load) const
+{
+    Ptr<Packet> packet = extensions ? extensions->Copy() : Create<Packet>();
+    packet->AddHeader(LoadExtension(load));
+    return packet;
+}
+
+double
+RoutingProtocol::GetPathCost(uint16_t hops, uint32_t load) const
+{
+    if (m_pathLoad == LOAD_NONE)
+    {
+        return hops;
+    }
+    return hops + static_cast<double>(load) / m_pathLoadPerHop;
+}
+
+void
+RoutingProtocol::SelectReverseRoute(Ptr<Packet> p,
+                                    RreqHeader rreqHeader,
+                                    Ipv4Address receiver,
+                                    Ipv4Address src)
+{
+    Ipv4Address origin = rreqHeader.GetOrigin();
+    auto selection = m_reverseSelections.find(origin);
+    if (selection == m_reverseSelections.end() ||
+        selection->second.first != rreqHeader.GetId() ||
+        selection->second.second < Simulator::Now())
+    {
+        return;
+    }
+    uint32_t load = 0;
+    ReadLoadExtension(p, load);
+    uint8_t hop = rreqHeader.GetHopCount() + 1;
+    RoutingTableEntry toOrigin;
+    if (m_routingTable.LookupRoute(origin, toOrigin) &&
+        GetPathCost(hop, load) >= GetPathCost(toOrigin.GetHop(), toOrigin.GetPathLoad()))
+    {
+        return;
+    }
+    NS_LOG_DEBUG("Reverse route to " << origin << " through " << src << ", " << uint32_t(hop)
+                                     << " hops, load " << load);
+    rreqHeader.SetHopCount(hop);
+    UpdateReverseRoute(rreqHeader, receiver, src, load);
+}
+
+bool
+RoutingProtocol::CollectPath(const RoutingTableEntry& candidate, uint32_t id)
+{
+    Ipv4Address dst = candidate.GetDestination();
+    auto selection = m_pathSelections.find(dst);
+    if (selection == m_pathSelections.end())
+    {
+        RoutingTableEntry toDst;
+        if (!m_routingTable.LookupRoute(dst, toDst) || toDst.GetFlag() != IN_SEARCH)
+        {
+            return false;
+        }
+        // The discovery is answered, only the choice of the path is left
+        m_addressReqTimer.erase(dst);
+        m_localRepairTimer.erase(dst);
+        ObserveDiscovery(dst, id, candidate.GetHop());
+        selection = m_pathSelections.try_emplace(dst).first;
+        auto timer = m_pathSelectionTimer.try_emplace(dst);
+        if (timer.second)
         {
-            destination = iface.GetBroadcast();
+            timer.first->second.SetFunction(
+                MakeCallback(&RoutingProtocol::PathSelectionTimerExpire, this).Bind(dst));
         }
-        NS_LOG_DEBUG("Send RREQ with id " << rreqHeader.GetId() << " to socket");
-        m_lastBcastTime = Simulator::Now();
-        Simulator::Schedule(Time(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10))),
-                            &RoutingProtocol::SendTo,
-                            this,
-                            socket,
-                            packet,
-                            destination);
+        m_timerWheel.Schedule(timer.first->second, m_pathLoadWindow);
     }
+    selection->second.push_back(candidate);
+    return true;
 }
 
-
-
-
-//---------------------------------END-----------------------------------------
+void
+RoutingProtocol::PathSelectionTimerExpire(Ipv4Address dst)
+{
+    NS_LOG_FUNCTION(this << dst);
+    auto selection = m_pathSelections.find(dst);
+    if (selection == m_pathSelections.end())
+    {
+        return;
+    }
+    std::vector<RoutingTableEntry> candidates = selection->second;
+    m_pathSelections.erase(selection);
+    m_pathSelectionTimer.erase(dst);
+    RoutingTableEntry toDst;
+    if (!m_routingTable.LookupRoute(dst, toDst) || toDst.GetFlag() != IN_SEARCH)
+    {
+        return;
+    }
+    auto best = std::min_element(candidates.begin(),
+                                 candidates.end(),
+                                 [this](const RoutingTableEntry& a, const RoutingTableEntry& b) {
+                                     return GetPathCost(a.GetHop(), a.GetPathLoad()) <
+                                            GetPathCost(b.GetHop(), b.GetPathLoad());
+                                 });
+    RoutingTableEntry route = *best;
+    for (auto i = candidates.begin(); i != candidates.end(); ++i)
+    {
+        route.AddBackup(*i, m_maxBackupRoutes);
+    }
+    NS_LOG_DEBUG("Route to " << dst << " through " << route.GetNextHop() << ", "
+                             << route.GetHop() << " hops, load " << route.GetPathLoad()
+                             << ", chosen out of " << candidates.size() << " paths");
+    m_routingTable.Update(route);
+    m_routingTable.LookupRoute(dst, toDst);
+    SendPacketFromQueue(dst, toDst.GetRoute());
+}
 
 void
 RoutingProtocol::SendReply(const RreqHeader& rreqHeader, const RoutingTableEntry& toOrigin)
@@ -2006,7 +3257,7 @@ RoutingProtocol::SendReply(const RreqHeader& rreqHeader, const RoutingTableEntry
     packet->AddHeader(tHeader);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
     NS_ASSERT(socket);
-    socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), RAODV_PORT));
+    SendTo(socket, packet, toOrigin.GetNextHop());
 }
 
 void
@@ -2047,7 +3298,7 @@ RoutingProtocol::SendReplyByIntermediateNode(RoutingTableEntry& toDst,
     packet->AddHeader(tHeader);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
     NS_ASSERT(socket);
-    socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), RAODV_PORT));
+    SendTo(socket, packet, toOrigin.GetNextHop());
 
     // Generating gratuitous RREPs
     if (gratRep)
@@ -2068,7 +3319,7 @@ RoutingProtocol::SendReplyByIntermediateNode(RoutingTableEntry& toDst,
         Ptr<Socket> socket = FindSocketWithInterfaceAddress(toDst.GetInterface());
         NS_ASSERT(socket);
         NS_LOG_LOGIC("Send gratuitous RREP " << packet->GetUid());
-        socket->SendTo(packetToDst, 0, InetSocketAddress(toDst.GetNextHop(), RAODV_PORT));
+        SendTo(socket, packetToDst, toDst.GetNextHop());
     }
 }
 
@@ -2088,12 +3339,13 @@ RoutingProtocol::SendReplyAck(Ipv4Address neighbor)
     m_routingTable.LookupRoute(neighbor, toNeighbor);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toNeighbor.GetInterface());
     NS_ASSERT(socket);
-    socket->SendTo(packet, 0, InetSocketAddress(neighbor, RAODV_PORT));
+    SendTo(socket, packet, neighbor);
 }
 
 void
 RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sender)
 {
+    RAODV_PROFILE_SCOPE("RecvReply");
     NS_LOG_FUNCTION(this << " src " << sender);
     RrepHeader rrepHeader;
     p->RemoveHeader(rrepHeader);
@@ -2109,6 +3361,7 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
         ProcessHello(rrepHeader, receiver);
         return;
     }
+    ObserveHopCount(dst, hop);
 
     /*
      * If the route table entry to the destination is created or updated, then the following actions
@@ -2174,8 +3427,8 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
         if (toDst.GetFlag() == IN_SEARCH)
         {
             m_routingTable.Update(newEntry);
-            m_addressReqTimer[dst].Cancel();
             m_addressReqTimer.erase(dst);
+            m_localRepairTimer.erase(dst);
         }
         m_routingTable.LookupRoute(dst, toDst);
         SendPacketFromQueue(dst, toDst.GetRoute());
@@ -2186,6 +3439,7 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
     if (!m_routingTable.LookupRoute(rrepHeader.GetOrigin(), toOrigin) ||
         toOrigin.GetFlag() == IN_SEARCH)
     {
+        TraceDrop(RAODVTYPE_RREP, DROP_NO_ROUTE, sender);
         return; // Impossible! drop.
     }
     toOrigin.SetLifeTime(std::max(m_activeRouteTimeout, toOrigin.GetLifeTime()));
@@ -2216,6 +3470,7 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
     {
         NS_LOG_DEBUG("TTL exceeded. Drop RREP destination " << dst << " origin "
                                                             << rrepHeader.GetOrigin());
+        TraceDrop(RAODVTYPE_RREP, DROP_TTL, sender);
         return;
     }
 
@@ -2228,12 +3483,13 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
     packet->AddHeader(tHeader);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
     NS_ASSERT(socket);
-    socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), RAODV_PORT));
+    SendTo(socket, packet, toOrigin.GetNextHop());
 }
 
 void
 RoutingProtocol::RecvReplyAck(Ipv4Address neighbor)
 {
+    RAODV_PROFILE_SCOPE("RecvReplyAck");
     NS_LOG_FUNCTION(this);
     RoutingTableEntry rt;
     if (m_routingTable.LookupRoute(neighbor, rt))
@@ -2284,12 +3540,17 @@ RoutingProtocol::ProcessHello(const RrepHeader& rrepHeader, Ipv4Address receiver
     if (m_enableHello)
     {
         m_nb.Update(rrepHeader.GetDst(), Time(m_allowedHelloLoss * m_helloInterval));
+        m_nb.SetCapabilities(rrepHeader.GetDst(),
+                             (rrepHeader.GetCompactCapable() ? Neighbors::COMPACT_RREQ : 0) |
+                                 (rrepHeader.GetCoalesceCapable() ? Neighbors::COALESCING : 0) |
+                                 (rrepHeader.GetRefreshCapable() ? Neighbors::ROUTE_REFRESH : 0));
     }
 }
 
 void
 RoutingProtocol::RecvError(Ptr<Packet> p, Ipv4Address src)
 {
+    RAODV_PROFILE_SCOPE("RecvError");
     NS_LOG_FUNCTION(this << " from " << src);
     RerrHeader rerrHeader;
     p->RemoveHeader(rerrHeader);
@@ -2307,6 +3568,7 @@ RoutingProtocol::RecvError(Ptr<Packet> p, Ipv4Address src)
             }
         }
     }
+    FailOverRoutes(src, unreachable);
 
     std::vector<Ipv4Address> precursors;
     for (auto i = unreachable.begin(); i != unreachable.end();)
@@ -2348,6 +3610,7 @@ RoutingProtocol::RecvError(Ptr<Packet> p, Ipv4Address src)
 void
 RoutingProtocol::RouteRequestTimerExpire(Ipv4Address dst)
 {
+    RAODV_PROFILE_SCOPE("RouteRequestTimerExpire");
     NS_LOG_LOGIC(this);
     RoutingTableEntry toDst;
     if (m_routingTable.LookupValidRoute(dst, toDst))
@@ -2371,6 +3634,7 @@ RoutingProtocol::RouteRequestTimerExpire(Ipv4Address dst)
         m_routingTable.DeleteRoute(dst);
         NS_LOG_DEBUG("Route not found. Drop all packets with dst " << dst);
         m_queue.DropPacketWithDst(dst);
+        EndDiscovery(dst, false);
         return;
     }
 
@@ -2385,12 +3649,212 @@ RoutingProtocol::RouteRequestTimerExpire(Ipv4Address dst)
         m_addressReqTimer.erase(dst);
         m_routingTable.DeleteRoute(dst);
         m_queue.DropPacketWithDst(dst);
+        EndDiscovery(dst, false);
+    }
+}
+
+void
+RoutingProtocol::LocalRepairTimerExpire(Ipv4Address dst)
+{
+    NS_LOG_FUNCTION(this << dst);
+    m_localRepairTimer.erase(dst);
+    RoutingTableEntry toDst;
+    if (m_routingTable.LookupValidRoute(dst, toDst))
+    {
+        SendPacketFromQueue(dst, toDst.GetRoute());
+        NS_LOG_LOGIC("route to " << dst << " repaired");
+        return;
+    }
+    NS_LOG_DEBUG("Local repair of route to " << dst << " failed. Drop packets with dst " << dst);
+    m_queue.DropPacketWithDst(dst);
+    EndDiscovery(dst, false);
+    if (!m_routingTable.LookupRoute(dst, toDst))
+    {
+        return;
+    }
+    std::vector<Ipv4Address> precursors;
+    toDst.GetPrecursors(precursors);
+    toDst.Invalidate(m_deletePeriod);
+    m_routingTable.Update(toDst);
+
+    RerrHeader rerrHeader;
+    rerrHeader.AddUnDestination(dst, toDst.GetSeqNo());
+    Ptr<Packet> packet = Create<Packet>();
+    SocketIpTtlTag tag;
+    tag.SetTtl(1);
+    packet->AddPacketTag(tag);
+    packet->AddHeader(rerrHeader);
+    packet->AddHeader(TypeHeader(RAODVTYPE_RERR));
+    SendRerrMessage(packet, precursors);
+}
+
+void
+RoutingProtocol::TrackFlow(Ipv4Address dst)
+{
+    auto flow = m_flows.try_emplace(dst);
+    if (!flow.second)
+    {
+        flow.first->second.m_longestGap =
+            std::max(flow.first->second.m_longestGap,
+                     Simulator::Now() - flow.first->second.m_lastPacket);
+    }
+    flow.first->second.m_lastPacket = Simulator::Now();
+
+    auto timer = m_routeRefreshTimer.try_emplace(dst);
+    if (timer.second)
+    {
+        timer.first->second.SetFunction(
+            MakeCallback(&RoutingProtocol::RouteRefreshTimerExpire, this).Bind(dst));
+    }
+    // Every packet pushes the expiry back, the timer only checks the route when it fires
+    if (!timer.first->second.IsRunning())
+    {
+        m_timerWheel.Schedule(timer.first->second,
+                              std::max(m_activeRouteTimeout - m_routeRefreshLead, Time(0)));
+    }
+}
+
+void
+RoutingProtocol::RouteRefreshTimerExpire(Ipv4Address dst)
+{
+    NS_LOG_FUNCTION(this << dst);
+    RoutingTableEntry toDst;
+    auto flow = m_flows.find(dst);
+    if (flow == m_flows.end() || !m_routingTable.LookupValidRoute(dst, toDst))
+    {
+        m_flows.erase(dst);
+        m_routeRefreshTimer.erase(dst);
+        return;
+    }
+    // Traffic or an earlier refresh kept the route alive
+    if (toDst.GetLifeTime() > m_routeRefreshLead)
+    {
+        m_timerWheel.Schedule(m_routeRefreshTimer[dst], toDst.GetLifeTime() - m_routeRefreshLead);
+        return;
+    }
+    // A flow that paused this long before is likely to resume, otherwise it is over
+    Time idle = Simulator::Now() - flow->second.m_lastPacket;
+    if (idle > 2 * flow->second.m_longestGap)
+    {
+        NS_LOG_LOGIC("Flow to " << dst << " idle for " << idle.As(Time::S) << ", no refresh");
+        m_flows.erase(flow);
+        m_routeRefreshTimer.erase(dst);
+        return;
+    }
+    SendRefreshRequest(toDst);
+    // Check again when the route would have expired, the RREP extends its lifetime
+    m_timerWheel.Schedule(m_routeRefreshTimer[dst], toDst.GetLifeTime());
+}
+
+void
+RoutingProtocol::SendRefreshRequest(const RoutingTableEntry& toDst)
+{
+    NS_LOG_FUNCTION(this << toDst.GetDestination());
+    if (!m_nb.IsCapable(toDst.GetNextHop(), Neighbors::ROUTE_REFRESH))
+    {
+        NS_LOG_LOGIC("Next hop " << toDst.GetNextHop() << " does not refresh, no refresh of the "
+                                 << "route to " << toDst.GetDestination());
+        TraceDrop(RAODVTYPE_RREQ_REFRESH, DROP_NO_ROUTE, toDst.GetDestination());
+        return;
+    }
+    if (!m_rateLimitedRreqs.empty() || !m_rreqBucket.Consume())
+    {
+        NS_LOG_LOGIC("RreqRateLimit reached, no refresh of the route to "
+                     << toDst.GetDestination());
+        TraceDrop(RAODVTYPE_RREQ_REFRESH, DROP_RATE_LIMIT, toDst.GetDestination());
+        return;
+    }
+    RreqHeader rreqHeader = CreateRefreshHeader(toDst);
+    Ptr<Packet> packet = Create<Packet>();
+    SocketIpTtlTag tag;
+    tag.SetTtl(toDst.GetHop() + m_ttlIncrement);
+    packet->AddPacketTag(tag);
+    packet->AddHeader(rreqHeader);
+    packet->AddHeader(TypeHeader(RAODVTYPE_RREQ_REFRESH));
+    Ptr<Socket> socket = FindSocketWithInterfaceAddress(toDst.GetInterface());
+    NS_ASSERT(socket);
+    NS_LOG_DEBUG("Send refresh RREQ with id " << m_requestId << " to " << toDst.GetNextHop());
+    SendTo(socket, packet, toDst.GetNextHop());
+}
+
+RreqHeader
+RoutingProtocol::CreateRefreshHeader(const RoutingTableEntry& toDst)
+{
+    RreqHeader rreqHeader;
+    rreqHeader.SetDst(toDst.GetDestination());
+    rreqHeader.SetDstSeqno(toDst.GetSeqNo() + 1);
+    m_seqNo++;
+    rreqHeader.SetOriginSeqno(m_seqNo);
+    m_requestId++;
+    rreqHeader.SetId(m_requestId);
+    rreqHeader.SetOrigin(toDst.GetInterface().GetLocal());
+    m_rreqIdCache.IsDuplicate(rreqHeader.GetOrigin(), m_requestId);
+    return rreqHeader;
+}
+
+void
+RoutingProtocol::LinkBreakPredicted(Ipv4Address neighbor)
+{
+    NS_LOG_FUNCTION(this << neighbor);
+    std::map<Ipv4Address, uint32_t> unreachable;
+    m_routingTable.GetListOfDestinationWithNextHop(neighbor, unreachable);
+    FailOverRoutes(neighbor, unreachable);
+    for (auto i = unreachable.begin(); i != unreachable.end(); ++i)
+    {
+        RoutingTableEntry toDst;
+        if (i->first != neighbor && m_routingTable.LookupValidRoute(i->first, toDst))
+        {
+            SendPreemptiveRequest(toDst);
+        }
+    }
+}
+
+void
+RoutingProtocol::SendPreemptiveRequest(const RoutingTableEntry& toDst)
+{
+    NS_LOG_FUNCTION(this << toDst.GetDestination());
+    if (!m_rateLimitedRreqs.empty() || !m_rreqBucket.Consume())
+    {
+        NS_LOG_LOGIC("RreqRateLimit reached, no preemptive RREQ for "
+                     << toDst.GetDestination());
+        TraceDrop(RAODVTYPE_RREQ, DROP_RATE_LIMIT, toDst.GetDestination());
+        return;
+    }
+    RreqHeader rreqHeader = CreateRefreshHeader(toDst);
+    for (auto j = m_socketAddresses.begin(); j != m_socketAddresses.end(); ++j)
+    {
+        Ptr<Socket> socket = j->first;
+        Ipv4InterfaceAddress iface = j->second;
+        if (iface.GetLocal() != rreqHeader.GetOrigin())
+        {
+            continue;
+        }
+        Ptr<Packet> packet = Create<Packet>();
+        SocketIpTtlTag tag;
+        tag.SetTtl(toDst.GetHop() + m_ttlIncrement);
+        packet->AddPacketTag(tag);
+        AddRequestHeaders(packet, rreqHeader, iface.GetLocal());
+        // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
+        Ipv4Address destination;
+        if (iface.GetMask() == Ipv4Mask::GetOnes())
+        {
+            destination = Ipv4Address("255.255.255.255");
+        }
+        else
+        {
+            destination = iface.GetBroadcast();
+        }
+        NS_LOG_DEBUG("Send preemptive RREQ with id " << rreqHeader.GetId() << " to "
+                                                     << rreqHeader.GetDst());
+        m_lastBcastTime = Simulator::Now();
+        ScheduleBroadcast(socket, packet, destination);
     }
 }
 
 void
 RoutingProtocol::HelloTimerExpire()
 {
+    RAODV_PROFILE_SCOPE("HelloTimerExpire");
     NS_LOG_FUNCTION(this);
     Time offset = Time(Seconds(0));
     if (m_lastBcastTime > Time(Seconds(0)))
@@ -2402,26 +3866,161 @@ RoutingProtocol::HelloTimerExpire()
     {
         SendHello();
     }
-    m_htimer.Cancel();
     Time diff = m_helloInterval - offset;
-    m_htimer.Schedule(std::max(Time(Seconds(0)), diff));
+    m_timerWheel.Schedule(m_htimer, std::max(Time(Seconds(0)), diff));
     m_lastBcastTime = Time(Seconds(0));
 }
 
+void
+RoutingProtocol::NeighborPurgeTimerExpire()
+{
+    RAODV_PROFILE_SCOPE("NeighborPurgeTimerExpire");
+    NS_LOG_FUNCTION(this);
+    m_nb.Purge();
+    m_timerWheel.Schedule(m_nbPurgeTimer, m_helloInterval);
+}
+
+void
+RoutingProtocol::SetTimerWheelTick(Time tick)
+{
+    m_timerWheel.SetTick(tick);
+}
+
+Time
+RoutingProtocol::GetTimerWheelTick() const
+{
+    return m_timerWheel.GetTick();
+}
+
 void
 RoutingProtocol::RreqRateLimitTimerExpire()
 {
     NS_LOG_FUNCTION(this);
-    m_rreqCount = 0;
-    m_rreqRateLimitTimer.Schedule(Seconds(1));
+    while (!m_rateLimitedRreqs.empty())
+    {
+        Ipv4Address dst = m_rateLimitedRreqs.front();
+        RoutingTableEntry toDst;
+        if (m_routingTable.LookupValidRoute(dst, toDst))
+        {
+            NS_LOG_LOGIC("Route to " << dst << " found while its RREQ was rate limited");
+            m_rateLimitedRreqs.pop_front();
+            m_rateLimitedRreqDsts.erase(dst);
+            continue;
+        }
+        if (!m_rreqBucket.Consume())
+        {
+            break;
+        }
+        m_rateLimitedRreqs.pop_front();
+        m_rateLimitedRreqDsts.erase(dst);
+        OriginateRequest(dst);
+        ScheduleRreqRetry(dst);
+    }
+    if (!m_rateLimitedRreqs.empty())
+    {
+        m_timerWheel.Schedule(m_rreqRateLimitTimer, m_rreqBucket.GetDelay());
+    }
 }
 
 void
 RoutingProtocol::RerrRateLimitTimerExpire()
 {
     NS_LOG_FUNCTION(this);
-    m_rerrCount = 0;
-    m_rerrRateLimitTimer.Schedule(Seconds(1));
+    while (!m_rateLimitedRerrs.empty() && m_rerrBucket.Consume())
+    {
+        RateLimitedRerr rerr = m_rateLimitedRerrs.front();
+        m_rateLimitedRerrs.pop_front();
+        if (rerr.m_precursors.empty())
+        {
+            SendRerrToSource(rerr.m_packet, rerr.m_origin);
+        }
+        else
+        {
+            SendRerrToPrecursors(rerr.m_packet, rerr.m_precursors);
+        }
+    }
+    if (!m_rateLimitedRerrs.empty())
+    {
+        m_timerWheel.Schedule(m_rerrRateLimitTimer, m_rerrBucket.GetDelay());
+    }
+}
+
+/**
+ * \param header a RERR header
+ * \return the unreachable destinations of the header and their sequence numbers
+ */
+static std::map<Ipv4Address, uint32_t>
+GetUnreachable(RerrHeader header)
+{
+    std::map<Ipv4Address, uint32_t> unreachable;
+    std::pair<Ipv4Address, uint32_t> un;
+    while (header.RemoveUnDestination(un))
+    {
+        unreachable.insert(un);
+    }
+    return unreachable;
+}
+
+void
+RoutingProtocol::DeferRerr(Ptr<Packet> packet,
+                           const std::vector<Ipv4Address>& precursors,
+                           Ipv4Address origin)
+{
+    TypeHeader tHeader;
+    RerrHeader rerrHeader;
+    Ptr<Packet> merged = packet->Copy();
+    merged->RemoveHeader(tHeader);
+    merged->RemoveHeader(rerrHeader);
+    std::map<Ipv4Address, uint32_t> unreachable = GetUnreachable(rerrHeader);
+    NS_LOG_LOGIC("RerrRateLimit reached at " << Simulator::Now().As(Time::S) << "; queue RERR for "
+                                             << unreachable.size() << " destinations");
+    for (auto i = m_rateLimitedRerrs.begin(); i != m_rateLimitedRerrs.end(); ++i)
+    {
+        // A RERR to the source is never merged with one to the precursors
+        if (i->m_precursors.empty() != precursors.empty() || i->m_origin != origin)
+        {
+            continue;
+        }
+        Ptr<Packet> queued = i->m_packet->Copy();
+        RerrHeader queuedHeader;
+        queued->RemoveHeader(tHeader);
+        queued->RemoveHeader(queuedHeader);
+        std::map<Ipv4Address, uint32_t> queuedUnreachable = GetUnreachable(queuedHeader);
+        size_t common = 0;
+        for (auto un = unreachable.begin(); un != unreachable.end(); ++un)
+        {
+            common += queuedUnreachable.count(un->first);
+        }
+        // A RERR lists at most 255 destinations
+        if (common == 0 || queuedHeader.GetNoDelete() != rerrHeader.GetNoDelete() ||
+            unreachable.size() + queuedUnreachable.size() - common > 255)
+        {
+            continue;
+        }
+        // The newer RERR carries the newer sequence numbers; AddUnDestination keeps them
+        for (auto un = queuedUnreachable.begin(); un != queuedUnreachable.end(); ++un)
+        {
+            rerrHeader.AddUnDestination(un->first, un->second);
+        }
+        merged->AddHeader(rerrHeader);
+        merged->AddHeader(TypeHeader(RAODVTYPE_RERR));
+        i->m_packet = merged;
+        for (auto precursor = precursors.begin(); precursor != precursors.end(); ++precursor)
+        {
+            if (std::find(i->m_precursors.begin(), i->m_precursors.end(), *precursor) ==
+                i->m_precursors.end())
+            {
+                i->m_precursors.push_back(*precursor);
+            }
+        }
+        TraceDrop(RAODVTYPE_RERR, DROP_RATE_LIMIT, unreachable.begin()->first);
+        return;
+    }
+    m_rateLimitedRerrs.push_back({packet, precursors, origin});
+    if (!m_rerrRateLimitTimer.IsRunning() && m_rerrBucket.GetRate() != 0)
+    {
+        m_timerWheel.Schedule(m_rerrRateLimitTimer, m_rerrBucket.GetDelay());
+    }
 }
 
 void
@@ -2451,6 +4050,9 @@ RoutingProtocol::SendHello()
                                /*dstSeqNo=*/m_seqNo,
                                /*origin=*/iface.GetLocal(),
                                /*lifetime=*/Time(m_allowedHelloLoss * m_helloInterval));
+        helloHeader.SetCompactCapable(m_enableCompactHeaders);
+        helloHeader.SetCoalesceCapable(m_enableCoalescing);
+        helloHeader.SetRefreshCapable(m_enableRouteRefresh);
         Ptr<Packet> packet = Create<Packet>();
         SocketIpTtlTag tag;
         tag.SetTtl(1);
@@ -2468,21 +4070,22 @@ RoutingProtocol::SendHello()
         {
             destination = iface.GetBroadcast();
         }
-        Time jitter = Time(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)));
-        Simulator::Schedule(jitter, &RoutingProtocol::SendTo, this, socket, packet, destination);
+        ScheduleBroadcast(socket, packet, destination);
     }
 }
 
 void
 RoutingProtocol::SendPacketFromQueue(Ipv4Address dst, Ptr<Ipv4Route> route)
 {
+    RAODV_PROFILE_SCOPE("SendPacketFromQueue");
     NS_LOG_FUNCTION(this);
     QueueEntry queueEntry;
     while (m_queue.Dequeue(dst, queueEntry))
     {
         DeferredRouteOutputTag tag;
         Ptr<Packet> p = ConstCast<Packet>(queueEntry.GetPacket());
-        if (p->RemovePacketTag(tag) && tag.GetInterface() != -1 &&
+        bool deferred = p->RemovePacketTag(tag);
+        if (deferred && tag.GetInterface() != -1 &&
             tag.GetInterface() != m_ipv4->GetInterfaceForDevice(route->GetOutputDevice()))
         {
             NS_LOG_DEBUG("Output device doesn't match. Dropped.");
@@ -2490,16 +4093,24 @@ RoutingProtocol::SendPacketFromQueue(Ipv4Address dst, Ptr<Ipv4Route> route)
         }
         UnicastForwardCallback ucb = queueEntry.GetUnicastForwardCallback();
         Ipv4Header header = queueEntry.GetIpv4Header();
-        header.SetSource(route->GetSource());
-        header.SetTtl(header.GetTtl() +
-                      1); // compensate extra TTL decrement by fake loopback routing
+        // Packets buffered during a local repair are forwarded with their header unchanged
+        if (deferred)
+        {
+            header.SetSource(route->GetSource());
+            header.SetTtl(header.GetTtl() +
+                          1); // compensate extra TTL decrement by fake loopback routing
+        }
+        EndDiscovery(dst, true);
         ucb(route, p, header);
     }
+    // Nothing was sent: the buffered packets expired while the route was searched
+    EndDiscovery(dst, false);
 }
 
 void
 RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
 {
+    RAODV_PROFILE_SCOPE("SendRerrWhenBreaksLinkToNextHop");
     NS_LOG_FUNCTION(this << nextHop);
     RerrHeader rerrHeader;
     std::vector<Ipv4Address> precursors;
@@ -2513,6 +4124,24 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
     toNextHop.GetPrecursors(precursors);
     rerrHeader.AddUnDestination(nextHop, toNextHop.GetSeqNo());
     m_routingTable.GetListOfDestinationWithNextHop(nextHop, unreachable);
+    FailOverRoutes(nextHop, unreachable);
+    // Routes that carry traffic for other nodes and end close enough are repaired locally. Their
+    // RERR is only sent if the repair fails.
+    for (auto i = unreachable.begin(); m_enableLocalRepair && i != unreachable.end();)
+    {
+        RoutingTableEntry toDst;
+        m_routingTable.LookupRoute(i->first, toDst);
+        if (i->first != nextHop && toDst.GetFlag() == VALID &&
+            toDst.GetHop() <= m_localRepairHops && !toDst.IsPrecursorListEmpty() &&
+            StartLocalRepair(i->first))
+        {
+            i = unreachable.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
     for (auto i = unreachable.begin(); i != unreachable.end();)
     {
         if (!rerrHeader.AddUnDestination(i->first, i->second))
@@ -2551,38 +4180,82 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
     m_routingTable.InvalidateRoutesWithDst(unreachable);
 }
 
+bool
+RoutingProtocol::FailOver(RoutingTableEntry& rt)
+{
+    NS_LOG_FUNCTION(this << rt.GetDestination());
+    while (rt.PromoteBackup())
+    {
+        RoutingTableEntry toNextHop;
+        if (m_routingTable.LookupValidRoute(rt.GetNextHop(), toNextHop))
+        {
+            m_routingTable.Update(rt);
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+RoutingProtocol::FailOverRoutes(Ipv4Address nextHop, std::map<Ipv4Address, uint32_t>& unreachable)
+{
+    NS_LOG_FUNCTION(this << nextHop);
+    if (m_maxBackupRoutes == 0)
+    {
+        return;
+    }
+    m_routingTable.DeleteBackupsWithNextHop(nextHop);
+    for (auto i = unreachable.begin(); i != unreachable.end();)
+    {
+        RoutingTableEntry toDst;
+        m_routingTable.LookupRoute(i->first, toDst);
+        if (i->first != nextHop && toDst.GetFlag() == VALID && FailOver(toDst))
+        {
+            NS_LOG_LOGIC("Route to " << i->first << " failed over to " << toDst.GetNextHop());
+            i = unreachable.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
 void
 RoutingProtocol::SendRerrWhenNoRouteToForward(Ipv4Address dst,
                                               uint32_t dstSeqNo,
                                               Ipv4Address origin)
 {
+    RAODV_PROFILE_SCOPE("SendRerrWhenNoRouteToForward");
     NS_LOG_FUNCTION(this);
-    // A node SHOULD NOT originate more than RERR_RATELIMIT RERR messages per second.
-    if (m_rerrCount == m_rerrRateLimit)
-    {
-        // Just make sure that the RerrRateLimit timer is running and will expire
-        NS_ASSERT(m_rerrRateLimitTimer.IsRunning());
-        // discard the packet and return
-        NS_LOG_LOGIC("RerrRateLimit reached at "
-                     << Simulator::Now().As(Time::S) << " with timer delay left "
-                     << m_rerrRateLimitTimer.GetDelayLeft().As(Time::S) << "; suppressing RERR");
-        return;
-    }
     RerrHeader rerrHeader;
     rerrHeader.AddUnDestination(dst, dstSeqNo);
-    RoutingTableEntry toOrigin;
     Ptr<Packet> packet = Create<Packet>();
     SocketIpTtlTag tag;
     tag.SetTtl(1);
     packet->AddPacketTag(tag);
     packet->AddHeader(rerrHeader);
     packet->AddHeader(TypeHeader(RAODVTYPE_RERR));
+    // A node SHOULD NOT originate more than RERR_RATELIMIT RERR messages per second.
+    if (m_rateLimitedRerrs.empty() && m_rerrBucket.Consume())
+    {
+        SendRerrToSource(packet, origin);
+        return;
+    }
+    DeferRerr(packet, std::vector<Ipv4Address>(), origin);
+}
+
+void
+RoutingProtocol::SendRerrToSource(Ptr<Packet> packet, Ipv4Address origin)
+{
+    NS_LOG_FUNCTION(this << origin);
+    RoutingTableEntry toOrigin;
     if (m_routingTable.LookupValidRoute(origin, toOrigin))
     {
         Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
         NS_ASSERT(socket);
         NS_LOG_LOGIC("Unicast RERR to the source of the data transmission");
-        socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), RAODV_PORT));
+        SendTo(socket, packet, toOrigin.GetNextHop());
     }
     else
     {
@@ -2602,7 +4275,7 @@ RoutingProtocol::SendRerrWhenNoRouteToForward(Ipv4Address dst,
             {
                 destination = iface.GetBroadcast();
             }
-            socket->SendTo(packet->Copy(), 0, InetSocketAddress(destination, RAODV_PORT));
+            SendTo(socket, packet->Copy(), destination);
         }
     }
 }
@@ -2610,6 +4283,7 @@ RoutingProtocol::SendRerrWhenNoRouteToForward(Ipv4Address dst,
 void
 RoutingProtocol::SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> precursors)
 {
+    RAODV_PROFILE_SCOPE("SendRerrMessage");
     NS_LOG_FUNCTION(this);
 
     if (precursors.empty())
@@ -2618,16 +4292,18 @@ RoutingProtocol::SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> pr
         return;
     }
     // A node SHOULD NOT originate more than RERR_RATELIMIT RERR messages per second.
-    if (m_rerrCount == m_rerrRateLimit)
-    {
-        // Just make sure that the RerrRateLimit timer is running and will expire
-        NS_ASSERT(m_rerrRateLimitTimer.IsRunning());
-        // discard the packet and return
-        NS_LOG_LOGIC("RerrRateLimit reached at "
-                     << Simulator::Now().As(Time::S) << " with timer delay left "
-                     << m_rerrRateLimitTimer.GetDelayLeft().As(Time::S) << "; suppressing RERR");
+    if (m_rateLimitedRerrs.empty() && m_rerrBucket.Consume())
+    {
+        SendRerrToPrecursors(packet, precursors);
         return;
     }
+    DeferRerr(packet, precursors, Ipv4Address());
+}
+
+void
+RoutingProtocol::SendRerrToPrecursors(Ptr<Packet> packet, std::vector<Ipv4Address> precursors)
+{
+    NS_LOG_FUNCTION(this);
     // If there is only one precursor, RERR SHOULD be unicast toward that precursor
     if (precursors.size() == 1)
     {
@@ -2645,7 +4321,6 @@ RoutingProtocol::SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> pr
                                 socket,
                                 packet,
                                 precursors.front());
-            m_rerrCount++;
         }
         return;
     }
@@ -2680,12 +4355,7 @@ RoutingProtocol::SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> pr
         {
             destination = i->GetBroadcast();
         }
-        Simulator::Schedule(Time(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10))),
-                            &RoutingProtocol::SendTo,
-                            this,
-                            socket,
-                            p,
-                            destination);
+        ScheduleBroadcast(socket, p, destination);
     }
 }
 
@@ -2732,10 +4402,18 @@ RoutingProtocol::DoInitialize()
     uint32_t startTime;
     if (m_enableHello)
     {
-        m_htimer.SetFunction(&RoutingProtocol::HelloTimerExpire, this);
+        m_htimer.SetFunction(MakeCallback(&RoutingProtocol::HelloTimerExpire, this));
         startTime = m_uniformRandomVariable->GetInteger(0, 100);
         NS_LOG_DEBUG("Starting at time " << startTime << "ms");
-        m_htimer.Schedule(MilliSeconds(startTime));
+        m_timerWheel.Schedule(m_htimer, MilliSeconds(startTime));
+    }
+    if (OperationRecorder::IsOpen())
+    {
+        uint32_t id = m_ipv4->GetObject<Node>()->GetId();
+        m_routingTable.EnableRecording(id);
+        m_queue.EnableRecording(id);
+        m_rreqIdCache.EnableRecording(id);
+        m_nb.EnableRecording(id);
     }
     Ipv4RoutingProtocol::DoInitialize();
 }
@@ -21,6 +21,9 @@
 #include "raodv-packet.h"
 #include "raodv-rqueue.h"
 #include "raodv-rtable.h"
+#include "raodv-stats.h"
+#include "raodv-timer-wheel.h"
+#include "raodv-token-bucket.h"
 
 #include "ns3/ipv4-interface.h"
 #include "ns3/ipv4-l3-protocol.h"
@@ -28,8 +31,13 @@
 #include "ns3/node.h"
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+#include "ns3/wifi-phy.h"
 
+#include <deque>
 #include <map>
+#include <unordered_set>
+#include <vector>
 
 namespace ns3
 {
@@ -53,6 +61,34 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      */
     static TypeId GetTypeId();
     static const uint32_t RAODV_PORT;
+    /// Maximum payload of one aggregated control datagram in bytes
+    static const uint32_t MAX_AGGREGATE_SIZE;
+    /// Number of received frame RSSI values kept for RREQ distance suppression
+    static const uint32_t RX_RSSI_HISTORY;
+
+    /// Broadcast storm suppression applied to forwarded RREQs
+    enum RreqSuppressionMode
+    {
+        SUPPRESSION_NONE,     ///< Always rebroadcast
+        SUPPRESSION_COUNTER,  ///< Cancel after a number of copies heard during the jitter delay
+        SUPPRESSION_DISTANCE, ///< Cancel after a copy heard from a close (strong RSSI) sender
+    };
+
+    /// Request zone a location-aided route discovery is limited to
+    enum RequestZoneMode
+    {
+        ZONE_NONE,      ///< Flood the whole network, no location extension
+        ZONE_RECTANGLE, ///< Smallest rectangle holding the source and the expected zone
+        ZONE_CONE,      ///< Cone from the source tangent to the expected zone
+    };
+
+    /// Load metric RREQs and reverse requests collect along their path
+    enum PathLoadMode
+    {
+        LOAD_NONE, ///< Select paths by hop count only, no load extension
+        LOAD_SUM,  ///< Sum of the packets queued at the forwarding nodes
+        LOAD_MAX,  ///< Largest number of packets queued at a forwarding node
+    };
 
     /// constructor
     RoutingProtocol();
@@ -192,6 +228,53 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      */
     int64_t AssignStreams(int64_t stream);
 
+    /**
+     * \returns a snapshot of the control plane counters of this node
+     */
+    RoutingStats GetStats() const
+    {
+        return m_stats;
+    }
+
+    /// Set the control plane counters of this node to zero
+    void ResetStats()
+    {
+        m_stats.Reset();
+    }
+
+    /**
+     * \returns the estimated memory held by the routing state of this node
+     */
+    MemoryFootprint GetMemoryFootprint() const;
+
+    /**
+     * TracedCallback signature for control messages sent, received or not rebroadcast.
+     *
+     * \param [in] type The message type.
+     * \param [in] address The destination of a sent message, the sender of a received one or
+     *                     the originator of a flood that is not rebroadcast.
+     */
+    typedef void (*ControlTracedCallback)(MessageType type, Ipv4Address address);
+
+    /**
+     * TracedCallback signature for dropped control messages.
+     *
+     * \param [in] type The message type.
+     * \param [in] reason The drop reason.
+     * \param [in] address The sender of a received message, or the destination of the route a
+     *                     message was not sent for.
+     */
+    typedef void (*DropTracedCallback)(MessageType type, DropReason reason, Ipv4Address address);
+
+    /**
+     * TracedCallback signature for the end of a route discovery for buffered packets.
+     *
+     * \param [in] destination The destination of the buffered packets.
+     * \param [in] latency The time since the first packet was buffered.
+     * \param [in] success False if the buffered packets were dropped.
+     */
+    typedef void (*DiscoveryTracedCallback)(Ipv4Address destination, Time latency, bool success);
+
   protected:
     void DoInitialize() override;
 
@@ -203,6 +286,29 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * \param mpdu the dropped MPDU
      */
     void NotifyTxError(WifiMacDropReason reason, Ptr<const WifiMpdu> mpdu);
+    /**
+     * Remember the signal strength of a received frame.
+     *
+     * \param packet the received MPDU
+     * \param channelFreqMhz the channel frequency
+     * \param txVector the TX vector
+     * \param aMpdu the A-MPDU information
+     * \param signalNoise the signal and noise power
+     * \param staId the STA-ID
+     */
+    void NotifyMonitorSnifferRx(Ptr<const Packet> packet,
+                                uint16_t channelFreqMhz,
+                                WifiTxVector txVector,
+                                MpduInfo aMpdu,
+                                SignalNoiseDbm signalNoise,
+                                uint16_t staId);
+    /**
+     * Get the signal strength the packet was received with.
+     *
+     * \param packet the received packet
+     * \return the RSSI in dBm, or minus infinity if unknown
+     */
+    double GetRxRssi(Ptr<const Packet> packet) const;
 
     // Protocol parameters.
     uint32_t m_rreqRetries; ///< Maximum number of retransmissions of RREQ with TTL = NetDiameter to
@@ -249,6 +355,29 @@ class RoutingProtocol : public Ipv4RoutingProtocol
                              ///< originated route discovery.
     bool m_enableHello;      ///< Indicates whether a hello messages enable
     bool m_enableBroadcast;  ///< Indicates whether a a broadcast data packets forwarding enable
+    bool m_enableCompactHeaders; ///< Indicates whether compact RREQ encoding is advertised and used
+    bool m_enableCoalescing; ///< Indicates whether broadcast control messages are aggregated
+    RreqSuppressionMode m_rreqSuppression; ///< Suppression applied to RREQ rebroadcasts
+    uint32_t m_rreqSuppressionThreshold;   ///< Copies that cancel a rebroadcast (counter mode)
+    double m_rreqSuppressionRssi; ///< RSSI in dBm that cancels a rebroadcast (distance mode)
+    uint32_t m_revRreqRingSlack;  ///< Hops a reverse request may travel beyond the RREQ hop count
+    double m_revRreqGossipProbability; ///< Rebroadcast probability of a reverse request
+    uint32_t m_revRreqGossipHops; ///< Hops around the destination that always rebroadcast
+    bool m_enableLocalRepair;     ///< Indicates whether broken routes are repaired locally
+    uint32_t m_localRepairHops;   ///< Maximum hops to the destination for a local repair
+    Time m_localRepairTimeout;    ///< Time a local repair may take before the RERR is sent
+    uint32_t m_maxBackupRoutes;   ///< Backup next hops kept per destination
+    RequestZoneMode m_requestZone; ///< Request zone applied to RREQ and reverse request floods
+    double m_requestZoneMargin;    ///< Distance in meters added around the expected zone
+    bool m_adaptiveDiscovery; ///< Indicates whether TTLs and timeouts follow observed paths
+    bool m_enableRouteRefresh; ///< Indicates whether routes of paused flows are refreshed
+    Time m_routeRefreshLead;   ///< Time before route expiry at which a refresh is sent
+    bool m_linkBreakPrediction; ///< Indicates whether link breaks are predicted from the RSSI
+    double m_linkBreakRssi;     ///< Signal strength in dBm below which a link is broken
+    Time m_linkBreakHorizon;    ///< Time ahead a link break triggers preemptive action
+    PathLoadMode m_pathLoad;    ///< Load metric collected by RREQs and reverse requests
+    uint32_t m_pathLoadPerHop;  ///< Path load that costs as much as one extra hop
+    Time m_pathLoadWindow;      ///< Time candidate paths are collected before one is chosen
 
     /// IP protocol
     Ptr<Ipv4> m_ipv4;
@@ -257,6 +386,10 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     /// Raw subnet directed broadcast socket per each IP interface, map socket -> iface address (IP
     /// + mask)
     std::map<Ptr<Socket>, Ipv4InterfaceAddress> m_socketSubnetBroadcastAddresses;
+    /// Local addresses of the raodv interfaces
+    std::unordered_set<Ipv4Address, Ipv4AddressHash> m_localAddresses;
+    /// raodv interface address indexed by IP interface; unset for interfaces raodv does not use
+    std::vector<Ipv4InterfaceAddress> m_interfaceAddresses;
     /// Loopback device used to defer RREQ until packet will be fully formed
     Ptr<NetDevice> m_lo;
 
@@ -271,14 +404,32 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     uint32_t m_seqNo;
     /// Handle duplicated RREQ
     IdCache m_rreqIdCache;
+    /// Handle duplicated reverse RREQ
+    IdCache m_revRreqIdCache;
     /// Handle duplicated broadcast/multicast packets
     DuplicatePacketDetection m_dpd;
     /// Handle neighbors
     Neighbors m_nb;
-    /// Number of RREQs used for RREQ rate control
-    uint16_t m_rreqCount;
-    /// Number of RERRs used for RERR rate control
-    uint16_t m_rerrCount;
+    /// Token bucket used for RREQ rate control
+    TokenBucket m_rreqBucket;
+    /// Token bucket used for RERR rate control
+    TokenBucket m_rerrBucket;
+    /// Destinations whose RREQ waits for a token, in FIFO order and without duplicates
+    std::deque<Ipv4Address> m_rateLimitedRreqs;
+    /// Destinations of m_rateLimitedRreqs, for the duplicate check
+    std::unordered_set<Ipv4Address, Ipv4AddressHash> m_rateLimitedRreqDsts;
+
+    /// RERR waiting for a token
+    struct RateLimitedRerr
+    {
+        Ptr<Packet> m_packet;                  ///< RERR packet
+        std::vector<Ipv4Address> m_precursors; ///< Precursors, empty for a RERR to the source
+        Ipv4Address m_origin;                  ///< Source of the data packet without route
+    };
+
+    /// RERRs waiting for a token, in FIFO order. A RERR to the same recipients as a queued one
+    /// with a common unreachable destination is merged into it.
+    std::deque<RateLimitedRerr> m_rateLimitedRerrs;
 
   private:
     /// Start protocol operation
@@ -314,6 +465,30 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * \param dst the destination IP address
      */
     void ScheduleRreqRetry(Ipv4Address dst);
+    /**
+     * Record the hop count of a path this node learned, for adaptive discovery
+     * \param dst the destination of the path
+     * \param hops the hop count
+     */
+    void ObserveHopCount(Ipv4Address dst, uint16_t hops);
+    /**
+     * Record the round trip time of a completed route discovery, for adaptive discovery
+     * \param dst the destination IP address
+     * \param id the RREQ ID the answer was for
+     * \param hops the hop count of the discovered route
+     */
+    void ObserveDiscovery(Ipv4Address dst, uint32_t id, uint16_t hops);
+    /**
+     * Get the TTL of a network wide RREQ
+     * \param rreqCnt the network wide attempts already made for the destination
+     * \returns the diameter estimate on the first attempt with adaptive discovery,
+     * NetDiameter otherwise
+     */
+    uint16_t GetDiscoveryDiameter(uint32_t rreqCnt) const;
+    /**
+     * \returns the per hop latency estimate with adaptive discovery, NodeTraversalTime otherwise
+     */
+    Time GetNodeTraversalEstimate() const;
     /**
      * Set lifetime field in routing table entry to the maximum of existing lifetime and lt, if the
      * entry exists
@@ -335,6 +510,11 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * \returns true if the IP address is the node's IP address
      */
     bool IsMyOwnAddress(Ipv4Address src);
+    /**
+     * Rebuild m_localAddresses and m_interfaceAddresses from m_socketAddresses.
+     * Called whenever an interface goes up or down or an address is added or removed.
+     */
+    void UpdateAddressCache();
     /**
      * Find unicast socket with local interface address iface
      *
@@ -371,9 +551,17 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      */
     /**
      * Receive and process control packet
+     * \param interface IP interface the socket is bound to
      * \param socket input socket
      */
-    void RecvRaodv(Ptr<Socket> socket);
+    void RecvRaodv(uint32_t interface, Ptr<Socket> socket);
+    /**
+     * Process one control message, or each record of an aggregated datagram
+     * \param packet packet starting with the TypeHeader
+     * \param receiver receiver address
+     * \param sender sender address
+     */
+    void DispatchRaodv(Ptr<Packet> packet, Ipv4Address receiver, Ipv4Address sender);
     /**
      * Receive RREQ
      * \param p packet
@@ -381,6 +569,24 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * \param src sender address
      */
     void RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src);
+    /**
+     * Create or update the reverse route to the originator of a RREQ
+     * \param rreqHeader route request header, with the hop count already incremented
+     * \param receiver receiver address
+     * \param src sender address
+     * \param load path load of the RREQ
+     */
+    void UpdateReverseRoute(const RreqHeader& rreqHeader,
+                            Ipv4Address receiver,
+                            Ipv4Address src,
+                            uint32_t load);
+    /**
+     * Receive a RREQ unicast along an existing route to refresh it
+     * \param p packet
+     * \param receiver receiver address
+     * \param src sender address
+     */
+    void RecvRefreshRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src);
     /**
      * Receive RREP
      * \param p packet
@@ -417,6 +623,47 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * \param dst destination address
      */
     void SendRequest(Ipv4Address dst);
+    /** Broadcast RREQ once the rate limit allows it
+     * \param dst destination address
+     */
+    void OriginateRequest(Ipv4Address dst);
+    /**
+     * Try to repair a broken route from this node with a TTL limited RREQ
+     * \param dst destination address
+     * \returns true if the repair was started, false if a RERR must be sent instead
+     */
+    bool StartLocalRepair(Ipv4Address dst);
+    /** Rebroadcast RREQ on all interfaces
+     * \param rreqHeader route request header
+     * \param ttl IP TTL of the rebroadcast
+     * \param jitter add the usual random jitter before sending
+     * \param extensions extensions to send after the header, or nullptr
+     */
+    void ForwardRequest(const RreqHeader& rreqHeader,
+                        uint8_t ttl,
+                        bool jitter,
+                        Ptr<const Packet> extensions);
+    /** Delay the rebroadcast of a RREQ by a random jitter so it can be suppressed
+     * \param rreqHeader route request header
+     * \param ttl IP TTL of the rebroadcast
+     * \param rssi signal strength of the first copy in dBm
+     * \param extensions extensions to send after the header, or nullptr
+     */
+    void ScheduleRequestForward(const RreqHeader& rreqHeader,
+                                uint8_t ttl,
+                                double rssi,
+                                Ptr<Packet> extensions);
+    /** Rebroadcast a delayed RREQ that was not suppressed
+     * \param origin RREQ originator
+     * \param id RREQ ID
+     */
+    void SendPendingRequestForward(Ipv4Address origin, uint32_t id);
+    /** Account a duplicate RREQ copy and cancel the pending rebroadcast if suppressed
+     * \param origin RREQ originator
+     * \param id RREQ ID
+     * \param rssi signal strength of the copy in dBm
+     */
+    void SuppressRequestForward(Ipv4Address origin, uint32_t id, double rssi);
     /** Send RREP
      * \param rreqHeader route request header
      * \param toOrigin routing table entry to originator
@@ -438,11 +685,29 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * \param nextHop next hop address
      */
     void SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop);
+    /**
+     * Switch a route to its best backup whose next hop is still a valid neighbor
+     * \param rt the route, updated in place and in the routing table on success
+     * \returns true if the route failed over
+     */
+    bool FailOver(RoutingTableEntry& rt);
+    /**
+     * Fail over the routes that became unreachable through a next hop. The routes that failed
+     * over are removed from unreachable, so no RERR is sent for them.
+     * \param nextHop the next hop the routes can no longer use
+     * \param unreachable the destinations using nextHop and their sequence numbers
+     */
+    void FailOverRoutes(Ipv4Address nextHop, std::map<Ipv4Address, uint32_t>& unreachable);
     /** Forward RERR
      * \param packet packet
      * \param precursors list of addresses of the visited nodes
      */
     void SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> precursors);
+    /** Send RERR to precursors once the rate limit allows it
+     * \param packet packet
+     * \param precursors list of addresses of the visited nodes
+     */
+    void SendRerrToPrecursors(Ptr<Packet> packet, std::vector<Ipv4Address> precursors);
     /**
      * Send RERR message when no route to forward input packet. Unicast if there is reverse route to
      * originating node, broadcast otherwise.
@@ -451,6 +716,23 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * \param origin originating node IP address
      */
     void SendRerrWhenNoRouteToForward(Ipv4Address dst, uint32_t dstSeqNo, Ipv4Address origin);
+    /**
+     * Send RERR towards the source of a data packet once the rate limit allows it
+     * \param packet packet
+     * \param origin originating node IP address
+     */
+    void SendRerrToSource(Ptr<Packet> packet, Ipv4Address origin);
+    /**
+     * Queue RERR until a token is available. If a queued RERR goes to the same recipients and
+     * shares an unreachable destination, the two are merged: the union of their destinations,
+     * with the sequence numbers of the newer one, is sent to the union of their precursors.
+     * \param packet packet
+     * \param precursors list of addresses of the visited nodes, empty to send to the source
+     * \param origin originating node IP address
+     */
+    void DeferRerr(Ptr<Packet> packet,
+                   const std::vector<Ipv4Address>& precursors,
+                   Ipv4Address origin);
     /** @} */
 
     /**
@@ -460,28 +742,256 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * \param destination destination node IP address
      */
     void SendTo(Ptr<Socket> socket, Ptr<Packet> packet, Ipv4Address destination);
+    /**
+     * Send broadcast control packet after a random jitter, joining the batch already
+     * pending on the same socket if coalescing is in use
+     * \param socket interface socket
+     * \param packet packet to send
+     * \param destination broadcast address
+     */
+    void ScheduleBroadcast(Ptr<Socket> socket, Ptr<Packet> packet, Ipv4Address destination);
+    /**
+     * Send broadcast control packet after the given delay, joining the batch already
+     * pending on the same socket if coalescing is in use
+     * \param socket interface socket
+     * \param packet packet to send
+     * \param destination broadcast address
+     * \param jitter delay before sending
+     */
+    void ScheduleBroadcast(Ptr<Socket> socket,
+                           Ptr<Packet> packet,
+                           Ipv4Address destination,
+                           Time jitter);
+    /**
+     * Send the control packets batched on a socket as aggregated datagrams
+     * \param socket interface socket
+     */
+    void FlushBroadcasts(Ptr<Socket> socket);
+    /**
+     * Add the aggregate type header and send
+     * \param socket interface socket
+     * \param aggregate concatenated records
+     * \param destination broadcast address
+     */
+    void SendAggregate(Ptr<Socket> socket, Ptr<Packet> aggregate, Ipv4Address destination);
+    /**
+     * Add RREQ and type headers, using the compact encoding if all neighbors accept it
+     * \param packet packet to fill
+     * \param rreqHeader route request header
+     * \param ipSrc IP source address the packet will be sent from
+     */
+    void AddRequestHeaders(Ptr<Packet> packet, const RreqHeader& rreqHeader, Ipv4Address ipSrc);
+    /**
+     * Add reverse RREQ and type headers, using the compact encoding if all neighbors accept it
+     * \param packet packet to fill
+     * \param revRreqHeader reverse route request header
+     * \param ipSrc IP source address the packet will be sent from
+     */
+    void AddRevRequestHeaders(Ptr<Packet> packet,
+                              const RevRreqHeader& revRreqHeader,
+                              Ipv4Address ipSrc);
     void RecvRevRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sender);
     void SendReplytoAll(const RreqHeader& rreqHeader, const RoutingTableEntry& toOrigin);
+    /**
+     * Get the position and speed of this node from its mobility model
+     * \param position the position
+     * \param speed the speed in m/s
+     * \returns false if the node has no mobility model
+     */
+    bool GetOwnLocation(Vector& position, double& speed) const;
+    /**
+     * Create the location extension a flood started by this node carries
+     * \param target the node the flood looks for
+     * \param zone limit the flood to a request zone if the location of target is known
+     * \returns a packet holding the extension, or nullptr if location-aided discovery is off
+     */
+    Ptr<Packet> CreateLocationExtension(Ipv4Address target, bool zone) const;
+    /**
+     * Read the location extension trailing a RREQ or reverse request and learn the location of
+     * the node that started the flood
+     * \param p the packet after the RREQ or reverse request header was removed
+     * \param source the node that started the flood
+     * \returns a packet holding the extension to forward, or nullptr if there is none
+     */
+    Ptr<Packet> ReadLocationExtension(Ptr<const Packet> p, Ipv4Address source);
+    /**
+     * Check whether this node lies in the request zone of a flood
+     * \param extension the location extension of the flood, or nullptr
+     * \returns true if the flood is not limited or this node is inside the zone
+     */
+    bool IsInRequestZone(Ptr<const Packet> extension) const;
+
+    /// Last known location of a node
+    struct NodeLocation
+    {
+        Vector m_position; ///< Position in meters
+        double m_speed;    ///< Speed in m/s
+        Time m_time;       ///< Time the position was measured
+    };
+
+    /// Last known location per node, learned from location extensions
+    std::map<Ipv4Address, NodeLocation> m_locations;
+
+    /**
+     * Get the number of packets waiting in the interface queues of this node
+     * \returns the packets in the Wi-Fi MAC queues and root queue discs of the raodv interfaces
+     */
+    uint32_t GetQueueLoad() const;
+    /**
+     * Add the load of this node to the path load of a message it forwards
+     * \param load the path load received
+     * \returns the path load to forward
+     */
+    uint32_t AccumulateLoad(uint32_t load) const;
+    /**
+     * Remove the load extension leading the extensions of a RREQ or reverse request
+     * \param p the packet after the RREQ or reverse request header was removed
+     * \param load the path load, unchanged if there is no extension
+     * \returns true if the packet carried a load extension
+     */
+    bool ReadLoadExtension(Ptr<Packet> p, uint32_t& load) const;
+    /**
+     * Put a load extension in front of the other extensions of a flood
+     * \param extensions the other extensions, or nullptr
+     * \param load the path load
+     * \returns a packet holding all extensions
+     */
+    Ptr<Packet> AddLoadExtension(Ptr<const Packet> extensions, uint32_t load) const;
+    /**
+     * Get the cost paths are compared by
+     * \param hops the hop count
+     * \param load the path load
+     * \returns the hop count, plus the path load in hops if the load metric is on
+     */
+    double GetPathCost(uint16_t hops, uint32_t load) const;
+    /**
+     * Reconsider the reverse route of a discovery answered by this node with a later RREQ copy
+     * \param p the packet after the RREQ header was removed
+     * \param rreqHeader the RREQ header
+     * \param receiver the address of the receiver
+     * \param src the previous hop
+     */
+    void SelectReverseRoute(Ptr<Packet> p,
+                            RreqHeader rreqHeader,
+                            Ipv4Address receiver,
+                            Ipv4Address src);
+    /**
+     * Collect a path a reverse request offers for a discovery of this node
+     * \param candidate the route along the path
+     * \param id the reverse request ID
+     * \returns false if no discovery is waiting for the destination
+     */
+    bool CollectPath(const RoutingTableEntry& candidate, uint32_t id);
+    /**
+     * Install the cheapest collected path, keep the others as backups and send the queued packets
+     * \param dst the destination IP address
+     */
+    void PathSelectionTimerExpire(Ipv4Address dst);
 
+    /// RREQ ID and end of the collection window per originator of a discovery answered here
+    std::map<Ipv4Address, std::pair<uint32_t, Time>> m_reverseSelections;
+    /// Paths collected per destination of a discovery of this node
+    std::map<Ipv4Address, std::vector<RoutingTableEntry>> m_pathSelections;
+    /// Map IP address + path selection timer.
+    std::map<Ipv4Address, WheelTimer> m_pathSelectionTimer;
+
+    /// Last known hop count per destination
+    std::map<Ipv4Address, uint16_t> m_hopHistory;
+    /// Running estimate of the network diameter in hops, zero before the first observation
+    double m_diameterEstimate;
+    /// RREQ ID and send time of the last attempt per destination
+    std::map<Ipv4Address, std::pair<uint32_t, Time>> m_discoveryAttempts;
+    /// Smoothed per hop latency of route discoveries, zero before the first sample
+    Time m_hopLatency;
+    /// Variation of the per hop latency
+    Time m_hopLatencyVar;
+
+    /// Timing wheel the protocol timers below are multiplexed on
+    TimerWheel m_timerWheel;
+    /**
+     * Set the resolution of the timing wheel
+     * \param tick the resolution, zero to give every timer its own event
+     */
+    void SetTimerWheelTick(Time tick);
+    /**
+     * \returns the resolution of the timing wheel
+     */
+    Time GetTimerWheelTick() const;
     /// Hello timer
-    Timer m_htimer;
+    WheelTimer m_htimer;
     /// Schedule next send of hello message
     void HelloTimerExpire();
-    /// RREQ rate limit timer
-    Timer m_rreqRateLimitTimer;
-    /// Reset RREQ count and schedule RREQ rate limit timer with delay 1 sec.
+    /// Neighbor list purge timer
+    WheelTimer m_nbPurgeTimer;
+    /// Purge the neighbor list and schedule the next purge after one hello interval
+    void NeighborPurgeTimerExpire();
+    /// RREQ rate limit timer, runs while RREQs wait for a token
+    WheelTimer m_rreqRateLimitTimer;
+    /// Send the rate limited RREQs the bucket has tokens for and reschedule for the rest.
     void RreqRateLimitTimerExpire();
-    /// RERR rate limit timer
-    Timer m_rerrRateLimitTimer;
-    /// Reset RERR count and schedule RERR rate limit timer with delay 1 sec.
+    /// RERR rate limit timer, runs while RERRs wait for a token
+    WheelTimer m_rerrRateLimitTimer;
+    /// Send the rate limited RERRs the bucket has tokens for and reschedule for the rest.
     void RerrRateLimitTimerExpire();
     /// Map IP address + RREQ timer.
-    std::map<Ipv4Address, Timer> m_addressReqTimer;
+    std::map<Ipv4Address, WheelTimer> m_addressReqTimer;
     /**
      * Handle route discovery process
      * \param dst the destination IP address
      */
     void RouteRequestTimerExpire(Ipv4Address dst);
+    /// Map IP address + local repair timer.
+    std::map<Ipv4Address, WheelTimer> m_localRepairTimer;
+    /**
+     * Give up a local repair: drop the buffered packets and send the deferred RERR
+     * \param dst the destination IP address
+     */
+    void LocalRepairTimerExpire(Ipv4Address dst);
+
+    /// Traffic this node originates towards a destination
+    struct FlowActivity
+    {
+        Time m_lastPacket; ///< Time of the last packet
+        Time m_longestGap; ///< Longest gap between two packets so far
+    };
+
+    /// Flows this node originates over multi-hop routes, tracked for route refresh
+    std::map<Ipv4Address, FlowActivity> m_flows;
+    /// Map IP address + route refresh timer.
+    std::map<Ipv4Address, WheelTimer> m_routeRefreshTimer;
+    /**
+     * Account a packet this node originates and arm the route refresh timer
+     * \param dst the destination IP address
+     */
+    void TrackFlow(Ipv4Address dst);
+    /**
+     * Refresh the route if it is about to expire while its flow is paused but likely to resume
+     * \param dst the destination IP address
+     */
+    void RouteRefreshTimerExpire(Ipv4Address dst);
+    /**
+     * Unicast a RREQ along the route to refresh it before it expires
+     * \param toDst routing table entry to destination
+     */
+    void SendRefreshRequest(const RoutingTableEntry& toDst);
+    /**
+     * Create a RREQ for a destination this node still has a route to. It asks for a newer
+     * destination sequence number, so the answer replaces the route on every hop.
+     * \param toDst routing table entry to destination
+     * \returns the RREQ header
+     */
+    RreqHeader CreateRefreshHeader(const RoutingTableEntry& toDst);
+    /**
+     * Move the routes through a neighbor whose link is predicted to break to a backup, or look
+     * for a new route while the old one still works
+     * \param neighbor the neighbor address
+     */
+    void LinkBreakPredicted(Ipv4Address neighbor);
+    /**
+     * Broadcast a RREQ for a destination whose route is about to break, without invalidating it
+     * \param toDst routing table entry to destination
+     */
+    void SendPreemptiveRequest(const RoutingTableEntry& toDst);
     /**
      * Mark link to neighbor node as unidirectional for blacklistTimeout
      *
@@ -494,6 +1004,77 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     Ptr<UniformRandomVariable> m_uniformRandomVariable;
     /// Keep track of the last bcast time
     Time m_lastBcastTime;
+    /// Broadcast control packets waiting for the end of a jitter window
+    struct PendingBroadcast
+    {
+        std::vector<Ptr<Packet>> m_packets; ///< Messages in send order
+        Ipv4Address m_destination;          ///< Broadcast address of the interface
+        EventId m_flush;                    ///< Scheduled FlushBroadcasts
+    };
+
+    /// RREQ rebroadcast waiting out its jitter delay
+    struct PendingRreqForward
+    {
+        RreqHeader m_header; ///< Header to rebroadcast
+        Ptr<Packet> m_extensions; ///< Extensions to rebroadcast after the header, or nullptr
+        uint8_t m_ttl;       ///< IP TTL of the rebroadcast
+        uint32_t m_copies;   ///< Copies heard so far, including the first
+        EventId m_forward;   ///< Scheduled SendPendingRequestForward
+    };
+
+    /// Pending RREQ rebroadcasts by (origin, RREQ ID)
+    std::map<std::pair<Ipv4Address, uint32_t>, PendingRreqForward> m_pendingRreqForwards;
+    /// (packet UID, RSSI in dBm) of the last received frames
+    std::deque<std::pair<uint64_t, double>> m_rxRssi;
+    /// Pending batch per interface socket
+    std::map<Ptr<Socket>, PendingBroadcast> m_pendingBroadcasts;
+    /// Trace of every control packet handed to a socket
+    TracedCallback<Ptr<const Packet>> m_txControlTrace;
+    /// Control plane counters
+    RoutingStats m_stats;
+    /// Trace of every control message sent, alone or in an aggregate
+    TracedCallback<MessageType, Ipv4Address> m_txTrace;
+    /// Trace of every control message received
+    TracedCallback<MessageType, Ipv4Address> m_rxTrace;
+    /// Trace of RREQ and reverse request rebroadcasts skipped
+    TracedCallback<MessageType, Ipv4Address> m_suppressTrace;
+    /// Trace of control messages dropped
+    TracedCallback<MessageType, DropReason, Ipv4Address> m_dropTrace;
+    /**
+     * Count and trace a control message sent
+     * \param type the message type
+     * \param destination the destination address
+     */
+    void TraceTx(MessageType type, Ipv4Address destination);
+    /**
+     * Count and trace a control message received
+     * \param type the message type
+     * \param sender the sender address
+     */
+    void TraceRx(MessageType type, Ipv4Address sender);
+    /**
+     * Count and trace a rebroadcast that is skipped
+     * \param type the message type
+     * \param origin the originator of the flood
+     */
+    void TraceSuppressed(MessageType type, Ipv4Address origin);
+    /**
+     * Count and trace a dropped control message
+     * \param type the message type
+     * \param reason the drop reason
+     * \param address the sender, or the destination of the route
+     */
+    void TraceDrop(MessageType type, DropReason reason, Ipv4Address address);
+    /// Time the first packet to each destination was buffered for a route discovery
+    std::map<Ipv4Address, Time> m_discoveryStart;
+    /// Trace of route discoveries for buffered packets that ended
+    TracedCallback<Ipv4Address, Time, bool> m_discoveryTrace;
+    /**
+     * Record and trace the end of the route discovery for the packets buffered to a destination
+     * \param dst the destination
+     * \param success true if the first packet is sent, false if the packets are dropped
+     */
+    void EndDiscovery(Ipv4Address dst, bool success);
 };
 
 } // namespace raodv
@@ -16,12 +16,14 @@
 #include "raodv-rqueue.h"
 
 #include "ns3/ipv4-route.h"
-#include "ns3/log.h"
 #include "ns3/socket.h"
 
 #include <algorithm>
 #include <functional>
 
+// Last, so that only the log statements of this file are affected
+#include "raodv-log.h"
+
 namespace ns3
 {
 
@@ -36,9 +38,27 @@ RequestQueue::GetSize()
     return m_queue.size();
 }
 
+uint64_t
+RequestQueue::GetMemoryUsage() const
+{
+    uint64_t bytes = m_queue.capacity() * sizeof(QueueEntry);
+    for (const QueueEntry& entry : m_queue)
+    {
+        bytes += sizeof(Packet) + entry.GetPacket()->GetSize();
+    }
+    return bytes;
+}
+
 bool
 RequestQueue::Enqueue(QueueEntry& entry)
 {
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance,
+                                  OP_RQ_ENQUEUE,
+                                  entry.GetIpv4Header().GetDestination(),
+                                  entry.GetPacket()->GetUid());
+    }
     Purge();
     for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
     {
@@ -62,6 +82,10 @@ void
 RequestQueue::DropPacketWithDst(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_RQ_DROP, dst);
+    }
     Purge();
     for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
     {
@@ -79,6 +103,10 @@ RequestQueue::DropPacketWithDst(Ipv4Address dst)
 bool
 RequestQueue::Dequeue(Ipv4Address dst, QueueEntry& entry)
 {
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_RQ_DEQUEUE, dst);
+    }
     Purge();
     for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
     {
@@ -95,6 +123,10 @@ RequestQueue::Dequeue(Ipv4Address dst, QueueEntry& entry)
 bool
 RequestQueue::Find(Ipv4Address dst)
 {
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_RQ_FIND, dst);
+    }
     for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
     {
         if (i->GetIpv4Header().GetDestination() == dst)
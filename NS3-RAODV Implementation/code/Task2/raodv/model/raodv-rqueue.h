@@ -16,6 +16,8 @@
 #ifndef RAODV_RQUEUE_H
 #define RAODV_RQUEUE_H
 
+#include "raodv-op-recorder.h"
+
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/simulator.h"
 
@@ -193,7 +195,9 @@ class RequestQueue
      */
     RequestQueue(uint32_t maxLen, Time routeToQueueTimeout)
         : m_maxLen(maxLen),
-          m_queueTimeout(routeToQueueTimeout)
+          m_queueTimeout(routeToQueueTimeout),
+          m_record(false),
+          m_recordInstance(0)
     {
     }
 
@@ -228,6 +232,11 @@ class RequestQueue
      * \returns the number of entries
      */
     uint32_t GetSize();
+    /**
+     * Estimate the memory held by the queue: the entry storage and the buffered packets
+     * \returns the estimate in bytes
+     */
+    uint64_t GetMemoryUsage() const;
 
     // Fields
     /**
@@ -266,6 +275,16 @@ class RequestQueue
         m_queueTimeout = t;
     }
 
+    /**
+     * Record every operation with OperationRecorder
+     * \param instance the node owning the queue
+     */
+    void EnableRecording(uint32_t instance)
+    {
+        m_record = true;
+        m_recordInstance = instance;
+    }
+
   private:
     /// The queue
     std::vector<QueueEntry> m_queue;
@@ -282,6 +301,10 @@ class RequestQueue
     /// The maximum period of time that a routing protocol is allowed to buffer a packet for,
     /// seconds.
     Time m_queueTimeout;
+    /// Record operations with OperationRecorder
+    bool m_record;
+    /// Node written in the records
+    uint32_t m_recordInstance;
 };
 
 } // namespace raodv
@@ -16,12 +16,16 @@
 
 #include "raodv-rtable.h"
 
-#include "ns3/log.h"
+#include "raodv-profiler.h"
+
 #include "ns3/simulator.h"
 
 #include <algorithm>
 #include <iomanip>
 
+// Last, so that only the log statements of this file are affected
+#include "raodv-log.h"
+
 namespace ns3
 {
 
@@ -46,6 +50,7 @@ RoutingTableEntry::RoutingTableEntry(Ptr<NetDevice> dev,
       m_validSeqNo(vSeqNo),
       m_seqNo(seqNo),
       m_hops(hops),
+      m_pathLoad(0),
       m_lifeTime(lifetime + Simulator::Now()),
       m_iface(iface),
       m_flag(VALID),
@@ -152,6 +157,124 @@ RoutingTableEntry::GetPrecursors(std::vector<Ipv4Address>& prec) const
     }
 }
 
+bool
+RoutingTableEntry::AddBackup(const RoutingTableEntry& rt, uint32_t maxBackups)
+{
+    NS_LOG_FUNCTION(this << rt.GetNextHop() << maxBackups);
+    if (maxBackups == 0 || rt.GetFlag() != VALID || rt.GetNextHop() == GetNextHop() ||
+        int32_t(rt.GetSeqNo() - m_seqNo) < 0)
+    {
+        return false;
+    }
+    BackupRoute backup = {rt.GetOutputDevice(),
+                          rt.GetInterface(),
+                          rt.GetNextHop(),
+                          rt.GetHop(),
+                          rt.GetSeqNo(),
+                          rt.m_lifeTime};
+    auto better = [](const BackupRoute& a, const BackupRoute& b) {
+        int32_t fresher = int32_t(a.m_seqNo - b.m_seqNo);
+        if (fresher != 0)
+        {
+            return fresher > 0;
+        }
+        return a.m_hops < b.m_hops;
+    };
+    auto i = std::find_if(m_backups.begin(), m_backups.end(), [&](const BackupRoute& b) {
+        return b.m_nextHop == backup.m_nextHop;
+    });
+    if (i != m_backups.end())
+    {
+        // An equally good path refreshes the backup's lifetime
+        if (better(*i, backup) && i->m_expire > Simulator::Now())
+        {
+            return false;
+        }
+        m_backups.erase(i);
+    }
+    auto pos = std::upper_bound(m_backups.begin(), m_backups.end(), backup, better);
+    if (static_cast<uint32_t>(pos - m_backups.begin()) >= maxBackups)
+    {
+        return false;
+    }
+    m_backups.insert(pos, backup);
+    if (m_backups.size() > maxBackups)
+    {
+        m_backups.resize(maxBackups);
+    }
+    NS_LOG_LOGIC("Backup via " << backup.m_nextHop << " to " << GetDestination() << ", "
+                               << m_backups.size() << " backups");
+    return true;
+}
+
+void
+RoutingTableEntry::InheritBackups(const RoutingTableEntry& rt, uint32_t maxBackups)
+{
+    NS_LOG_FUNCTION(this << maxBackups);
+    AddBackup(rt, maxBackups);
+    for (auto i = rt.m_backups.begin(); i != rt.m_backups.end(); ++i)
+    {
+        RoutingTableEntry backup(i->m_dev,
+                                 GetDestination(),
+                                 true,
+                                 i->m_seqNo,
+                                 i->m_iface,
+                                 i->m_hops,
+                                 i->m_nextHop,
+                                 i->m_expire - Simulator::Now());
+        AddBackup(backup, maxBackups);
+    }
+}
+
+bool
+RoutingTableEntry::PromoteBackup()
+{
+    NS_LOG_FUNCTION(this);
+    auto expired = std::remove_if(m_backups.begin(), m_backups.end(), [](const BackupRoute& b) {
+        return b.m_expire <= Simulator::Now();
+    });
+    m_backups.erase(expired, m_backups.end());
+    if (m_backups.empty())
+    {
+        return false;
+    }
+    BackupRoute backup = m_backups.front();
+    m_backups.erase(m_backups.begin());
+    NS_LOG_LOGIC("Route to " << GetDestination() << " fails over from " << GetNextHop() << " to "
+                             << backup.m_nextHop);
+    // Packets in flight may still hold the old route, so it is not modified in place
+    Ptr<Ipv4Route> route = Create<Ipv4Route>();
+    route->SetDestination(GetDestination());
+    route->SetGateway(backup.m_nextHop);
+    route->SetSource(backup.m_iface.GetLocal());
+    route->SetOutputDevice(backup.m_dev);
+    m_ipv4Route = route;
+    m_iface = backup.m_iface;
+    m_hops = backup.m_hops;
+    m_pathLoad = 0;
+    m_seqNo = backup.m_seqNo;
+    m_validSeqNo = true;
+    m_lifeTime = backup.m_expire;
+    m_flag = VALID;
+    m_reqCount = 0;
+    return true;
+}
+
+bool
+RoutingTableEntry::DeleteBackup(Ipv4Address nextHop)
+{
+    NS_LOG_FUNCTION(this << nextHop);
+    auto i = std::remove_if(m_backups.begin(), m_backups.end(), [&](const BackupRoute& b) {
+        return b.m_nextHop == nextHop;
+    });
+    if (i == m_backups.end())
+    {
+        return false;
+    }
+    m_backups.erase(i, m_backups.end());
+    return true;
+}
+
 void
 RoutingTableEntry::Invalidate(Time badLinkLifetime)
 {
@@ -209,12 +332,26 @@ RoutingTableEntry::Print(Ptr<OutputStreamWrapper> stream, Time::Unit unit /* = T
     (*os).copyfmt(oldState);
 }
 
+uint64_t
+RoutingTableEntry::GetMemoryUsage() const
+{
+    uint64_t bytes = m_precursorList.capacity() * sizeof(Ipv4Address) +
+                     m_backups.capacity() * sizeof(BackupRoute);
+    if (m_ipv4Route)
+    {
+        bytes += sizeof(Ipv4Route);
+    }
+    return bytes;
+}
+
 /*
  The Routing Table
  */
 
 RoutingTable::RoutingTable(Time t)
-    : m_badLinkLifetime(t)
+    : m_badLinkLifetime(t),
+      m_record(false),
+      m_recordInstance(0)
 {
 }
 
@@ -222,6 +359,10 @@ bool
 RoutingTable::LookupRoute(Ipv4Address id, RoutingTableEntry& rt)
 {
     NS_LOG_FUNCTION(this << id);
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_RT_LOOKUP, id);
+    }
     Purge();
     if (m_ipv4AddressEntry.empty())
     {
@@ -257,6 +398,10 @@ bool
 RoutingTable::DeleteRoute(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_RT_DELETE, dst);
+    }
     Purge();
     if (m_ipv4AddressEntry.erase(dst) != 0)
     {
@@ -271,6 +416,13 @@ bool
 RoutingTable::AddRoute(RoutingTableEntry& rt)
 {
     NS_LOG_FUNCTION(this);
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance,
+                                  OP_RT_ADD,
+                                  rt.GetDestination(),
+                                  OperationRecorder::PackRoute(rt.GetLifeTime(), rt.GetFlag()));
+    }
     Purge();
     if (rt.GetFlag() != IN_SEARCH)
     {
@@ -284,6 +436,13 @@ bool
 RoutingTable::Update(RoutingTableEntry& rt)
 {
     NS_LOG_FUNCTION(this);
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance,
+                                  OP_RT_UPDATE,
+                                  rt.GetDestination(),
+                                  OperationRecorder::PackRoute(rt.GetLifeTime(), rt.GetFlag()));
+    }
     auto i = m_ipv4AddressEntry.find(rt.GetDestination());
     if (i == m_ipv4AddressEntry.end())
     {
@@ -303,6 +462,10 @@ bool
 RoutingTable::SetEntryState(Ipv4Address id, RouteFlags state)
 {
     NS_LOG_FUNCTION(this);
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_RT_SET_STATE, id, state);
+    }
     auto i = m_ipv4AddressEntry.find(id);
     if (i == m_ipv4AddressEntry.end())
     {
@@ -320,6 +483,10 @@ RoutingTable::GetListOfDestinationWithNextHop(Ipv4Address nextHop,
                                               std::map<Ipv4Address, uint32_t>& unreachable)
 {
     NS_LOG_FUNCTION(this);
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_RT_NEXT_HOP_SCAN, nextHop);
+    }
     Purge();
     unreachable.clear();
     for (auto i = m_ipv4AddressEntry.begin(); i != m_ipv4AddressEntry.end(); ++i)
@@ -336,6 +503,14 @@ void
 RoutingTable::InvalidateRoutesWithDst(const std::map<Ipv4Address, uint32_t>& unreachable)
 {
     NS_LOG_FUNCTION(this);
+    if (m_record)
+    {
+        uint32_t left = unreachable.size();
+        for (auto j = unreachable.begin(); j != unreachable.end(); ++j)
+        {
+            OperationRecorder::Record(m_recordInstance, OP_RT_INVALIDATE, j->first, left--);
+        }
+    }
     Purge();
     for (auto i = m_ipv4AddressEntry.begin(); i != m_ipv4AddressEntry.end(); ++i)
     {
@@ -350,6 +525,20 @@ RoutingTable::InvalidateRoutesWithDst(const std::map<Ipv4Address, uint32_t>& unr
     }
 }
 
+void
+RoutingTable::DeleteBackupsWithNextHop(Ipv4Address nextHop)
+{
+    NS_LOG_FUNCTION(this << nextHop);
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance, OP_RT_DELETE_BACKUPS, nextHop);
+    }
+    for (auto i = m_ipv4AddressEntry.begin(); i != m_ipv4AddressEntry.end(); ++i)
+    {
+        i->second.DeleteBackup(nextHop);
+    }
+}
+
 void
 RoutingTable::DeleteAllRoutesFromInterface(Ipv4InterfaceAddress iface)
 {
@@ -376,6 +565,7 @@ RoutingTable::DeleteAllRoutesFromInterface(Ipv4InterfaceAddress iface)
 void
 RoutingTable::Purge()
 {
+    RAODV_PROFILE_SCOPE("RoutingTable::Purge");
     NS_LOG_FUNCTION(this);
     if (m_ipv4AddressEntry.empty())
     {
@@ -449,6 +639,13 @@ bool
 RoutingTable::MarkLinkAsUnidirectional(Ipv4Address neighbor, Time blacklistTimeout)
 {
     NS_LOG_FUNCTION(this << neighbor << blacklistTimeout.As(Time::S));
+    if (m_record)
+    {
+        OperationRecorder::Record(m_recordInstance,
+                                  OP_RT_MARK_UNIDIRECTIONAL,
+                                  neighbor,
+                                  blacklistTimeout.GetMilliSeconds());
+    }
     auto i = m_ipv4AddressEntry.find(neighbor);
     if (i == m_ipv4AddressEntry.end())
     {
@@ -487,5 +684,19 @@ RoutingTable::Print(Ptr<OutputStreamWrapper> stream, Time::Unit unit /* = Time::
     *stream->GetStream() << "\n";
 }
 
+uint64_t
+RoutingTable::GetMemoryUsage() const
+{
+    // A std::map node holds the value, three links and the color
+    const uint64_t node = sizeof(std::map<Ipv4Address, RoutingTableEntry>::value_type) +
+                          4 * sizeof(void*);
+    uint64_t bytes = m_ipv4AddressEntry.size() * node;
+    for (const auto& i : m_ipv4AddressEntry)
+    {
+        bytes += i.second.GetMemoryUsage();
+    }
+    return bytes;
+}
+
 } // namespace raodv
 } // namespace ns3
@@ -16,6 +16,8 @@
 #ifndef RAODV_RTABLE_H
 #define RAODV_RTABLE_H
 
+#include "raodv-op-recorder.h"
+
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv4.h"
 #include "ns3/net-device.h"
@@ -43,6 +45,20 @@ enum RouteFlags
     IN_SEARCH = 2, //!< IN_SEARCH
 };
 
+/**
+ * \ingroup raodv
+ * \brief Alternative next hop kept by a routing table entry for failover
+ */
+struct BackupRoute
+{
+    Ptr<NetDevice> m_dev;         ///< Output device
+    Ipv4InterfaceAddress m_iface; ///< Output interface address
+    Ipv4Address m_nextHop;        ///< Next hop address
+    uint16_t m_hops;              ///< Hop count through m_nextHop
+    uint32_t m_seqNo;             ///< Destination sequence number advertised along this path
+    Time m_expire;                ///< Absolute expiration time
+};
+
 /**
  * \ingroup raodv
  * \brief Routing table entry
@@ -107,6 +123,44 @@ class RoutingTableEntry
     void GetPrecursors(std::vector<Ipv4Address>& prec) const;
     //\}
 
+    /// \name Backup next hops management
+    //\{
+    /**
+     * Keep a VALID route to the same destination as a backup of this entry. Backups are ranked
+     * by fresher sequence number first and hop count second, never use the primary next hop,
+     * are never older than the primary sequence number and hold at most one path per next hop.
+     * \param rt the alternative route
+     * \param maxBackups maximum number of backups to keep
+     * \return true if the route is kept
+     */
+    bool AddBackup(const RoutingTableEntry& rt, uint32_t maxBackups);
+    /**
+     * Keep the primary path and the backups of another entry for the same destination as backups
+     * \param rt the entry replaced by this one
+     * \param maxBackups maximum number of backups to keep
+     */
+    void InheritBackups(const RoutingTableEntry& rt, uint32_t maxBackups);
+    /**
+     * Replace the primary path by the best backup that has not expired and mark the entry VALID
+     * \return false if no backup is left
+     */
+    bool PromoteBackup();
+    /**
+     * Forget the backup through a next hop
+     * \param nextHop next hop address
+     * \return true if a backup was removed
+     */
+    bool DeleteBackup(Ipv4Address nextHop);
+    /**
+     * Get the number of backups
+     * \return the number of backups, including expired ones
+     */
+    uint32_t GetBackupCount() const
+    {
+        return m_backups.size();
+    }
+    //\}
+
     /**
      * Mark entry as "down" (i.e. disable it)
      * \param badLinkLifetime duration to keep entry marked as invalid
@@ -249,6 +303,24 @@ class RoutingTableEntry
         return m_hops;
     }
 
+    /**
+     * Set the load advertised along the path
+     * \param load the queued packets of the forwarding nodes, summed or maximum
+     */
+    void SetPathLoad(uint32_t load)
+    {
+        m_pathLoad = load;
+    }
+
+    /**
+     * Get the load advertised along the path
+     * \returns the path load, 0 if unknown
+     */
+    uint32_t GetPathLoad() const
+    {
+        return m_pathLoad;
+    }
+
     /**
      * Set the lifetime
      * \param lt The lifetime
@@ -367,6 +439,12 @@ class RoutingTableEntry
      */
     void Print(Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
 
+    /**
+     * Estimate the heap memory held by the entry: the route, the precursor list and the backups
+     * \returns the estimate in bytes, excluding the entry object itself
+     */
+    uint64_t GetMemoryUsage() const;
+
   private:
     /// Valid Destination Sequence Number flag
     bool m_validSeqNo;
@@ -374,6 +452,8 @@ class RoutingTableEntry
     uint32_t m_seqNo;
     /// Hop Count (number of hops needed to reach destination)
     uint16_t m_hops;
+    /// Load of the forwarding nodes along the path when it was discovered
+    uint32_t m_pathLoad;
     /**
      * \brief Expiration or deletion time of the route
      * Lifetime field in the routing table plays dual role:
@@ -395,6 +475,8 @@ class RoutingTableEntry
 
     /// List of precursors
     std::vector<Ipv4Address> m_precursorList;
+    /// Alternative next hops, best first
+    std::vector<BackupRoute> m_backups;
     /// When I can send another request
     Time m_routeRequestTimeout;
     /// Number of route requests
@@ -502,6 +584,11 @@ class RoutingTable
      * \param iface the interface IP address
      */
     void DeleteAllRoutesFromInterface(Ipv4InterfaceAddress iface);
+    /**
+     * Forget the backups of all entries through a next hop
+     * \param nextHop the next hop IP address
+     */
+    void DeleteBackupsWithNextHop(Ipv4Address nextHop);
 
     /// Delete all entries from routing table
     void Clear()
@@ -525,11 +612,32 @@ class RoutingTable
      */
     void Print(Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
 
+    /**
+     * Estimate the memory held by the table: one map node per entry plus the heap memory of
+     * each entry
+     * \returns the estimate in bytes
+     */
+    uint64_t GetMemoryUsage() const;
+
+    /**
+     * Record every operation with OperationRecorder
+     * \param instance the node owning the table
+     */
+    void EnableRecording(uint32_t instance)
+    {
+        m_record = true;
+        m_recordInstance = instance;
+    }
+
   private:
     /// The routing table
     std::map<Ipv4Address, RoutingTableEntry> m_ipv4AddressEntry;
     /// Deletion time for invalid routes
     Time m_badLinkLifetime;
+    /// Record operations with OperationRecorder
+    bool m_record;
+    /// Node written in the records
+    uint32_t m_recordInstance;
     /**
      * const version of Purge, for use by Print() method
      * \param table the routing table entry to purge
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "raodv-stats.h"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+namespace raodv
+{
+
+std::ostream&
+operator<<(std::ostream& os, DropReason reason)
+{
+    switch (reason)
+    {
+    case DROP_DUPLICATE:
+        return os << "duplicate";
+    case DROP_TTL:
+        return os << "ttl";
+    case DROP_BLACKLIST:
+        return os << "blacklist";
+    case DROP_RATE_LIMIT:
+        return os << "rate-limit";
+    case DROP_NO_ROUTE:
+        return os << "no-route";
+    default:
+        return os << "unknown";
+    }
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    Reset();
+}
+
+void
+LatencyHistogram::Add(Time latency)
+{
+    double ms = latency.GetSeconds() * 1000;
+    uint32_t bucket = 0;
+    if (ms > 1)
+    {
+        bucket = std::min<uint32_t>(std::ceil(4 * std::log2(ms)), BUCKETS - 1);
+    }
+    m_buckets[bucket]++;
+    m_count++;
+}
+
+void
+LatencyHistogram::AddFailure()
+{
+    m_failures++;
+}
+
+uint64_t
+LatencyHistogram::GetCount() const
+{
+    return m_count;
+}
+
+uint64_t
+LatencyHistogram::GetFailures() const
+{
+    return m_failures;
+}
+
+double
+LatencyHistogram::GetFailureRate() const
+{
+    uint64_t total = m_count + m_failures;
+    return total > 0 ? double(m_failures) / total : 0.0;
+}
+
+Time
+LatencyHistogram::GetPercentile(double p) const
+{
+    if (m_count == 0)
+    {
+        return Seconds(0);
+    }
+    uint64_t rank = std::max<uint64_t>(std::ceil(p * m_count), 1);
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket < BUCKETS; bucket++)
+    {
+        seen += m_buckets[bucket];
+        if (seen >= rank)
+        {
+            return GetBucketBound(bucket);
+        }
+    }
+    return GetBucketBound(BUCKETS - 1);
+}
+
+uint64_t
+LatencyHistogram::GetBucketCount(uint32_t bucket) const
+{
+    return m_buckets.at(bucket);
+}
+
+Time
+LatencyHistogram::GetBucketBound(uint32_t bucket)
+{
+    return MicroSeconds(std::round(1000 * std::exp2(bucket / 4.0)));
+}
+
+void
+LatencyHistogram::Reset()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_failures = 0;
+}
+
+LatencyHistogram&
+LatencyHistogram::operator+=(const LatencyHistogram& o)
+{
+    for (uint32_t bucket = 0; bucket < BUCKETS; bucket++)
+    {
+        m_buckets[bucket] += o.m_buckets[bucket];
+    }
+    m_count += o.m_count;
+    m_failures += o.m_failures;
+    return *this;
+}
+
+void
+LatencyHistogram::Print(std::ostream& os) const
+{
+    os << "discoveries " << m_count << " failed " << m_failures << " failure rate "
+       << GetFailureRate() << " p50 " << GetPercentile(0.5).As(Time::MS) << " p95 "
+       << GetPercentile(0.95).As(Time::MS) << " p99 " << GetPercentile(0.99).As(Time::MS);
+}
+
+std::ostream&
+operator<<(std::ostream& os, const LatencyHistogram& histogram)
+{
+    histogram.Print(os);
+    return os;
+}
+
+RoutingStats::RoutingStats()
+{
+    Reset();
+}
+
+void
+RoutingStats::CountTx(MessageType type)
+{
+    NS_ASSERT(type < MESSAGE_TYPES);
+    m_tx[type]++;
+}
+
+void
+RoutingStats::CountRx(MessageType type)
+{
+    NS_ASSERT(type < MESSAGE_TYPES);
+    m_rx[type]++;
+}
+
+void
+RoutingStats::CountSuppressed(MessageType type)
+{
+    NS_ASSERT(type < MESSAGE_TYPES);
+    m_suppressed[type]++;
+}
+
+void
+RoutingStats::CountDropped(MessageType type, DropReason reason)
+{
+    NS_ASSERT(type < MESSAGE_TYPES && reason < DROP_REASONS);
+    m_dropped[type][reason]++;
+}
+
+uint64_t
+RoutingStats::GetTx(MessageType type) const
+{
+    return m_tx.at(type);
+}
+
+uint64_t
+RoutingStats::GetRx(MessageType type) const
+{
+    return m_rx.at(type);
+}
+
+uint64_t
+RoutingStats::GetSuppressed(MessageType type) const
+{
+    return m_suppressed.at(type);
+}
+
+uint64_t
+RoutingStats::GetDropped(MessageType type, DropReason reason) const
+{
+    return m_dropped.at(type).at(reason);
+}
+
+uint64_t
+RoutingStats::GetDropped(MessageType type) const
+{
+    uint64_t dropped = 0;
+    for (auto count : m_dropped.at(type))
+    {
+        dropped += count;
+    }
+    return dropped;
+}
+
+uint64_t
+RoutingStats::GetTotalTx() const
+{
+    uint64_t tx = 0;
+    for (uint32_t type = 0; type < MESSAGE_TYPES; type++)
+    {
+        if (type != RAODVTYPE_AGGREGATE)
+        {
+            tx += m_tx[type];
+        }
+    }
+    return tx;
+}
+
+void
+RoutingStats::CountDiscovery(Time latency, bool success)
+{
+    if (success)
+    {
+        m_discovery.Add(latency);
+    }
+    else
+    {
+        m_discovery.AddFailure();
+    }
+}
+
+const LatencyHistogram&
+RoutingStats::GetDiscoveryLatency() const
+{
+    return m_discovery;
+}
+
+void
+RoutingStats::Reset()
+{
+    m_discovery.Reset();
+    m_tx.fill(0);
+    m_rx.fill(0);
+    m_suppressed.fill(0);
+    for (auto& dropped : m_dropped)
+    {
+        dropped.fill(0);
+    }
+}
+
+RoutingStats&
+RoutingStats::operator+=(const RoutingStats& o)
+{
+    for (uint32_t type = 0; type < MESSAGE_TYPES; type++)
+    {
+        m_tx[type] += o.m_tx[type];
+        m_rx[type] += o.m_rx[type];
+        m_suppressed[type] += o.m_suppressed[type];
+        for (uint32_t reason = 0; reason < DROP_REASONS; reason++)
+        {
+            m_dropped[type][reason] += o.m_dropped[type][reason];
+        }
+    }
+    m_discovery += o.m_discovery;
+    return *this;
+}
+
+void
+RoutingStats::Print(std::ostream& os) const
+{
+    for (uint32_t type = RAODVTYPE_RREQ; type < MESSAGE_TYPES; type++)
+    {
+        MessageType t = static_cast<MessageType>(type);
+        if (m_tx[type] == 0 && m_rx[type] == 0 && m_suppressed[type] == 0 && GetDropped(t) == 0)
+        {
+            continue;
+        }
+        os << TypeHeader(t) << " tx " << m_tx[type] << " rx " << m_rx[type] << " suppressed "
+           << m_suppressed[type];
+        for (uint32_t reason = 0; reason < DROP_REASONS; reason++)
+        {
+            if (m_dropped[type][reason] != 0)
+            {
+                os << " drop " << static_cast<DropReason>(reason) << " "
+                   << m_dropped[type][reason];
+            }
+        }
+        os << "\n";
+    }
+    os << m_discovery << "\n";
+}
+
+std::ostream&
+operator<<(std::ostream& os, const RoutingStats& stats)
+{
+    stats.Print(os);
+    return os;
+}
+
+uint64_t
+MemoryFootprint::GetTotal() const
+{
+    return routingTable + requestQueue + idCaches + dpd + neighbors + requestTimers;
+}
+
+MemoryFootprint&
+MemoryFootprint::operator+=(const MemoryFootprint& o)
+{
+    routingTable += o.routingTable;
+    requestQueue += o.requestQueue;
+    idCaches += o.idCaches;
+    dpd += o.dpd;
+    neighbors += o.neighbors;
+    requestTimers += o.requestTimers;
+    return *this;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const MemoryFootprint& footprint)
+{
+    os << "table " << footprint.routingTable << " queue " << footprint.requestQueue
+       << " caches " << footprint.idCaches << " dpd " << footprint.dpd << " neighbors "
+       << footprint.neighbors << " timers " << footprint.requestTimers << " total "
+       << footprint.GetTotal();
+    return os;
+}
+
+} // namespace raodv
+} // namespace ns3
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RAODV_STATS_H
+#define RAODV_STATS_H
+
+#include "raodv-packet.h"
+
+#include "ns3/nstime.h"
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+namespace ns3
+{
+namespace raodv
+{
+
+/// Reason a received control message is dropped, or a message is not sent
+enum DropReason
+{
+    DROP_DUPLICATE,  ///< Already processed a copy with the same originator and ID
+    DROP_TTL,        ///< IP TTL too small to forward
+    DROP_BLACKLIST,  ///< Received over a blacklisted or breaking link
+    DROP_RATE_LIMIT, ///< RREQ or RERR rate limit reached
+    DROP_NO_ROUTE,   ///< No route to forward the message on
+    DROP_REASONS,    ///< Number of drop reasons
+};
+
+/**
+ * \brief Stream output operator
+ * \param os output stream
+ * \param reason the drop reason
+ * \return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, DropReason reason);
+
+/**
+ * \ingroup raodv
+ *
+ * \brief Histogram of route discovery latencies with log-scale buckets.
+ *
+ * Bucket 0 holds latencies up to 1 ms and bucket k latencies up to 2^(k/4) ms, so each
+ * bucket is about 19% wider than the previous one. The last bucket also holds everything
+ * longer. Percentiles are reported as the upper bound of the bucket they fall in.
+ */
+class LatencyHistogram
+{
+  public:
+    /// Number of buckets, the last one starts at about 49 s
+    static constexpr uint32_t BUCKETS = 64;
+
+    LatencyHistogram();
+
+    /**
+     * Record a successful discovery
+     * \param latency time the first packet waited for the route
+     */
+    void Add(Time latency);
+    /// Record a discovery that failed and dropped its packets
+    void AddFailure();
+
+    /// \returns the number of successful discoveries
+    uint64_t GetCount() const;
+    /// \returns the number of failed discoveries
+    uint64_t GetFailures() const;
+    /// \returns failed discoveries over all discoveries, 0 without discoveries
+    double GetFailureRate() const;
+    /**
+     * \param p the percentile as a fraction, e.g. 0.95
+     * \returns the upper bound of the bucket holding the percentile, 0 without discoveries
+     */
+    Time GetPercentile(double p) const;
+    /**
+     * \param bucket the bucket index
+     * \returns the number of latencies in the bucket
+     */
+    uint64_t GetBucketCount(uint32_t bucket) const;
+    /**
+     * \param bucket the bucket index
+     * \returns the largest latency in the bucket
+     */
+    static Time GetBucketBound(uint32_t bucket);
+
+    /// Set all counters to zero
+    void Reset();
+
+    /**
+     * Add the discoveries of another node
+     * \param o the other histogram
+     * \returns this object
+     */
+    LatencyHistogram& operator+=(const LatencyHistogram& o);
+
+    /**
+     * Print the count, failure rate and p50/p95/p99 latency
+     * \param os output stream
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    std::array<uint64_t, BUCKETS> m_buckets; ///< Successful discoveries per bucket
+    uint64_t m_count;                        ///< Successful discoveries
+    uint64_t m_failures;                     ///< Failed discoveries
+};
+
+/**
+ * \brief Stream output operator
+ * \param os output stream
+ * \param histogram the histogram
+ * \return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, const LatencyHistogram& histogram);
+
+/**
+ * \ingroup raodv
+ *
+ * \brief Control plane counters of a node, per message type.
+ *
+ * Messages are counted once per transmission whether they are sent alone or inside an
+ * aggregate; the aggregate datagrams themselves are counted as RAODVTYPE_AGGREGATE.
+ * Suppressed messages are RREQ and reverse request rebroadcasts a node decided to skip.
+ */
+class RoutingStats
+{
+  public:
+    RoutingStats();
+
+    /**
+     * Count a message handed to a socket
+     * \param type the message type
+     */
+    void CountTx(MessageType type);
+    /**
+     * Count a received message
+     * \param type the message type
+     */
+    void CountRx(MessageType type);
+    /**
+     * Count a rebroadcast that was skipped
+     * \param type the message type
+     */
+    void CountSuppressed(MessageType type);
+    /**
+     * Count a dropped message
+     * \param type the message type
+     * \param reason the drop reason
+     */
+    void CountDropped(MessageType type, DropReason reason);
+
+    /**
+     * \param type the message type
+     * \returns the number of messages sent
+     */
+    uint64_t GetTx(MessageType type) const;
+    /**
+     * \param type the message type
+     * \returns the number of messages received
+     */
+    uint64_t GetRx(MessageType type) const;
+    /**
+     * \param type the message type
+     * \returns the number of rebroadcasts skipped
+     */
+    uint64_t GetSuppressed(MessageType type) const;
+    /**
+     * \param type the message type
+     * \param reason the drop reason
+     * \returns the number of messages dropped for the reason
+     */
+    uint64_t GetDropped(MessageType type, DropReason reason) const;
+    /**
+     * \param type the message type
+     * \returns the number of messages dropped for any reason
+     */
+    uint64_t GetDropped(MessageType type) const;
+    /**
+     * \returns the number of control messages sent, aggregate datagrams excluded
+     */
+    uint64_t GetTotalTx() const;
+
+    /**
+     * Record the end of a route discovery for buffered packets
+     * \param latency time the first packet waited for the route
+     * \param success false if the buffered packets were dropped
+     */
+    void CountDiscovery(Time latency, bool success);
+    /**
+     * \returns the route discovery latencies
+     */
+    const LatencyHistogram& GetDiscoveryLatency() const;
+
+    /// Set all counters to zero
+    void Reset();
+
+    /**
+     * Add the counters of another node
+     * \param o the other counters
+     * \returns this object
+     */
+    RoutingStats& operator+=(const RoutingStats& o);
+
+    /**
+     * Print the non-zero counters, one message type per line, then the discovery latency
+     * \param os output stream
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    /// Number of message type slots, indexed by MessageType
+    static constexpr uint32_t MESSAGE_TYPES = RAODVTYPE_RREQ_REFRESH + 1;
+
+    std::array<uint64_t, MESSAGE_TYPES> m_tx;         ///< Messages sent
+    std::array<uint64_t, MESSAGE_TYPES> m_rx;         ///< Messages received
+    std::array<uint64_t, MESSAGE_TYPES> m_suppressed; ///< Rebroadcasts skipped
+    /// Messages dropped per reason
+    std::array<std::array<uint64_t, DROP_REASONS>, MESSAGE_TYPES> m_dropped;
+    /// Route discovery latencies of buffered packets
+    LatencyHistogram m_discovery;
+};
+
+/**
+ * \brief Stream output operator
+ * \param os output stream
+ * \param stats the counters
+ * \return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, const RoutingStats& stats);
+
+/**
+ * \ingroup raodv
+ *
+ * \brief Estimated memory held by the routing state of a node, in bytes per component.
+ *
+ * The estimates count container storage and the heap objects the containers point to, not
+ * allocator overhead, so they are lower bounds that are comparable across runs.
+ */
+struct MemoryFootprint
+{
+    uint64_t routingTable{0};  ///< Routing table entries, routes, precursors and backups
+    uint64_t requestQueue{0};  ///< Queue entries and buffered packets
+    uint64_t idCaches{0};      ///< RREQ and reverse request ID caches
+    uint64_t dpd{0};           ///< Duplicate packet detection cache
+    uint64_t neighbors{0};     ///< Neighbor list and ARP caches list
+    uint64_t requestTimers{0}; ///< Route request retry timers per destination
+
+    /// \returns the sum of all components
+    uint64_t GetTotal() const;
+
+    /**
+     * Add the footprint of another node
+     * \param o the other footprint
+     * \returns this object
+     */
+    MemoryFootprint& operator+=(const MemoryFootprint& o);
+};
+
+/**
+ * \brief Stream output operator
+ * \param os output stream
+ * \param footprint the footprint
+ * \return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, const MemoryFootprint& footprint);
+
+} // namespace raodv
+} // namespace ns3
+
+#endif /* RAODV_STATS_H */
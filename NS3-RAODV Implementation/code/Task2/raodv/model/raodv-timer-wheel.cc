@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "raodv-timer-wheel.h"
+
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+namespace raodv
+{
+namespace
+{
+/// Level value of a timer in TimerWheel::m_detached
+const uint8_t DETACHED_LEVEL = 0xfe;
+/// Level value of a timer in TimerWheel::m_direct
+const uint8_t DIRECT_LEVEL = 0xff;
+
+/**
+ * \param bits a non-zero bitmap
+ * \returns the index of the lowest set bit
+ */
+uint32_t
+LowestBit(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    uint32_t index = 0;
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+} // namespace
+
+WheelTimer::WheelTimer()
+    : m_wheel(nullptr),
+      m_expireTick(0),
+      m_prev(nullptr),
+      m_next(nullptr),
+      m_level(0),
+      m_slot(0)
+{
+}
+
+WheelTimer::~WheelTimer()
+{
+    Cancel();
+}
+
+void
+WheelTimer::SetFunction(Callback<void> function)
+{
+    m_function = function;
+}
+
+void
+WheelTimer::Cancel()
+{
+    if (!m_wheel)
+    {
+        return;
+    }
+    if (m_level == DIRECT_LEVEL)
+    {
+        m_event.Cancel();
+    }
+    m_wheel->Remove(this);
+    m_wheel->m_size--;
+    m_wheel = nullptr;
+}
+
+bool
+WheelTimer::IsRunning() const
+{
+    return m_wheel != nullptr;
+}
+
+Time
+WheelTimer::GetDelayLeft() const
+{
+    if (!m_wheel)
+    {
+        return Seconds(0);
+    }
+    return std::max(Seconds(0), m_expire - Simulator::Now());
+}
+
+void
+WheelTimer::Expire()
+{
+    m_wheel->Remove(this);
+    m_wheel->m_size--;
+    m_wheel = nullptr;
+    // The callback may destroy this timer
+    Callback<void> function = m_function;
+    function();
+}
+
+TimerWheel::TimerWheel(Time tick)
+    : m_tick(tick),
+      m_now(0),
+      m_size(0),
+      m_detached{nullptr, nullptr},
+      m_direct{nullptr, nullptr},
+      m_eventTick(0)
+{
+    for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+        for (uint32_t slot = 0; slot < SLOTS; ++slot)
+        {
+            m_slots[level][slot] = {nullptr, nullptr};
+        }
+        m_occupied[level] = 0;
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    Clear();
+}
+
+void
+TimerWheel::SetTick(Time tick)
+{
+    NS_ASSERT_MSG(m_size == 0, "Cannot change the tick of a wheel with armed timers");
+    NS_ASSERT(!tick.IsStrictlyNegative());
+    m_tick = tick;
+    m_now = m_tick.IsZero() ? 0 : Simulator::Now().GetTimeStep() / m_tick.GetTimeStep();
+}
+
+void
+TimerWheel::Schedule(WheelTimer& timer, Time delay)
+{
+    timer.Cancel();
+    timer.m_wheel = this;
+    timer.m_expire = Simulator::Now() + delay;
+    m_size++;
+    if (m_tick.IsZero())
+    {
+        timer.m_level = DIRECT_LEVEL;
+        Append(m_direct, &timer);
+        timer.m_event = Simulator::Schedule(delay, &WheelTimer::Expire, &timer);
+        return;
+    }
+    int64_t tick = m_tick.GetTimeStep();
+    if (std::none_of(m_occupied, m_occupied + LEVELS, [](uint64_t bits) { return bits != 0; }))
+    {
+        // Catch up with the clock so that the timer is placed as low as possible
+        m_event.Cancel();
+        m_now = std::max<uint64_t>(m_now, Simulator::Now().GetTimeStep() / tick);
+    }
+    // Round up so that a timer never fires early
+    uint64_t expire = (timer.m_expire.GetTimeStep() + tick - 1) / tick;
+    timer.m_expireTick = std::max(expire, m_now + 1);
+    Insert(&timer);
+    if (!m_event.IsPending() || timer.m_expireTick < m_eventTick)
+    {
+        ScheduleEvent(timer.m_expireTick);
+    }
+}
+
+void
+TimerWheel::Clear()
+{
+    for (Slot* list : {&m_detached, &m_direct})
+    {
+        while (list->m_first)
+        {
+            list->m_first->Cancel();
+        }
+    }
+    for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+        while (m_occupied[level])
+        {
+            m_slots[level][LowestBit(m_occupied[level])].m_first->Cancel();
+        }
+    }
+    m_event.Cancel();
+}
+
+void
+TimerWheel::Append(Slot& list, WheelTimer* timer)
+{
+    timer->m_next = nullptr;
+    timer->m_prev = list.m_last;
+    if (list.m_last)
+    {
+        list.m_last->m_next = timer;
+    }
+    else
+    {
+        list.m_first = timer;
+    }
+    list.m_last = timer;
+}
+
+void
+TimerWheel::Insert(WheelTimer* timer)
+{
+    // The timer goes to the lowest level whose parent slot is the current one
+    uint64_t expire = timer->m_expireTick;
+    uint32_t level = 0;
+    while (level < LEVELS - 1 && ((expire ^ m_now) >> (SLOT_BITS * (level + 1))) != 0)
+    {
+        level++;
+    }
+    uint32_t slot = (expire >> (SLOT_BITS * level)) & (SLOTS - 1);
+    timer->m_level = level;
+    timer->m_slot = slot;
+    Append(m_slots[level][slot], timer);
+    m_occupied[level] |= uint64_t(1) << slot;
+}
+
+void
+TimerWheel::Remove(WheelTimer* timer)
+{
+    Slot* list;
+    if (timer->m_level == DETACHED_LEVEL)
+    {
+        list = &m_detached;
+    }
+    else if (timer->m_level == DIRECT_LEVEL)
+    {
+        list = &m_direct;
+    }
+    else
+    {
+        list = &m_slots[timer->m_level][timer->m_slot];
+    }
+    if (timer->m_prev)
+    {
+        timer->m_prev->m_next = timer->m_next;
+    }
+    else
+    {
+        list->m_first = timer->m_next;
+    }
+    if (timer->m_next)
+    {
+        timer->m_next->m_prev = timer->m_prev;
+    }
+    else
+    {
+        list->m_last = timer->m_prev;
+    }
+    timer->m_prev = nullptr;
+    timer->m_next = nullptr;
+    if (!list->m_first && timer->m_level < LEVELS)
+    {
+        m_occupied[timer->m_level] &= ~(uint64_t(1) << timer->m_slot);
+    }
+}
+
+void
+TimerWheel::Detach(uint32_t level, uint32_t slot)
+{
+    NS_ASSERT(!m_detached.m_first);
+    m_detached = m_slots[level][slot];
+    m_slots[level][slot] = {nullptr, nullptr};
+    m_occupied[level] &= ~(uint64_t(1) << slot);
+    for (WheelTimer* timer = m_detached.m_first; timer; timer = timer->m_next)
+    {
+        timer->m_level = DETACHED_LEVEL;
+    }
+}
+
+uint64_t
+TimerWheel::GetNextTick() const
+{
+    // Every slot of a level expires before the slots of the level above, so the earliest
+    // timer is in the first occupied slot of the lowest non-empty level.
+    for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+        if (!m_occupied[level])
+        {
+            continue;
+        }
+        uint32_t shift = SLOT_BITS * level;
+        uint32_t current = (m_now >> shift) & (SLOTS - 1);
+        uint64_t later = m_occupied[level] & ~((uint64_t(2) << current) - 1);
+        // Only timers beyond the range of the top level wrap around
+        uint32_t slot = LowestBit(later ? later : m_occupied[level]);
+        uint64_t next = std::numeric_limits<uint64_t>::max();
+        for (WheelTimer* timer = m_slots[level][slot].m_first; timer; timer = timer->m_next)
+        {
+            next = std::min(next, timer->m_expireTick);
+        }
+        return next;
+    }
+    return std::numeric_limits<uint64_t>::max();
+}
+
+void
+TimerWheel::ScheduleEvent(uint64_t tick)
+{
+    m_event.Cancel();
+    m_eventTick = tick;
+    Time delay = TimeStep(tick * m_tick.GetTimeStep()) - Simulator::Now();
+    m_event = Simulator::Schedule(std::max(Seconds(0), delay), &TimerWheel::Expire, this);
+}
+
+void
+TimerWheel::Expire()
+{
+    // No timer expires before m_eventTick, so the only upper level slots that may hold timers
+    // due by then are the ones m_eventTick falls in. Move them down, highest first.
+    m_now = m_eventTick;
+    for (uint32_t level = LEVELS - 1; level > 0; --level)
+    {
+        uint32_t slot = (m_now >> (SLOT_BITS * level)) & (SLOTS - 1);
+        if (!(m_occupied[level] & (uint64_t(1) << slot)))
+        {
+            continue;
+        }
+        Detach(level, slot);
+        while (m_detached.m_first)
+        {
+            WheelTimer* timer = m_detached.m_first;
+            Remove(timer);
+            Insert(timer);
+        }
+    }
+    Detach(0, m_now & (SLOTS - 1));
+    while (m_detached.m_first)
+    {
+        // Timers may be cancelled or re-armed by the callbacks of the previous ones
+        m_detached.m_first->Expire();
+    }
+    uint64_t next = GetNextTick();
+    if (next != std::numeric_limits<uint64_t>::max() &&
+        (!m_event.IsPending() || next < m_eventTick))
+    {
+        ScheduleEvent(next);
+    }
+}
+
+} // namespace raodv
+} // namespace ns3
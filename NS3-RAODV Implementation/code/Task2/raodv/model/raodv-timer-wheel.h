@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RAODV_TIMER_WHEEL_H
+#define RAODV_TIMER_WHEEL_H
+
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+namespace raodv
+{
+class TimerWheel;
+
+/**
+ * \ingroup raodv
+ *
+ * \brief Timer armed on a TimerWheel.
+ *
+ * Arming, re-arming and cancelling only relink the timer inside the wheel.  The timer is
+ * cancelled when destroyed, so it may be erased from a container from its own callback.
+ * It cannot be copied since the wheel keeps a pointer to it.
+ */
+class WheelTimer
+{
+  public:
+    WheelTimer();
+    ~WheelTimer();
+    WheelTimer(const WheelTimer&) = delete;
+    WheelTimer& operator=(const WheelTimer&) = delete;
+
+    /**
+     * Set the function called on expiry.
+     * \param function the function
+     */
+    void SetFunction(Callback<void> function);
+    /// Cancel the timer if it is running
+    void Cancel();
+    /**
+     * \returns true if the timer is armed
+     */
+    bool IsRunning() const;
+    /**
+     * \returns the time left until expiry, zero if the timer is not running
+     */
+    Time GetDelayLeft() const;
+
+  private:
+    friend class TimerWheel;
+
+    /// Called on expiry when the wheel has no tick and schedules the timer directly
+    void Expire();
+
+    Callback<void> m_function; ///< Function called on expiry
+    TimerWheel* m_wheel;       ///< Wheel the timer is armed on, null if not running
+    Time m_expire;             ///< Expiry time
+    uint64_t m_expireTick;     ///< Wheel tick the timer expires at
+    WheelTimer* m_prev;        ///< Previous timer in the slot
+    WheelTimer* m_next;        ///< Next timer in the slot
+    uint8_t m_level;           ///< Wheel level of the slot
+    uint8_t m_slot;            ///< Slot index in the level
+    EventId m_event;           ///< Own event, when the wheel has no tick
+};
+
+/**
+ * \ingroup raodv
+ *
+ * \brief Hierarchical timing wheel multiplexing protocol timers onto one simulator event.
+ *
+ * Expiry times are rounded up to a whole tick.  The wheel has LEVELS levels of SLOTS
+ * slots; level k holds the timers expiring within the current level k+1 slot, which are
+ * moved down when the wheel reaches them.  Each slot is an intrusive list and each level
+ * keeps a bitmap of its non-empty slots, so arming and cancelling are O(1).  A single
+ * event is pending for the earliest expiry, whatever the number of timers armed; it is
+ * only rescheduled when a timer is armed before it, and timers expiring in the same tick
+ * share it.
+ *
+ * With a zero tick every timer schedules its own event, which is the behaviour of
+ * ns3::Timer and allows comparing the two.
+ */
+class TimerWheel
+{
+  public:
+    /**
+     * constructor
+     * \param tick the wheel resolution
+     */
+    TimerWheel(Time tick = MilliSeconds(1));
+    ~TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * Set the wheel resolution, only allowed while no timer is armed.
+     * \param tick the resolution, zero to schedule every timer separately
+     */
+    void SetTick(Time tick);
+    /**
+     * \returns the wheel resolution
+     */
+    Time GetTick() const
+    {
+        return m_tick;
+    }
+
+    /**
+     * Arm or re-arm a timer.
+     * \param timer the timer
+     * \param delay the delay until expiry
+     */
+    void Schedule(WheelTimer& timer, Time delay);
+    /// Cancel all timers and the pending event
+    void Clear();
+    /**
+     * \returns the number of armed timers
+     */
+    uint32_t GetSize() const
+    {
+        return m_size;
+    }
+
+  private:
+    friend class WheelTimer;
+
+    /// Number of bits of the slot index
+    static const uint32_t SLOT_BITS = 6;
+    /// Number of slots per level
+    static const uint32_t SLOTS = 1 << SLOT_BITS;
+    /// Number of levels
+    static const uint32_t LEVELS = 6;
+
+    /// List head of a slot
+    struct Slot
+    {
+        WheelTimer* m_first; ///< First timer, null if empty
+        WheelTimer* m_last;  ///< Last timer, null if empty
+    };
+
+    /**
+     * Link a timer into the slot of its expiry tick.
+     * \param timer the timer
+     */
+    void Insert(WheelTimer* timer);
+    /**
+     * Link a timer at the end of a list.
+     * \param list the list
+     * \param timer the timer
+     */
+    static void Append(Slot& list, WheelTimer* timer);
+    /**
+     * Unlink a timer from its slot.
+     * \param timer the timer
+     */
+    void Remove(WheelTimer* timer);
+    /**
+     * Move all timers of a slot to m_detached.
+     * \param level the level
+     * \param slot the slot index
+     */
+    void Detach(uint32_t level, uint32_t slot);
+    /**
+     * \returns the earliest expiry tick of the armed timers
+     */
+    uint64_t GetNextTick() const;
+    /**
+     * Replace the pending wheel event.
+     * \param tick the tick of the new event
+     */
+    void ScheduleEvent(uint64_t tick);
+    /// Advance to the event tick, move the due slots down and fire the expired timers
+    void Expire();
+
+    Time m_tick;                  ///< Wheel resolution
+    uint64_t m_now;               ///< Last tick processed
+    uint32_t m_size;              ///< Number of armed timers
+    Slot m_slots[LEVELS][SLOTS];  ///< Timer lists
+    Slot m_detached;              ///< Timers of the slot being cascaded or fired
+    Slot m_direct;                ///< Timers with their own event, when the tick is zero
+    uint64_t m_occupied[LEVELS];  ///< Non-empty slots of each level
+    EventId m_event;              ///< Pending wheel event
+    uint64_t m_eventTick;         ///< Tick of the pending wheel event
+};
+
+} // namespace raodv
+} // namespace ns3
+
+#endif /* RAODV_TIMER_WHEEL_H */
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "raodv-token-bucket.h"
+
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+namespace raodv
+{
+/// Credit of one token
+static const int64_t TOKEN_CREDIT = 1000000000;
+
+TokenBucket::TokenBucket(uint32_t rate)
+{
+    SetRate(rate);
+}
+
+void
+TokenBucket::SetRate(uint32_t rate)
+{
+    m_rate = rate;
+    m_credit = TOKEN_CREDIT * rate;
+    m_lastRefill = Simulator::Now();
+}
+
+void
+TokenBucket::Refill()
+{
+    Time now = Simulator::Now();
+    int64_t elapsed = (now - m_lastRefill).GetNanoSeconds();
+    m_lastRefill = now;
+    // Once the bucket is full the elapsed time no longer matters, which also avoids overflow
+    int64_t capacity = TOKEN_CREDIT * m_rate;
+    if (elapsed >= TOKEN_CREDIT)
+    {
+        m_credit = capacity;
+        return;
+    }
+    m_credit = std::min(capacity, m_credit + elapsed * m_rate);
+}
+
+bool
+TokenBucket::Consume()
+{
+    Refill();
+    if (m_credit < TOKEN_CREDIT)
+    {
+        return false;
+    }
+    m_credit -= TOKEN_CREDIT;
+    return true;
+}
+
+Time
+TokenBucket::GetDelay()
+{
+    if (m_rate == 0)
+    {
+        return Time::Max();
+    }
+    Refill();
+    if (m_credit >= TOKEN_CREDIT)
+    {
+        return Seconds(0);
+    }
+    // Round up so that the bucket really holds a token when the delay expires
+    return NanoSeconds((TOKEN_CREDIT - m_credit + m_rate - 1) / m_rate);
+}
+
+} // namespace raodv
+} // namespace ns3
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RAODV_TOKEN_BUCKET_H
+#define RAODV_TOKEN_BUCKET_H
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+namespace raodv
+{
+/**
+ * \ingroup raodv
+ *
+ * \brief Token bucket used for RREQ_RATELIMIT and RERR_RATELIMIT.
+ *
+ * The bucket holds at most one second worth of tokens and is refilled continuously at
+ * the configured rate, so a full bucket allows the same burst as the RFC 3561 per-second
+ * counter while later messages are spread out instead of waiting for a window reset.
+ */
+class TokenBucket
+{
+  public:
+    /**
+     * constructor
+     * \param rate the number of tokens added per second, also the bucket size
+     */
+    TokenBucket(uint32_t rate = 0);
+
+    /**
+     * Set the rate and fill the bucket.
+     * \param rate the number of tokens added per second
+     */
+    void SetRate(uint32_t rate);
+
+    /**
+     * \returns the number of tokens added per second
+     */
+    uint32_t GetRate() const
+    {
+        return m_rate;
+    }
+
+    /**
+     * Take a token if one is available.
+     * \returns true if a token was taken
+     */
+    bool Consume();
+
+    /**
+     * \returns the time until a token is available, zero if one is available now and
+     * Time::Max () if the rate is zero
+     */
+    Time GetDelay();
+
+  private:
+    /// Add the tokens accumulated since the last refill
+    void Refill();
+
+    /// Tokens per second
+    uint32_t m_rate;
+    /// Credit in token nanoseconds per second, a token is worth one second (1e9) of credit
+    int64_t m_credit;
+    /// Time of the last refill
+    Time m_lastRefill;
+};
+
+} // namespace raodv
+} // namespace ns3
+
+#endif /* RAODV_TOKEN_BUCKET_H */
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "adaptive-discovery-test.h"
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/raodv-helper.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+//-----------------------------------------------------------------------------
+// AdaptiveDiscoveryChainTest
+//-----------------------------------------------------------------------------
+AdaptiveDiscoveryChainTest::AdaptiveDiscoveryChainTest(bool adaptive)
+    : TestCase("raodv adaptive discovery chain test"),
+      m_nodes(nullptr),
+      m_secondBurst(Seconds(25)),
+      m_size(5),
+      m_step(120),
+      m_port(9),
+      m_adaptive(adaptive),
+      m_receivedPackets(0),
+      m_firstRequests(0)
+{
+}
+
+AdaptiveDiscoveryChainTest::~AdaptiveDiscoveryChainTest()
+{
+    delete m_nodes;
+}
+
+void
+AdaptiveDiscoveryChainTest::SendBurst(uint32_t count)
+{
+    m_sendSocket->Send(Create<Packet>(1000));
+    if (count > 1)
+    {
+        Simulator::Schedule(Seconds(0.25), &AdaptiveDiscoveryChainTest::SendBurst, this, count - 1);
+    }
+}
+
+void
+AdaptiveDiscoveryChainTest::HandleRead(Ptr<Socket> socket)
+{
+    m_receivedPackets++;
+}
+
+void
+AdaptiveDiscoveryChainTest::CountFirstRequests()
+{
+    m_firstRequests =
+        RaodvHelper::GetStats(NodeContainer(m_nodes->Get(0))).GetTx(raodv::RAODVTYPE_RREQ);
+}
+
+void
+AdaptiveDiscoveryChainTest::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(2);
+    Config::SetDefault("ns3::ArpCache::PendingQueueSize", UintegerValue(10));
+
+    CreateNodes();
+    CreateDevices();
+
+    Simulator::Schedule(m_secondBurst - Seconds(1),
+                        &AdaptiveDiscoveryChainTest::CountFirstRequests,
+                        this);
+
+    Simulator::Stop(m_secondBurst + Seconds(3)); // Allow buffered packets to clear
+    Simulator::Run();
+    // Read the counters before Simulator::Destroy disposes of the protocols
+    CheckResults();
+    Simulator::Destroy();
+
+    delete m_nodes, m_nodes = nullptr;
+}
+
+void
+AdaptiveDiscoveryChainTest::CreateNodes()
+{
+    m_nodes = new NodeContainer;
+    m_nodes->Create(m_size);
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator("ns3::GridPositionAllocator",
+                                  "MinX",
+                                  DoubleValue(0.0),
+                                  "MinY",
+                                  DoubleValue(0.0),
+                                  "DeltaX",
+                                  DoubleValue(m_step),
+                                  "DeltaY",
+                                  DoubleValue(0),
+                                  "GridWidth",
+                                  UintegerValue(m_size),
+                                  "LayoutType",
+                                  StringValue("RowFirst"));
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(*m_nodes);
+}
+
+void
+AdaptiveDiscoveryChainTest::CreateDevices()
+{
+    int64_t streamsUsed = 0;
+    // 1. Setup WiFi
+    WifiMacHelper wifiMac;
+    wifiMac.SetType("ns3::AdhocWifiMac");
+    YansWifiPhyHelper wifiPhy;
+    wifiPhy.DisablePreambleDetectionModel();
+    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> chan = wifiChannel.Create();
+    wifiPhy.SetChannel(chan);
+    wifiPhy.Set("TxGain", DoubleValue(1.0));
+    wifiPhy.Set("RxGain", DoubleValue(1.0));
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("OfdmRate6Mbps"),
+                                 "RtsCtsThreshold",
+                                 StringValue("2200"),
+                                 "MaxSlrc",
+                                 UintegerValue(7));
+    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, *m_nodes);
+    streamsUsed += WifiHelper::AssignStreams(devices, streamsUsed);
+    streamsUsed += wifiChannel.AssignStreams(chan, streamsUsed);
+
+    // 2. Setup TCP/IP & raodv
+    RaodvHelper raodv;
+    raodv.Set("AdaptiveDiscovery", BooleanValue(m_adaptive));
+    // Relays with a hello route to the destination drop the RREQ instead of replying
+    raodv.Set("DestinationOnly", BooleanValue(true));
+    InternetStackHelper internetStack;
+    internetStack.SetRoutingHelper(raodv);
+    internetStack.Install(*m_nodes);
+    streamsUsed += internetStack.AssignStreams(*m_nodes, streamsUsed);
+    streamsUsed += raodv.AssignStreams(*m_nodes, streamsUsed);
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // 3. Setup UDP source and sink
+    m_sendSocket =
+        Socket::CreateSocket(m_nodes->Get(0), TypeId::LookupByName("ns3::UdpSocketFactory"));
+    m_sendSocket->Bind();
+    m_sendSocket->Connect(InetSocketAddress(interfaces.GetAddress(m_size - 1), m_port));
+    // The route expires ActiveRouteTimeout after the first burst and is deleted DeletePeriod
+    // later, well before the second burst
+    for (Time start : {Seconds(1), m_secondBurst})
+    {
+        Simulator::ScheduleWithContext(m_sendSocket->GetNode()->GetId(),
+                                       start,
+                                       &AdaptiveDiscoveryChainTest::SendBurst,
+                                       this,
+                                       4);
+    }
+
+    m_recvSocket = Socket::CreateSocket(m_nodes->Get(m_size - 1),
+                                        TypeId::LookupByName("ns3::UdpSocketFactory"));
+    m_recvSocket->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_port));
+    m_recvSocket->SetRecvCallback(MakeCallback(&AdaptiveDiscoveryChainTest::HandleRead, this));
+}
+
+void
+AdaptiveDiscoveryChainTest::CheckResults()
+{
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPackets, 8, "Did not receive expected packets");
+    uint64_t secondRequests =
+        RaodvHelper::GetStats(NodeContainer(m_nodes->Get(0))).GetTx(raodv::RAODVTYPE_RREQ) -
+        m_firstRequests;
+    if (m_adaptive)
+    {
+        NS_TEST_EXPECT_MSG_EQ(secondRequests, 1, "The search did not start at the learned hops");
+    }
+    else
+    {
+        // TTL 1 and 3 fall short of the destination
+        NS_TEST_EXPECT_MSG_GT(secondRequests, 2, "The search did not start at TtlStart");
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef ADAPTIVE_DISCOVERY_TEST_H
+#define ADAPTIVE_DISCOVERY_TEST_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup raodv
+ *
+ * \brief raodv adaptive discovery chain test
+ *
+ * The first node of a five node chain sends a one-second UDP burst to the last one, four hops
+ * away, and another one long after the route was deleted.  With AdaptiveDiscovery the source
+ * starts the second expanding ring search at the hop count it learned plus TtlIncrement and
+ * reaches the destination with a single RREQ.  Without it the search starts again at TtlStart.
+ * Both bursts are delivered either way.
+ */
+class AdaptiveDiscoveryChainTest : public TestCase
+{
+  public:
+    /**
+     * Create test case
+     *
+     * \param adaptive            Enable RAODV adaptive discovery
+     */
+    AdaptiveDiscoveryChainTest(bool adaptive);
+    ~AdaptiveDiscoveryChainTest() override;
+
+  private:
+    /// \internal It is important to have pointers here
+    NodeContainer* m_nodes;
+
+    /// Start of the second burst, after the route to the destination was deleted
+    const Time m_secondBurst;
+    /// Chain size
+    const uint32_t m_size;
+    /// Chain step, meters
+    const double m_step;
+    /// port number
+    const uint16_t m_port;
+    /// Enable adaptive discovery
+    const bool m_adaptive;
+
+    /// Create test topology
+    void CreateNodes();
+    /// Create devices, install TCP/IP stack and applications
+    void CreateDevices();
+    /// Check the delivered packets and the RREQs of the second discovery
+    void CheckResults();
+    /// Go
+    void DoRun() override;
+    /// Record the RREQs the source sent before the second burst
+    void CountFirstRequests();
+    /**
+     * Receive data function
+     * \param socket the socket to receive from
+     */
+    void HandleRead(Ptr<Socket> socket);
+    /**
+     * Send a burst of four packets, one every 0.25 s
+     * \param count the number of packets left in the burst
+     */
+    void SendBurst(uint32_t count);
+
+    /// Receiving socket
+    Ptr<Socket> m_recvSocket;
+    /// Transmitting socket
+    Ptr<Socket> m_sendSocket;
+
+    /// Received packet count
+    uint32_t m_receivedPackets;
+    /// RREQs the source sent before the second burst
+    uint64_t m_firstRequests;
+};
+
+#endif /* ADAPTIVE_DISCOVERY_TEST_H */
@@ -38,7 +38,8 @@ using namespace ns3;
 Bug772ChainTest::Bug772ChainTest(const char* const prefix,
                                  const char* const proto,
                                  Time t,
-                                 uint32_t size)
+                                 uint32_t size,
+                                 bool coalescing)
     : TestCase("Bug 772 UDP and TCP chain regression test"),
       m_nodes(nullptr),
       m_prefix(prefix),
@@ -47,6 +48,7 @@ Bug772ChainTest::Bug772ChainTest(const char* const prefix,
       m_size(size),
       m_step(120),
       m_port(9),
+      m_coalescing(coalescing),
       m_receivedPackets(0)
 {
 }
@@ -161,6 +163,7 @@ Bug772ChainTest::CreateDevices()
 
     // 2. Setup TCP/IP & raodv
     RaodvHelper raodv; // Use default parameters here
+    raodv.Set("EnableCoalescing", BooleanValue(m_coalescing));
     InternetStackHelper internetStack;
     internetStack.SetRoutingHelper(raodv);
     internetStack.Install(*m_nodes);
@@ -194,12 +197,34 @@ Bug772ChainTest::CreateDevices()
     m_recvSocket->Listen();
     m_recvSocket->ShutdownSend();
     m_recvSocket->SetRecvCallback(MakeCallback(&Bug772ChainTest::HandleRead, this));
+
+    if (m_coalescing)
+    {
+        // Both route discoveries start in the same event, so the source coalesces their RREQs
+        // and every node on the way receives aggregated datagrams
+        m_sendSocket2 = Socket::CreateSocket(m_nodes->Get(0), TypeId::LookupByName(m_proto));
+        m_sendSocket2->Bind();
+        m_sendSocket2->Connect(InetSocketAddress(interfaces.GetAddress(m_size - 2), m_port));
+        Simulator::ScheduleWithContext(m_sendSocket2->GetNode()->GetId(),
+                                       Seconds(1.0),
+                                       &Bug772ChainTest::SendData,
+                                       this,
+                                       m_sendSocket2);
+
+        m_recvSocket2 =
+            Socket::CreateSocket(m_nodes->Get(m_size - 2), TypeId::LookupByName(m_proto));
+        m_recvSocket2->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_port));
+        m_recvSocket2->Listen();
+        m_recvSocket2->ShutdownSend();
+        m_recvSocket2->SetRecvCallback(MakeCallback(&Bug772ChainTest::HandleRead, this));
+    }
 }
 
 void
 Bug772ChainTest::CheckResults()
 {
-    // We should have sent 8 packets (every 0.25 seconds from time 1 to time 3)
-    // Check that the received packet count is 8
-    NS_TEST_EXPECT_MSG_EQ(m_receivedPackets, 8, "Did not receive expected 8 packets");
+    // We should have sent 8 packets per flow (every 0.25 seconds from time 1 to time 3)
+    // Check that the received packet count is 8, or 16 with the second flow
+    uint32_t expected = m_coalescing ? 16 : 8;
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPackets, expected, "Did not receive expected packets");
 }
@@ -35,8 +35,14 @@ class Bug772ChainTest : public TestCase
      * \param proto               ns3::UdpSocketFactory or ns3::TcpSocketFactory
      * \param size                Number of nodes in the chain
      * \param time                Simulation time
+     * \param coalescing          Enable RAODV coalescing and add a second flow, to the next to
+     *                            last node, whose RREQs leave the source in the same datagram
      */
-    Bug772ChainTest(const char* const prefix, const char* const proto, Time time, uint32_t size);
+    Bug772ChainTest(const char* const prefix,
+                    const char* const proto,
+                    Time time,
+                    uint32_t size,
+                    bool coalescing = false);
     ~Bug772ChainTest() override;
 
   private:
@@ -55,6 +61,8 @@ class Bug772ChainTest : public TestCase
     const double m_step;
     /// port number
     const uint16_t m_port;
+    /// Enable coalescing and the second flow
+    const bool m_coalescing;
 
     /// Create test topology
     void CreateNodes();
@@ -74,6 +82,10 @@ class Bug772ChainTest : public TestCase
     Ptr<Socket> m_recvSocket;
     /// Transmitting socket
     Ptr<Socket> m_sendSocket;
+    /// Receiving socket of the second flow
+    Ptr<Socket> m_recvSocket2;
+    /// Transmitting socket of the second flow
+    Ptr<Socket> m_sendSocket2;
 
     /// Received packet count
     uint32_t m_receivedPackets;
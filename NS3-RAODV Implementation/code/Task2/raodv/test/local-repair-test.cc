@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "local-repair-test.h"
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/mobility-model.h"
+#include "ns3/raodv-helper.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+//-----------------------------------------------------------------------------
+// LocalRepairChainTest
+//-----------------------------------------------------------------------------
+LocalRepairChainTest::LocalRepairChainTest(bool localRepair)
+    : TestCase("raodv local repair chain test"),
+      m_nodes(nullptr),
+      m_time(Seconds(10)),
+      m_breakTime(Seconds(5)),
+      m_size(5),
+      m_step(120),
+      m_port(9),
+      m_localRepair(localRepair),
+      m_sentAfterRepair(0),
+      m_receivedAfterRepair(0)
+{
+}
+
+LocalRepairChainTest::~LocalRepairChainTest()
+{
+    delete m_nodes;
+}
+
+void
+LocalRepairChainTest::SendData(Ptr<Socket> socket)
+{
+    if (Simulator::Now() < m_time)
+    {
+        socket->Send(Create<Packet>(1000));
+        if (Simulator::Now() >= m_breakTime + Seconds(1))
+        {
+            m_sentAfterRepair++;
+        }
+        Simulator::ScheduleWithContext(socket->GetNode()->GetId(),
+                                       Seconds(0.25),
+                                       &LocalRepairChainTest::SendData,
+                                       this,
+                                       socket);
+    }
+}
+
+void
+LocalRepairChainTest::HandleRead(Ptr<Socket> socket)
+{
+    if (Simulator::Now() >= m_breakTime + Seconds(1))
+    {
+        m_receivedAfterRepair++;
+    }
+}
+
+void
+LocalRepairChainTest::BreakLink()
+{
+    Ptr<MobilityModel> leaving = m_nodes->Get(m_size - 2)->GetObject<MobilityModel>();
+    Ptr<MobilityModel> spare = m_nodes->Get(m_size)->GetObject<MobilityModel>();
+    spare->SetPosition(leaving->GetPosition());
+    leaving->SetPosition(Vector(1e5, 1e5, 1e5));
+}
+
+void
+LocalRepairChainTest::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(2);
+    Config::SetDefault("ns3::ArpCache::PendingQueueSize", UintegerValue(10));
+
+    CreateNodes();
+    CreateDevices();
+
+    Simulator::Schedule(m_breakTime, &LocalRepairChainTest::BreakLink, this);
+
+    Simulator::Stop(m_time + Seconds(1)); // Allow buffered packets to clear
+    Simulator::Run();
+    // Read the counters before Simulator::Destroy disposes of the protocols
+    CheckResults();
+    Simulator::Destroy();
+
+    delete m_nodes, m_nodes = nullptr;
+}
+
+void
+LocalRepairChainTest::CreateNodes()
+{
+    m_nodes = new NodeContainer;
+    m_nodes->Create(m_size + 1);
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator("ns3::GridPositionAllocator",
+                                  "MinX",
+                                  DoubleValue(0.0),
+                                  "MinY",
+                                  DoubleValue(0.0),
+                                  "DeltaX",
+                                  DoubleValue(m_step),
+                                  "DeltaY",
+                                  DoubleValue(0),
+                                  "GridWidth",
+                                  UintegerValue(m_size + 1),
+                                  "LayoutType",
+                                  StringValue("RowFirst"));
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(*m_nodes);
+    // The spare node stays out of range until the break
+    m_nodes->Get(m_size)->GetObject<MobilityModel>()->SetPosition(Vector(-1e5, -1e5, 0));
+}
+
+void
+LocalRepairChainTest::CreateDevices()
+{
+    int64_t streamsUsed = 0;
+    // 1. Setup WiFi
+    WifiMacHelper wifiMac;
+    wifiMac.SetType("ns3::AdhocWifiMac");
+    YansWifiPhyHelper wifiPhy;
+    wifiPhy.DisablePreambleDetectionModel();
+    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> chan = wifiChannel.Create();
+    wifiPhy.SetChannel(chan);
+    wifiPhy.Set("TxGain", DoubleValue(1.0));
+    wifiPhy.Set("RxGain", DoubleValue(1.0));
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("OfdmRate6Mbps"),
+                                 "RtsCtsThreshold",
+                                 StringValue("2200"),
+                                 "MaxSlrc",
+                                 UintegerValue(7));
+    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, *m_nodes);
+    streamsUsed += WifiHelper::AssignStreams(devices, streamsUsed);
+    streamsUsed += wifiChannel.AssignStreams(chan, streamsUsed);
+
+    // 2. Setup TCP/IP & raodv
+    RaodvHelper raodv;
+    raodv.Set("EnableLocalRepair", BooleanValue(m_localRepair));
+    // Relays with a hello route to the destination drop the RREQ instead of replying
+    raodv.Set("DestinationOnly", BooleanValue(true));
+    InternetStackHelper internetStack;
+    internetStack.SetRoutingHelper(raodv);
+    internetStack.Install(*m_nodes);
+    streamsUsed += internetStack.AssignStreams(*m_nodes, streamsUsed);
+    streamsUsed += raodv.AssignStreams(*m_nodes, streamsUsed);
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // 3. Setup UDP source and sink
+    m_sendSocket =
+        Socket::CreateSocket(m_nodes->Get(0), TypeId::LookupByName("ns3::UdpSocketFactory"));
+    m_sendSocket->Bind();
+    m_sendSocket->Connect(InetSocketAddress(interfaces.GetAddress(m_size - 1), m_port));
+    Simulator::ScheduleWithContext(m_sendSocket->GetNode()->GetId(),
+                                   Seconds(1.0),
+                                   &LocalRepairChainTest::SendData,
+                                   this,
+                                   m_sendSocket);
+
+    m_recvSocket = Socket::CreateSocket(m_nodes->Get(m_size - 1),
+                                        TypeId::LookupByName("ns3::UdpSocketFactory"));
+    m_recvSocket->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_port));
+    m_recvSocket->SetRecvCallback(MakeCallback(&LocalRepairChainTest::HandleRead, this));
+}
+
+void
+LocalRepairChainTest::CheckResults()
+{
+    // Every 0.25 s from 6 s to 10 s
+    NS_TEST_EXPECT_MSG_EQ(m_sentAfterRepair, 16, "trivial");
+    NS_TEST_EXPECT_MSG_EQ(m_receivedAfterRepair,
+                          m_sentAfterRepair,
+                          "Packets lost after the route was repaired");
+    raodv::RoutingStats source = RaodvHelper::GetStats(NodeContainer(m_nodes->Get(0)));
+    uint64_t discoveries =
+        source.GetDiscoveryLatency().GetCount() + source.GetDiscoveryLatency().GetFailures();
+    if (m_localRepair)
+    {
+        NS_TEST_EXPECT_MSG_EQ(discoveries, 1, "The source noticed the repaired link break");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(discoveries, 2, "The source did not discover the route again");
+    }
+}
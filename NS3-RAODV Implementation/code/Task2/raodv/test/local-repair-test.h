@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef LOCAL_REPAIR_TEST_H
+#define LOCAL_REPAIR_TEST_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup raodv
+ *
+ * \brief raodv local repair chain test
+ *
+ * The first node of a five node chain sends UDP packets to the last one every 0.25 s.  At
+ * m_breakTime the fourth node moves away and a spare node, out of range until then, takes its
+ * place.  The third node loses its next hop two hops from the destination.  With
+ * EnableLocalRepair it repairs the route through the spare node and the source keeps its route,
+ * so the source needs a single route discovery.  Without it the RERR reaches the source, which
+ * discovers the route again.  Either way every packet sent from one second after the break on
+ * is delivered.
+ */
+class LocalRepairChainTest : public TestCase
+{
+  public:
+    /**
+     * Create test case
+     *
+     * \param localRepair         Enable RAODV local repair
+     */
+    LocalRepairChainTest(bool localRepair);
+    ~LocalRepairChainTest() override;
+
+  private:
+    /// \internal It is important to have pointers here
+    NodeContainer* m_nodes;
+
+    /// Total simulation time
+    const Time m_time;
+    /// Time the fourth node is replaced by the spare node
+    const Time m_breakTime;
+    /// Chain size, without the spare node
+    const uint32_t m_size;
+    /// Chain step, meters
+    const double m_step;
+    /// port number
+    const uint16_t m_port;
+    /// Enable local repair
+    const bool m_localRepair;
+
+    /// Create test topology
+    void CreateNodes();
+    /// Create devices, install TCP/IP stack and applications
+    void CreateDevices();
+    /// Check the delivered packets and the route discoveries of the source
+    void CheckResults();
+    /// Go
+    void DoRun() override;
+    /// Move the fourth node away and the spare node into its place
+    void BreakLink();
+    /**
+     * Receive data function
+     * \param socket the socket to receive from
+     */
+    void HandleRead(Ptr<Socket> socket);
+    /**
+     * Send data
+     * \param socket the sending socket
+     */
+    void SendData(Ptr<Socket> socket);
+
+    /// Receiving socket
+    Ptr<Socket> m_recvSocket;
+    /// Transmitting socket
+    Ptr<Socket> m_sendSocket;
+
+    /// Packets sent from one second after the break on
+    uint32_t m_sentAfterRepair;
+    /// Packets received from one second after the break on
+    uint32_t m_receivedAfterRepair;
+};
+
+#endif /* LOCAL_REPAIR_TEST_H */
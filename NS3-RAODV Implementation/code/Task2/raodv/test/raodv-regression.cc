@@ -8,7 +8,11 @@
 
 #include "raodv-regression.h"
 
+#include "adaptive-discovery-test.h"
 #include "bug-772.h"
+#include "local-repair-test.h"
+#include "route-refresh-test.h"
+#include "rreq-suppression-test.h"
 
 #include "ns3/abort.h"
 #include "ns3/raodv-helper.h"
@@ -53,6 +57,25 @@ class RaodvRegressionTestSuite : public TestSuite
         // \bugid{772} UDP test case
         AddTestCase(new Bug772ChainTest("udp-chain-test", "ns3::UdpSocketFactory", Seconds(3), 10),
                     TestCase::Duration::QUICK);
+        // The same chain with aggregated control datagrams
+        AddTestCase(new Bug772ChainTest("udp-chain-coalescing-test",
+                                        "ns3::UdpSocketFactory",
+                                        Seconds(3),
+                                        10,
+                                        true),
+                    TestCase::Duration::QUICK);
+        // Distance RREQ suppression on a ladder, and none without it
+        AddTestCase(new RreqSuppressionLadderTest(true), TestCase::Duration::QUICK);
+        AddTestCase(new RreqSuppressionLadderTest(false), TestCase::Duration::QUICK);
+        // A second discovery after the route was deleted, with and without adaptive discovery
+        AddTestCase(new AdaptiveDiscoveryChainTest(true), TestCase::Duration::QUICK);
+        AddTestCase(new AdaptiveDiscoveryChainTest(false), TestCase::Duration::QUICK);
+        // Route refresh across a paused flow, and no refresh through a relay without it
+        AddTestCase(new RouteRefreshChainTest(true), TestCase::Duration::QUICK);
+        AddTestCase(new RouteRefreshChainTest(false), TestCase::Duration::QUICK);
+        // A link break two hops from the destination, with and without local repair
+        AddTestCase(new LocalRepairChainTest(true), TestCase::Duration::QUICK);
+        AddTestCase(new LocalRepairChainTest(false), TestCase::Duration::QUICK);
     }
 } g_aodvRegressionTestSuite; ///< the test suite
 
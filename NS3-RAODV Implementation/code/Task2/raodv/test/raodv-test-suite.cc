@@ -5,13 +5,22 @@
  *
  * Authors: Pavel Boyko <boyko@iitp.ru>
  */
+#include "ns3/raodv-dpd.h"
+#include "ns3/raodv-id-cache.h"
 #include "ns3/raodv-neighbor.h"
+#include "ns3/raodv-op-recorder.h"
 #include "ns3/raodv-packet.h"
+#include "ns3/raodv-profiler.h"
 #include "ns3/raodv-rqueue.h"
 #include "ns3/raodv-rtable.h"
+#include "ns3/raodv-stats.h"
+#include "ns3/raodv-timer-wheel.h"
+#include "ns3/raodv-token-bucket.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/test.h"
 
+#include <sstream>
+
 namespace ns3
 {
 namespace raodv
@@ -73,6 +82,9 @@ NeighborTest::CheckTimeout2()
                           false,
                           "Neighbor doesn't exist");
     NS_TEST_EXPECT_MSG_EQ(neighbor->IsNeighbor(Ipv4Address("3.3.3.3")), true, "Neighbor exists");
+    NS_TEST_EXPECT_MSG_EQ(neighbor->IsCapable(Ipv4Address("2.2.2.2"), Neighbors::ROUTE_REFRESH),
+                          false,
+                          "Expired neighbor");
 }
 
 void
@@ -95,7 +107,7 @@ NeighborTest::CheckTimeout3()
 void
 NeighborTest::DoRun()
 {
-    Neighbors nb(Seconds(1));
+    Neighbors nb;
     neighbor = &nb;
     neighbor->SetCallback(MakeCallback(&NeighborTest::Handler, this));
     neighbor->Update(Ipv4Address("1.2.3.4"), Seconds(1));
@@ -114,6 +126,20 @@ NeighborTest::DoRun()
     neighbor->Update(Ipv4Address("1.1.1.1"), Seconds(5));
     neighbor->Update(Ipv4Address("2.2.2.2"), Seconds(10));
     neighbor->Update(Ipv4Address("3.3.3.3"), Seconds(20));
+    neighbor->SetCapabilities(Ipv4Address("2.2.2.2"), Neighbors::ROUTE_REFRESH);
+    neighbor->SetCapabilities(Ipv4Address("3.3.3.3"),
+                              Neighbors::ROUTE_REFRESH | Neighbors::COALESCING);
+    NS_TEST_EXPECT_MSG_EQ(neighbor->IsCapable(Ipv4Address("3.3.3.3"), Neighbors::ROUTE_REFRESH),
+                          true,
+                          "Advertised capability");
+    NS_TEST_EXPECT_MSG_EQ(
+        neighbor->IsCapable(Ipv4Address("3.3.3.3"),
+                            Neighbors::ROUTE_REFRESH | Neighbors::COMPACT_RREQ),
+        false,
+        "Capability not advertised");
+    NS_TEST_EXPECT_MSG_EQ(neighbor->IsCapable(Ipv4Address("4.3.2.1"), 0),
+                          false,
+                          "Not a neighbor");
 
     Simulator::Schedule(Seconds(2), &NeighborTest::CheckTimeout1, this);
     Simulator::Schedule(Seconds(15), &NeighborTest::CheckTimeout2, this);
@@ -122,6 +148,107 @@ NeighborTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup raodv-test
+ *
+ * \brief Unit test for link break prediction from the neighbor signal strength
+ */
+struct NeighborRssiTest : public TestCase
+{
+    NeighborRssiTest()
+        : TestCase("NeighborRssi"),
+          neighbor(nullptr),
+          predicted(0)
+    {
+    }
+
+    void DoRun() override;
+    /**
+     * Handler test function
+     * \param addr the IPv4 address of the neighbor
+     */
+    void Handler(Ipv4Address addr);
+    /**
+     * Feed one signal strength sample of each neighbor
+     * \param rssi signal strength of the departing neighbor in dBm
+     */
+    void Sample(double rssi);
+    /// Check the prediction while the departing neighbor is still strong
+    void CheckEarly();
+    /// Check the prediction once the departing neighbor is weak
+    void CheckLate();
+    /// The Neighbors
+    Neighbors* neighbor;
+    /// Number of predicted link breaks
+    uint32_t predicted;
+};
+
+void
+NeighborRssiTest::Handler(Ipv4Address addr)
+{
+    NS_TEST_EXPECT_MSG_EQ(addr, Ipv4Address("1.2.3.4"), "Departing neighbor breaks");
+    predicted++;
+}
+
+void
+NeighborRssiTest::Sample(double rssi)
+{
+    neighbor->UpdateRssi(Ipv4Address("1.2.3.4"), rssi);
+    neighbor->UpdateRssi(Ipv4Address("1.1.1.1"), -60);
+}
+
+void
+NeighborRssiTest::CheckEarly()
+{
+    NS_TEST_EXPECT_MSG_EQ(neighbor->IsLinkBreaking(Ipv4Address("1.2.3.4")),
+                          false,
+                          "Link still strong");
+    NS_TEST_EXPECT_MSG_EQ(predicted, 0, "No break predicted");
+}
+
+void
+NeighborRssiTest::CheckLate()
+{
+    NS_TEST_EXPECT_MSG_EQ(neighbor->IsLinkBreaking(Ipv4Address("1.2.3.4")),
+                          true,
+                          "Link breaking");
+    NS_TEST_EXPECT_MSG_EQ(neighbor->GetTimeToBreak(Ipv4Address("1.2.3.4")),
+                          Seconds(0),
+                          "Link below threshold");
+    NS_TEST_EXPECT_MSG_EQ(predicted, 1, "Break predicted once");
+    NS_TEST_EXPECT_MSG_EQ(neighbor->IsLinkBreaking(Ipv4Address("1.1.1.1")),
+                          false,
+                          "Steady link");
+    NS_TEST_EXPECT_MSG_EQ(neighbor->GetTimeToBreak(Ipv4Address("1.1.1.1")),
+                          Simulator::GetMaximumSimulationTime(),
+                          "Steady link never breaks");
+}
+
+void
+NeighborRssiTest::DoRun()
+{
+    Neighbors nb;
+    neighbor = &nb;
+    neighbor->SetLinkBreakPrediction(-85,
+                                     Seconds(1),
+                                     MakeCallback(&NeighborRssiTest::Handler, this));
+    neighbor->Update(Ipv4Address("1.2.3.4"), Seconds(10));
+    neighbor->Update(Ipv4Address("1.1.1.1"), Seconds(10));
+    NS_TEST_EXPECT_MSG_EQ(neighbor->GetTimeToBreak(Ipv4Address("1.2.3.4")),
+                          Simulator::GetMaximumSimulationTime(),
+                          "No samples yet");
+
+    // The departing neighbor fades by 10 dB/s and crosses -85 dBm at 2.5 s
+    for (uint32_t i = 0; i <= 20; i++)
+    {
+        Simulator::Schedule(MilliSeconds(200 * i), &NeighborRssiTest::Sample, this, -60 - 2.0 * i);
+    }
+    Simulator::Schedule(MilliSeconds(500), &NeighborRssiTest::CheckEarly, this);
+    Simulator::Schedule(Seconds(3), &NeighborRssiTest::CheckLate, this);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup raodv-test
  *
@@ -208,6 +335,73 @@ struct RreqHeaderTest : public TestCase
     }
 };
 
+/**
+ * \ingroup raodv-test
+ *
+ * \brief Unit test for compact RREQ encoding
+ */
+struct CompactRreqHeaderTest : public TestCase
+{
+    CompactRreqHeaderTest()
+        : TestCase("raodv compact RREQ")
+    {
+    }
+
+    void DoRun() override
+    {
+        RreqHeader h(/*flags*/ 0,
+                     /*reserved*/ 0,
+                     /*hopCount*/ 6,
+                     /*requestID*/ 1,
+                     /*dst*/ Ipv4Address("1.2.3.4"),
+                     /*dstSeqNo*/ 40,
+                     /*origin*/ Ipv4Address("4.3.2.1"),
+                     /*originSeqNo*/ 10);
+        h.SetGratuitousRrep(true);
+
+        // Originator equals IP source: address elided, small numbers take one byte each
+        CompactRreqHeader c(h, Ipv4Address("4.3.2.1"));
+        NS_TEST_EXPECT_MSG_EQ(c.IsOriginElided(), true, "trivial");
+        Ptr<Packet> p = Create<Packet>();
+        p->AddHeader(c);
+        CompactRreqHeader c2(Ipv4Address("4.3.2.1"));
+        uint32_t bytes = p->RemoveHeader(c2);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 9, "Compact RREQ with elided origin is 9 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(c2.GetRreqHeader(), h, "Round trip serialization works");
+
+        // Forwarded copy: IP source differs, originator carried explicitly
+        h.SetId(70000);
+        h.SetOriginSeqno(69990);
+        CompactRreqHeader c3(h, Ipv4Address("10.0.0.7"));
+        NS_TEST_EXPECT_MSG_EQ(c3.IsOriginElided(), false, "trivial");
+        p = Create<Packet>();
+        p->AddHeader(c3);
+        CompactRreqHeader c4(Ipv4Address("10.0.0.7"));
+        bytes = p->RemoveHeader(c4);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 15, "Compact RREQ with 3-byte ID and origin is 15 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(c4.GetRreqHeader(), h, "Round trip serialization works");
+
+        // Unknown destination sequence number is not sent at all
+        h.SetUnknownSeqno(true);
+        h.SetDstSeqno(0);
+        RevRreqHeader r(/*flags*/ 0,
+                        /*reserved*/ 0,
+                        /*hopCount*/ 2,
+                        /*requestID*/ 5,
+                        /*dst*/ Ipv4Address("1.2.3.4"),
+                        /*dstSeqNo*/ 0,
+                        /*origin*/ Ipv4Address("4.3.2.1"),
+                        /*originSeqNo*/ 3);
+        r.SetUnknownSeqno(true);
+        p = Create<Packet>();
+        p->AddHeader(CompactRreqHeader(r, Ipv4Address("4.3.2.1")));
+        CompactRreqHeader c5(Ipv4Address("4.3.2.1"));
+        bytes = p->RemoveHeader(c5);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 8, "Compact reverse RREQ without dst seqno is 8 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(c5.GetRevRreqHeader(), r, "Round trip serialization works");
+    }
+};
+
 /**
  * \ingroup raodv-test
  *
@@ -246,6 +440,18 @@ struct RrepHeaderTest : public TestCase
         NS_TEST_EXPECT_MSG_EQ(h.GetAckRequired(), true, "trivial");
         h.SetAckRequired(false);
         NS_TEST_EXPECT_MSG_EQ(h.GetAckRequired(), false, "trivial");
+        h.SetCompactCapable(true);
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactCapable(), true, "trivial");
+        h.SetCompactCapable(false);
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactCapable(), false, "trivial");
+        h.SetCoalesceCapable(true);
+        NS_TEST_EXPECT_MSG_EQ(h.GetCoalesceCapable(), true, "trivial");
+        h.SetCoalesceCapable(false);
+        NS_TEST_EXPECT_MSG_EQ(h.GetCoalesceCapable(), false, "trivial");
+        h.SetRefreshCapable(true);
+        NS_TEST_EXPECT_MSG_EQ(h.GetRefreshCapable(), true, "trivial");
+        h.SetRefreshCapable(false);
+        NS_TEST_EXPECT_MSG_EQ(h.GetRefreshCapable(), false, "trivial");
         h.SetPrefixSize(2);
         NS_TEST_EXPECT_MSG_EQ(h.GetPrefixSize(), 2, "trivial");
         h.SetHopCount(15);
@@ -289,6 +495,129 @@ struct RrepAckHeaderTest : public TestCase
     }
 };
 
+/**
+ * \ingroup raodv-test
+ *
+ * \brief Unit test for aggregated control datagrams
+ */
+struct AggregateRecordHeaderTest : public TestCase
+{
+    AggregateRecordHeaderTest()
+        : TestCase("raodv aggregate record")
+    {
+    }
+
+    void DoRun() override
+    {
+        // Two records: a RREP-ACK and a RREQ, each with its own TTL
+        Ptr<Packet> ack = Create<Packet>();
+        ack->AddHeader(RrepAckHeader());
+        ack->AddHeader(TypeHeader(RAODVTYPE_RREP_ACK));
+        Ptr<Packet> rreq = Create<Packet>();
+        rreq->AddHeader(RreqHeader());
+        rreq->AddHeader(TypeHeader(RAODVTYPE_RREQ));
+
+        Ptr<Packet> p = Create<Packet>();
+        Ptr<Packet> record = ack->Copy();
+        record->AddHeader(AggregateRecordHeader(1, ack->GetSize()));
+        p->AddAtEnd(record);
+        record = rreq->Copy();
+        record->AddHeader(AggregateRecordHeader(7, rreq->GetSize()));
+        p->AddAtEnd(record);
+        NS_TEST_EXPECT_MSG_EQ(p->GetSize(), 3 + 2 + 3 + 24, "Records are concatenated");
+
+        AggregateRecordHeader h;
+        uint32_t bytes = p->RemoveHeader(h);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 3, "Record header is 3 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h, AggregateRecordHeader(1, 2), "Round trip serialization works");
+        p->RemoveAtStart(h.GetLength());
+        p->RemoveHeader(h);
+        NS_TEST_EXPECT_MSG_EQ(h.GetTtl(), 7, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h.GetLength(), 24, "trivial");
+        TypeHeader t;
+        p->RemoveHeader(t);
+        NS_TEST_EXPECT_MSG_EQ(t.Get(), RAODVTYPE_RREQ, "Second record is the RREQ");
+    }
+};
+
+/**
+ * \ingroup raodv-test
+ *
+ * \brief Unit test for the RREQ location extension
+ */
+struct LocationExtensionTest : public TestCase
+{
+    LocationExtensionTest()
+        : TestCase("raodv location extension")
+    {
+    }
+
+    void DoRun() override
+    {
+        LocationExtension h(Vector(12.5, -300.25, 0), 20, MilliSeconds(1500));
+        NS_TEST_EXPECT_MSG_EQ(h.HasZone(), false, "No zone without a target");
+        h.SetTarget(Vector(900, 40.75, 0), 1.5, Seconds(1));
+        NS_TEST_EXPECT_MSG_EQ(h.HasZone(), true, "trivial");
+
+        // The extension follows the RREQ header
+        Ptr<Packet> p = Create<Packet>();
+        p->AddHeader(h);
+        p->AddHeader(RreqHeader());
+        NS_TEST_EXPECT_MSG_EQ(p->GetSize(), 23 + 32, "Extension is 32 bytes long");
+        RreqHeader rreq;
+        p->RemoveHeader(rreq);
+        LocationExtension h2;
+        uint32_t bytes = p->RemoveHeader(h2);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 32, "Extension is 32 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h2.IsValid(), true, "Type and length match");
+        NS_TEST_EXPECT_MSG_EQ(h2, h, "Round trip serialization works");
+
+        // Other trailing bytes are not taken for a location extension
+        p = Create<Packet>(32);
+        p->RemoveHeader(h2);
+        NS_TEST_EXPECT_MSG_EQ(h2.IsValid(), false, "Unknown extension type");
+    }
+};
+
+/**
+ * \ingroup raodv-test
+ *
+ * \brief Unit test for the path load extension
+ */
+struct LoadExtensionTest : public TestCase
+{
+    LoadExtensionTest()
+        : TestCase("raodv load extension")
+    {
+    }
+
+    void DoRun() override
+    {
+        LoadExtension h(42);
+        NS_TEST_EXPECT_MSG_EQ(h.GetLoad(), 42, "trivial");
+        h.SetLoad(70000);
+        NS_TEST_EXPECT_MSG_EQ(h.GetLoad(), 70000, "trivial");
+
+        // The load extension precedes the location extension
+        Ptr<Packet> p = Create<Packet>();
+        p->AddHeader(LocationExtension(Vector(1, 2, 0), 3, Seconds(1)));
+        p->AddHeader(h);
+        NS_TEST_EXPECT_MSG_EQ(p->GetSize(), 8 + 32, "Extension is 8 bytes long");
+        LoadExtension h2;
+        uint32_t bytes = p->RemoveHeader(h2);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 8, "Extension is 8 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h2.IsValid(), true, "Type and length match");
+        NS_TEST_EXPECT_MSG_EQ(h2, h, "Round trip serialization works");
+        LocationExtension location;
+        p->PeekHeader(location);
+        NS_TEST_EXPECT_MSG_EQ(location.IsValid(), true, "Location extension follows");
+
+        // A location extension is not taken for a load extension
+        p->PeekHeader(h2);
+        NS_TEST_EXPECT_MSG_EQ(h2.IsValid(), false, "Unknown extension type");
+    }
+};
+
 /**
  * \ingroup raodv-test
  *
@@ -411,6 +740,406 @@ struct QueueEntryTest : public TestCase
     }
 };
 
+//-----------------------------------------------------------------------------
+/// Unit test for TokenBucket
+struct TokenBucketTest : public TestCase
+{
+    TokenBucketTest()
+        : TestCase("TokenBucket"),
+          bucket(2)
+    {
+    }
+
+    void DoRun() override;
+    /// Check that the bucket refills at its rate
+    void CheckRefill();
+    /// Token bucket allowing 2 tokens per second
+    TokenBucket bucket;
+};
+
+void
+TokenBucketTest::DoRun()
+{
+    NS_TEST_EXPECT_MSG_EQ(bucket.GetRate(), 2, "trivial");
+    NS_TEST_EXPECT_MSG_EQ(bucket.GetDelay(), Seconds(0), "full bucket");
+    NS_TEST_EXPECT_MSG_EQ(bucket.Consume(), true, "first token of the burst");
+    NS_TEST_EXPECT_MSG_EQ(bucket.Consume(), true, "second token of the burst");
+    NS_TEST_EXPECT_MSG_EQ(bucket.Consume(), false, "burst is limited to the rate");
+    NS_TEST_EXPECT_MSG_EQ(bucket.GetDelay(), Seconds(0.5), "one token every 1/rate seconds");
+
+    Simulator::Schedule(Seconds(0.5), &TokenBucketTest::CheckRefill, this);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+TokenBucketTest::CheckRefill()
+{
+    NS_TEST_EXPECT_MSG_EQ(bucket.GetDelay(), Seconds(0), "token added after 1/rate seconds");
+    NS_TEST_EXPECT_MSG_EQ(bucket.Consume(), true, "trivial");
+    NS_TEST_EXPECT_MSG_EQ(bucket.Consume(), false, "only one token was added");
+    bucket.SetRate(0);
+    NS_TEST_EXPECT_MSG_EQ(bucket.Consume(), false, "zero rate never allows a message");
+    NS_TEST_EXPECT_MSG_EQ(bucket.GetDelay(), Time::Max(), "trivial");
+}
+
+//-----------------------------------------------------------------------------
+/// Unit test for RoutingStats
+struct RoutingStatsTest : public TestCase
+{
+    RoutingStatsTest()
+        : TestCase("RoutingStats")
+    {
+    }
+
+    void DoRun() override
+    {
+        RoutingStats stats;
+        NS_TEST_EXPECT_MSG_EQ(stats.GetTotalTx(), 0, "trivial");
+        stats.CountTx(RAODVTYPE_RREQ);
+        stats.CountTx(RAODVTYPE_RREQ);
+        stats.CountTx(RAODVTYPE_RREP);
+        stats.CountTx(RAODVTYPE_AGGREGATE);
+        stats.CountRx(RAODVTYPE_RERR);
+        stats.CountSuppressed(RAODVTYPE_REVREQUEST);
+        stats.CountDropped(RAODVTYPE_RREQ, DROP_DUPLICATE);
+        stats.CountDropped(RAODVTYPE_RREQ, DROP_DUPLICATE);
+        stats.CountDropped(RAODVTYPE_RREQ, DROP_TTL);
+        NS_TEST_EXPECT_MSG_EQ(stats.GetTx(RAODVTYPE_RREQ), 2, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(stats.GetTotalTx(), 3, "aggregate datagrams are not messages");
+        NS_TEST_EXPECT_MSG_EQ(stats.GetRx(RAODVTYPE_RERR), 1, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(stats.GetSuppressed(RAODVTYPE_REVREQUEST), 1, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(stats.GetDropped(RAODVTYPE_RREQ, DROP_DUPLICATE), 2, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(stats.GetDropped(RAODVTYPE_RREQ), 3, "sum over all reasons");
+        NS_TEST_EXPECT_MSG_EQ(stats.GetDropped(RAODVTYPE_RREP), 0, "trivial");
+
+        RoutingStats total;
+        total += stats;
+        total += stats;
+        NS_TEST_EXPECT_MSG_EQ(total.GetTx(RAODVTYPE_RREQ), 4, "counters add up");
+        NS_TEST_EXPECT_MSG_EQ(total.GetDropped(RAODVTYPE_RREQ, DROP_TTL), 2, "counters add up");
+        stats.Reset();
+        NS_TEST_EXPECT_MSG_EQ(stats.GetTotalTx(), 0, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(stats.GetDropped(RAODVTYPE_RREQ), 0, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(total.GetTotalTx(), 6, "copies are independent");
+    }
+};
+
+//-----------------------------------------------------------------------------
+/// Unit test for LatencyHistogram
+struct LatencyHistogramTest : public TestCase
+{
+    LatencyHistogramTest()
+        : TestCase("LatencyHistogram")
+    {
+    }
+
+    void DoRun() override
+    {
+        LatencyHistogram histogram;
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetPercentile(0.5), Seconds(0), "no discoveries");
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetFailureRate(), 0, "no discoveries");
+        NS_TEST_EXPECT_MSG_EQ(LatencyHistogram::GetBucketBound(0), MilliSeconds(1), "trivial");
+        NS_TEST_EXPECT_MSG_EQ(LatencyHistogram::GetBucketBound(4), MilliSeconds(2), "one octave");
+        NS_TEST_EXPECT_MSG_EQ(LatencyHistogram::GetBucketBound(40),
+                              MilliSeconds(1024),
+                              "ten octaves");
+
+        histogram.Add(MicroSeconds(500));
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetBucketCount(0), 1, "below 1 ms");
+        histogram.Add(MilliSeconds(2));
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetBucketCount(4), 1, "bounds are inclusive");
+        for (uint32_t i = 0; i < 97; ++i)
+        {
+            histogram.Add(MilliSeconds(100));
+        }
+        histogram.Add(Seconds(1000));
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetBucketCount(LatencyHistogram::BUCKETS - 1),
+                              1,
+                              "the last bucket is unbounded");
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetCount(), 100, "trivial");
+        Time p50 = histogram.GetPercentile(0.5);
+        NS_TEST_EXPECT_MSG_EQ((p50 >= MilliSeconds(100) && p50 < MilliSeconds(120)),
+                              true,
+                              "bucket bound within 19% above the latency");
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetPercentile(0.99), p50, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetPercentile(1),
+                              LatencyHistogram::GetBucketBound(LatencyHistogram::BUCKETS - 1),
+                              "the maximum falls in the last bucket");
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetPercentile(0.01), MilliSeconds(1), "trivial");
+
+        LatencyHistogram other;
+        other.AddFailure();
+        other.Add(MilliSeconds(2));
+        histogram += other;
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetCount(), 101, "histograms merge");
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetBucketCount(4), 2, "histograms merge");
+        NS_TEST_EXPECT_MSG_EQ(histogram.GetFailures(), 1, "histograms merge");
+        NS_TEST_EXPECT_MSG_EQ_TOL(histogram.GetFailureRate(), 1.0 / 102, 1e-9, "trivial");
+
+        RoutingStats stats;
+        stats.CountDiscovery(MilliSeconds(10), true);
+        stats.CountDiscovery(Seconds(30), false);
+        NS_TEST_EXPECT_MSG_EQ(stats.GetDiscoveryLatency().GetCount(), 1, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(stats.GetDiscoveryLatency().GetFailures(), 1, "trivial");
+        stats.Reset();
+        NS_TEST_EXPECT_MSG_EQ(stats.GetDiscoveryLatency().GetFailures(), 0, "trivial");
+    }
+};
+
+//-----------------------------------------------------------------------------
+/// Unit test for OperationRecorder
+struct OperationRecorderTest : public TestCase
+{
+    OperationRecorderTest()
+        : TestCase("OperationRecorder"),
+          table(Seconds(5)),
+          cache(Seconds(10))
+    {
+    }
+
+    void DoRun() override;
+    /// Operations 1.5 s later
+    void Later();
+    /// Routing table under recording
+    RoutingTable table;
+    /// ID cache under recording
+    IdCache cache;
+};
+
+void
+OperationRecorderTest::DoRun()
+{
+    std::string filename = CreateTempDirFilename("raodv-ops.bin");
+    NS_TEST_EXPECT_MSG_EQ(OperationRecorder::IsOpen(), false, "recording is off by default");
+    NS_TEST_EXPECT_MSG_EQ(OperationRecorder::Open(filename), true, "trivial");
+    RoutingTableEntry rt(nullptr,
+                         Ipv4Address("1.2.3.4"),
+                         true,
+                         0,
+                         Ipv4InterfaceAddress(),
+                         1,
+                         Ipv4Address("1.2.3.5"),
+                         Seconds(10));
+    table.AddRoute(rt); // not enabled on the table yet
+    table.EnableRecording(7);
+    cache.EnableRecording(300);
+    rt.SetFlag(IN_SEARCH);
+    table.Update(rt);
+    Simulator::Schedule(Seconds(1.5), &OperationRecorderTest::Later, this);
+    Simulator::Run();
+    Simulator::Destroy();
+    OperationRecorder::Close();
+    NS_TEST_EXPECT_MSG_EQ(OperationRecorder::IsOpen(), false, "trivial");
+
+    OperationTraceReader reader;
+    NS_TEST_ASSERT_MSG_EQ(reader.Open(filename), true, "trivial");
+    OperationRecord record;
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "update is recorded");
+    NS_TEST_EXPECT_MSG_EQ(record.time, Seconds(0), "trivial");
+    NS_TEST_EXPECT_MSG_EQ(record.instance, 7, "trivial");
+    NS_TEST_EXPECT_MSG_EQ(record.op, OP_RT_UPDATE, "trivial");
+    NS_TEST_EXPECT_MSG_EQ(record.key, Ipv4Address("1.2.3.4"), "trivial");
+    NS_TEST_EXPECT_MSG_EQ(OperationRecorder::UnpackLifetime(record.arg), Seconds(10), "trivial");
+    NS_TEST_EXPECT_MSG_EQ(OperationRecorder::UnpackFlag(record.arg), IN_SEARCH, "trivial");
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "lookup is recorded");
+    NS_TEST_EXPECT_MSG_EQ(record.time, Seconds(1.5), "time is restored from the deltas");
+    NS_TEST_EXPECT_MSG_EQ(record.op, OP_RT_LOOKUP, "trivial");
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "ID cache is recorded");
+    NS_TEST_EXPECT_MSG_EQ(record.instance, 300, "multi-byte varint");
+    NS_TEST_EXPECT_MSG_EQ(record.op, OP_ID_IS_DUPLICATE, "trivial");
+    NS_TEST_EXPECT_MSG_EQ(record.key, Ipv4Address("10.0.0.1"), "trivial");
+    NS_TEST_EXPECT_MSG_EQ(record.arg, 0xfffffff0, "multi-byte varint");
+    NS_TEST_EXPECT_MSG_EQ(reader.Read(record), false, "end of the trace");
+    NS_TEST_EXPECT_MSG_EQ(OperationRecorder::PackRoute(Seconds(-1), VALID),
+                          0,
+                          "expired lifetimes are recorded as 0");
+}
+
+void
+OperationRecorderTest::Later()
+{
+    RoutingTableEntry rt;
+    table.LookupRoute(Ipv4Address("1.2.3.4"), rt);
+    cache.IsDuplicate(Ipv4Address("10.0.0.1"), 0xfffffff0);
+}
+
+//-----------------------------------------------------------------------------
+/// Unit test for the memory usage estimates
+struct MemoryFootprintTest : public TestCase
+{
+    MemoryFootprintTest()
+        : TestCase("MemoryFootprint")
+    {
+    }
+
+    void DoRun() override
+    {
+        RoutingTable table(Seconds(5));
+        NS_TEST_EXPECT_MSG_EQ(table.GetMemoryUsage(), 0, "empty table");
+        RoutingTableEntry rt(nullptr,
+                             Ipv4Address("1.2.3.4"),
+                             true,
+                             0,
+                             Ipv4InterfaceAddress(),
+                             1,
+                             Ipv4Address("1.2.3.5"),
+                             Seconds(10));
+        uint64_t entry = rt.GetMemoryUsage();
+        NS_TEST_EXPECT_MSG_GT(entry, 0, "the route is counted");
+        table.AddRoute(rt);
+        uint64_t oneRoute = table.GetMemoryUsage();
+        NS_TEST_EXPECT_MSG_GT(oneRoute, entry + sizeof(RoutingTableEntry), "map node is counted");
+        rt.InsertPrecursor(Ipv4Address("10.0.0.1"));
+        NS_TEST_EXPECT_MSG_GT(rt.GetMemoryUsage(), entry, "precursors are counted");
+        table.Update(rt);
+        NS_TEST_EXPECT_MSG_GT(table.GetMemoryUsage(), oneRoute, "trivial");
+
+        RequestQueue queue(64, Seconds(30));
+        NS_TEST_EXPECT_MSG_EQ(queue.GetMemoryUsage(), 0, "empty queue");
+        Ipv4Header header;
+        header.SetDestination(Ipv4Address("1.2.3.4"));
+        QueueEntry queueEntry(Create<Packet>(1000), header);
+        queue.Enqueue(queueEntry);
+        NS_TEST_EXPECT_MSG_GT(queue.GetMemoryUsage(),
+                              1000 + sizeof(QueueEntry),
+                              "buffered payload is counted");
+
+        IdCache cache(Seconds(10));
+        NS_TEST_EXPECT_MSG_EQ(cache.GetMemoryUsage(), 0, "empty cache");
+        cache.IsDuplicate(Ipv4Address("10.0.0.1"), 1);
+        NS_TEST_EXPECT_MSG_GT(cache.GetMemoryUsage(), 0, "trivial");
+
+        DuplicatePacketDetection dpd(Seconds(10));
+        NS_TEST_EXPECT_MSG_EQ(dpd.GetMemoryUsage(), 0, "empty cache");
+        dpd.IsDuplicate(Create<Packet>(), header);
+        NS_TEST_EXPECT_MSG_GT(dpd.GetMemoryUsage(), 0, "trivial");
+
+        Neighbors nb;
+        NS_TEST_EXPECT_MSG_EQ(nb.GetMemoryUsage(), 0, "empty list");
+        nb.Update(Ipv4Address("1.2.3.4"), Seconds(1));
+        NS_TEST_EXPECT_MSG_GT(nb.GetMemoryUsage(), 0, "trivial");
+
+        MemoryFootprint footprint;
+        footprint.routingTable = 100000;
+        footprint.requestQueue = 20000;
+        footprint.idCaches = 3000;
+        footprint.dpd = 400;
+        footprint.neighbors = 50;
+        footprint.requestTimers = 6;
+        MemoryFootprint total;
+        total += footprint;
+        total += footprint;
+        NS_TEST_EXPECT_MSG_EQ(total.GetTotal(), 246912, "components add up");
+    }
+};
+
+//-----------------------------------------------------------------------------
+/// Unit test for Profiler
+struct ProfilerTest : public TestCase
+{
+    ProfilerTest()
+        : TestCase("Profiler")
+    {
+    }
+
+    void DoRun() override
+    {
+        ProfileSection& section = Profiler::GetSection("ProfilerTest");
+        NS_TEST_EXPECT_MSG_EQ(&Profiler::GetSection("ProfilerTest"),
+                              &section,
+                              "sections are created once per name");
+        Profiler::Reset();
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            ScopedTimer timer(section);
+        }
+        NS_TEST_EXPECT_MSG_EQ(section.count, 3, "one count per scope");
+        NS_TEST_EXPECT_MSG_EQ((section.max <= section.total), true, "trivial");
+        std::ostringstream os;
+        Profiler::Print(os);
+        NS_TEST_EXPECT_MSG_NE(os.str().find("ProfilerTest"), std::string::npos, "reported");
+        Profiler::Reset();
+        NS_TEST_EXPECT_MSG_EQ(section.count, 0, "trivial");
+    }
+};
+
+//-----------------------------------------------------------------------------
+/// Unit test for TimerWheel
+struct TimerWheelTest : public TestCase
+{
+    TimerWheelTest()
+        : TestCase("TimerWheel")
+    {
+    }
+
+    void DoRun() override;
+    /**
+     * Record the expiry of a timer
+     * \param index the timer index
+     */
+    void Expire(uint32_t index);
+
+    /// Timing wheel with a 1 ms tick
+    TimerWheel wheel;
+    /// Timers under test
+    WheelTimer timers[4];
+    /// Expiry time of each timer, -1 s if it did not fire
+    Time expired[4];
+};
+
+void
+TimerWheelTest::Expire(uint32_t index)
+{
+    expired[index] = Simulator::Now();
+    if (index == 0)
+    {
+        // Re-arm from the callback
+        wheel.Schedule(timers[0], Seconds(100));
+        timers[3].Cancel();
+    }
+}
+
+void
+TimerWheelTest::DoRun()
+{
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        timers[i].SetFunction(MakeCallback(&TimerWheelTest::Expire, this).Bind(i));
+        expired[i] = Seconds(-1);
+    }
+    wheel.Schedule(timers[0], MilliSeconds(1500));
+    wheel.Schedule(timers[1], MicroSeconds(2500));
+    wheel.Schedule(timers[2], Seconds(10));
+    wheel.Schedule(timers[3], Seconds(20));
+    NS_TEST_EXPECT_MSG_EQ(wheel.GetSize(), 4, "trivial");
+    NS_TEST_EXPECT_MSG_EQ(timers[2].GetDelayLeft(), Seconds(10), "trivial");
+    // Re-arming a timer moves it
+    wheel.Schedule(timers[2], Seconds(5));
+    NS_TEST_EXPECT_MSG_EQ(wheel.GetSize(), 4, "trivial");
+    Simulator::Stop(Seconds(50));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(expired[1], MilliSeconds(3), "expiry is rounded up to the tick");
+    NS_TEST_EXPECT_MSG_EQ(expired[0], MilliSeconds(1500), "trivial");
+    NS_TEST_EXPECT_MSG_EQ(expired[2], Seconds(5), "re-armed timer expires once, at its new time");
+    NS_TEST_EXPECT_MSG_EQ(expired[3], Seconds(-1), "cancelled timer does not expire");
+    NS_TEST_EXPECT_MSG_EQ(timers[0].IsRunning(), true, "timer re-armed from its callback");
+    NS_TEST_EXPECT_MSG_EQ(wheel.GetSize(), 1, "trivial");
+    wheel.Clear();
+    NS_TEST_EXPECT_MSG_EQ(timers[0].IsRunning(), false, "trivial");
+
+    // Without a tick every timer fires at its exact time
+    wheel.SetTick(Seconds(0));
+    expired[1] = Seconds(-1);
+    wheel.Schedule(timers[1], MicroSeconds(2500));
+    Simulator::Run();
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(expired[1], MicroSeconds(2500), "no rounding without a tick");
+    NS_TEST_EXPECT_MSG_EQ(wheel.GetSize(), 0, "trivial");
+}
+
 //-----------------------------------------------------------------------------
 /// Unit test for RequestQueue
 struct RaodvRqueueTest : public TestCase
@@ -719,6 +1448,89 @@ struct RaodvRtableTest : public TestCase
     }
 };
 
+/**
+ * \ingroup raodv-test
+ *
+ * \brief Unit test for backup next hops of a routing table entry
+ */
+struct RaodvRtableBackupTest : public TestCase
+{
+    RaodvRtableBackupTest()
+        : TestCase("RtableBackup")
+    {
+    }
+
+    /**
+     * Create a route to 1.2.3.4
+     * \param nextHop the next hop
+     * \param seqNo the destination sequence number
+     * \param hop the hop count
+     * \param lifetime the lifetime
+     * \return the route
+     */
+    RoutingTableEntry Route(Ipv4Address nextHop, uint32_t seqNo, uint16_t hop, Time lifetime)
+    {
+        return RoutingTableEntry(/*output device*/ nullptr,
+                                 /*dst*/ Ipv4Address("1.2.3.4"),
+                                 /*validSeqNo*/ true,
+                                 /*seqNo*/ seqNo,
+                                 /*interface*/ Ipv4InterfaceAddress(),
+                                 /*hop*/ hop,
+                                 /*next hop*/ nextHop,
+                                 /*lifetime*/ lifetime);
+    }
+
+    void DoRun() override
+    {
+        RoutingTableEntry rt = Route(Ipv4Address("10.0.0.1"), 10, 3, Seconds(10));
+        NS_TEST_EXPECT_MSG_EQ(rt.AddBackup(Route(Ipv4Address("10.0.0.2"), 10, 5, Seconds(10)), 0),
+                              false,
+                              "disabled");
+        NS_TEST_EXPECT_MSG_EQ(rt.AddBackup(Route(Ipv4Address("10.0.0.1"), 10, 5, Seconds(10)), 2),
+                              false,
+                              "primary next hop");
+        NS_TEST_EXPECT_MSG_EQ(rt.AddBackup(Route(Ipv4Address("10.0.0.2"), 9, 5, Seconds(10)), 2),
+                              false,
+                              "older than the primary");
+        NS_TEST_EXPECT_MSG_EQ(rt.AddBackup(Route(Ipv4Address("10.0.0.2"), 10, 5, Seconds(10)), 2),
+                              true,
+                              "first backup");
+        NS_TEST_EXPECT_MSG_EQ(rt.AddBackup(Route(Ipv4Address("10.0.0.3"), 10, 4, Seconds(10)), 2),
+                              true,
+                              "shorter backup");
+        NS_TEST_EXPECT_MSG_EQ(rt.AddBackup(Route(Ipv4Address("10.0.0.4"), 10, 6, Seconds(10)), 2),
+                              false,
+                              "worse than all backups");
+        NS_TEST_EXPECT_MSG_EQ(rt.AddBackup(Route(Ipv4Address("10.0.0.2"), 10, 6, Seconds(10)), 2),
+                              false,
+                              "longer path through a known next hop");
+        NS_TEST_EXPECT_MSG_EQ(rt.GetBackupCount(), 2, "k backups");
+
+        NS_TEST_EXPECT_MSG_EQ(rt.PromoteBackup(), true, "fail over");
+        NS_TEST_EXPECT_MSG_EQ(rt.GetNextHop(), Ipv4Address("10.0.0.3"), "best backup first");
+        NS_TEST_EXPECT_MSG_EQ(rt.GetHop(), 4, "hop count of the backup");
+        NS_TEST_EXPECT_MSG_EQ(rt.GetFlag(), VALID, "promoted route is valid");
+        NS_TEST_EXPECT_MSG_EQ(rt.DeleteBackup(Ipv4Address("10.0.0.2")), true, "delete");
+        NS_TEST_EXPECT_MSG_EQ(rt.PromoteBackup(), false, "no backup left");
+
+        RoutingTableEntry old = Route(Ipv4Address("10.0.0.5"), 11, 2, Seconds(10));
+        old.AddBackup(Route(Ipv4Address("10.0.0.6"), 11, 3, MilliSeconds(1)), 2);
+        RoutingTableEntry fresh = Route(Ipv4Address("10.0.0.7"), 11, 1, Seconds(10));
+        fresh.InheritBackups(old, 2);
+        NS_TEST_EXPECT_MSG_EQ(fresh.GetBackupCount(), 2, "inherit primary and backups");
+
+        RoutingTable rtable(Seconds(2));
+        rtable.AddRoute(fresh);
+        rtable.DeleteBackupsWithNextHop(Ipv4Address("10.0.0.5"));
+        NS_TEST_EXPECT_MSG_EQ(rtable.LookupRoute(Ipv4Address("1.2.3.4"), rt), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(rt.GetBackupCount(), 1, "backup through broken next hop dropped");
+        Simulator::Stop(MilliSeconds(2));
+        Simulator::Run();
+        NS_TEST_EXPECT_MSG_EQ(rt.PromoteBackup(), false, "expired backup is not used");
+        Simulator::Destroy();
+    }
+};
+
 /**
  * \ingroup raodv-test
  *
@@ -731,15 +1543,28 @@ class RaodvTestSuite : public TestSuite
         : TestSuite("routing-raodv", Type::UNIT)
     {
         AddTestCase(new NeighborTest, TestCase::Duration::QUICK);
+        AddTestCase(new NeighborRssiTest, TestCase::Duration::QUICK);
         AddTestCase(new TypeHeaderTest, TestCase::Duration::QUICK);
         AddTestCase(new RreqHeaderTest, TestCase::Duration::QUICK);
+        AddTestCase(new CompactRreqHeaderTest, TestCase::Duration::QUICK);
         AddTestCase(new RrepHeaderTest, TestCase::Duration::QUICK);
         AddTestCase(new RrepAckHeaderTest, TestCase::Duration::QUICK);
+        AddTestCase(new AggregateRecordHeaderTest, TestCase::Duration::QUICK);
+        AddTestCase(new LocationExtensionTest, TestCase::Duration::QUICK);
+        AddTestCase(new LoadExtensionTest, TestCase::Duration::QUICK);
         AddTestCase(new RerrHeaderTest, TestCase::Duration::QUICK);
         AddTestCase(new QueueEntryTest, TestCase::Duration::QUICK);
+        AddTestCase(new TokenBucketTest, TestCase::Duration::QUICK);
+        AddTestCase(new RoutingStatsTest, TestCase::Duration::QUICK);
+        AddTestCase(new LatencyHistogramTest, TestCase::Duration::QUICK);
+        AddTestCase(new OperationRecorderTest, TestCase::Duration::QUICK);
+        AddTestCase(new MemoryFootprintTest, TestCase::Duration::QUICK);
+        AddTestCase(new ProfilerTest, TestCase::Duration::QUICK);
+        AddTestCase(new TimerWheelTest, TestCase::Duration::QUICK);
         AddTestCase(new RaodvRqueueTest, TestCase::Duration::QUICK);
         AddTestCase(new RaodvRtableEntryTest, TestCase::Duration::QUICK);
         AddTestCase(new RaodvRtableTest, TestCase::Duration::QUICK);
+        AddTestCase(new RaodvRtableBackupTest, TestCase::Duration::QUICK);
     }
 } g_aodvTestSuite; ///< the test suite
 
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "route-refresh-test.h"
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/raodv-helper.h"
+#include "ns3/raodv-routing-protocol.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+//-----------------------------------------------------------------------------
+// RouteRefreshChainTest
+//-----------------------------------------------------------------------------
+RouteRefreshChainTest::RouteRefreshChainTest(bool refreshingRelay)
+    : TestCase("raodv route refresh chain test"),
+      m_nodes(nullptr),
+      m_size(4),
+      m_step(120),
+      m_port(9),
+      m_refreshingRelay(refreshingRelay),
+      m_receivedPackets(0)
+{
+}
+
+RouteRefreshChainTest::~RouteRefreshChainTest()
+{
+    delete m_nodes;
+}
+
+void
+RouteRefreshChainTest::SendBurst(uint32_t count)
+{
+    m_sendSocket->Send(Create<Packet>(1000));
+    if (count > 1)
+    {
+        Simulator::Schedule(Seconds(0.25), &RouteRefreshChainTest::SendBurst, this, count - 1);
+    }
+}
+
+void
+RouteRefreshChainTest::HandleRead(Ptr<Socket> socket)
+{
+    m_receivedPackets++;
+}
+
+void
+RouteRefreshChainTest::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(2);
+    Config::SetDefault("ns3::ArpCache::PendingQueueSize", UintegerValue(10));
+
+    CreateNodes();
+    CreateDevices();
+
+    Simulator::Stop(Seconds(13));
+    Simulator::Run();
+    // Read the counters before Simulator::Destroy disposes of the protocols
+    CheckResults();
+    Simulator::Destroy();
+
+    delete m_nodes, m_nodes = nullptr;
+}
+
+void
+RouteRefreshChainTest::CreateNodes()
+{
+    m_nodes = new NodeContainer;
+    m_nodes->Create(m_size);
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator("ns3::GridPositionAllocator",
+                                  "MinX",
+                                  DoubleValue(0.0),
+                                  "MinY",
+                                  DoubleValue(0.0),
+                                  "DeltaX",
+                                  DoubleValue(m_step),
+                                  "DeltaY",
+                                  DoubleValue(0),
+                                  "GridWidth",
+                                  UintegerValue(m_size),
+                                  "LayoutType",
+                                  StringValue("RowFirst"));
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(*m_nodes);
+}
+
+void
+RouteRefreshChainTest::CreateDevices()
+{
+    int64_t streamsUsed = 0;
+    // 1. Setup WiFi
+    WifiMacHelper wifiMac;
+    wifiMac.SetType("ns3::AdhocWifiMac");
+    YansWifiPhyHelper wifiPhy;
+    wifiPhy.DisablePreambleDetectionModel();
+    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> chan = wifiChannel.Create();
+    wifiPhy.SetChannel(chan);
+    wifiPhy.Set("TxGain", DoubleValue(1.0));
+    wifiPhy.Set("RxGain", DoubleValue(1.0));
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("OfdmRate6Mbps"),
+                                 "RtsCtsThreshold",
+                                 StringValue("2200"),
+                                 "MaxSlrc",
+                                 UintegerValue(7));
+    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, *m_nodes);
+    streamsUsed += WifiHelper::AssignStreams(devices, streamsUsed);
+    streamsUsed += wifiChannel.AssignStreams(chan, streamsUsed);
+
+    // 2. Setup TCP/IP & raodv
+    RaodvHelper raodv;
+    raodv.Set("EnableRouteRefresh", BooleanValue(true));
+    // Relays with a hello route to the destination drop the RREQ instead of replying
+    raodv.Set("DestinationOnly", BooleanValue(true));
+    InternetStackHelper internetStack;
+    internetStack.SetRoutingHelper(raodv);
+    internetStack.Install(*m_nodes);
+    streamsUsed += internetStack.AssignStreams(*m_nodes, streamsUsed);
+    streamsUsed += raodv.AssignStreams(*m_nodes, streamsUsed);
+    if (!m_refreshingRelay)
+    {
+        m_nodes->Get(1)->GetObject<raodv::RoutingProtocol>()->SetAttribute("EnableRouteRefresh",
+                                                                           BooleanValue(false));
+    }
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // 3. Setup UDP source and sink
+    m_sendSocket =
+        Socket::CreateSocket(m_nodes->Get(0), TypeId::LookupByName("ns3::UdpSocketFactory"));
+    m_sendSocket->Bind();
+    m_sendSocket->Connect(InetSocketAddress(interfaces.GetAddress(m_size - 1), m_port));
+    // Bursts at 1 s, 3.5 s and 6 s keep the route in use; the route expires 3 s after the
+    // packet at 6.75 s unless it is refreshed, before the last burst at 11 s
+    for (double start : {1.0, 3.5, 6.0, 11.0})
+    {
+        Simulator::ScheduleWithContext(m_sendSocket->GetNode()->GetId(),
+                                       Seconds(start),
+                                       &RouteRefreshChainTest::SendBurst,
+                                       this,
+                                       4);
+    }
+
+    m_recvSocket = Socket::CreateSocket(m_nodes->Get(m_size - 1),
+                                        TypeId::LookupByName("ns3::UdpSocketFactory"));
+    m_recvSocket->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_port));
+    m_recvSocket->SetRecvCallback(MakeCallback(&RouteRefreshChainTest::HandleRead, this));
+}
+
+void
+RouteRefreshChainTest::CheckResults()
+{
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPackets, 16, "Did not receive expected packets");
+    raodv::RoutingStats source = RaodvHelper::GetStats(NodeContainer(m_nodes->Get(0)));
+    uint64_t discoveries =
+        source.GetDiscoveryLatency().GetCount() + source.GetDiscoveryLatency().GetFailures();
+    if (m_refreshingRelay)
+    {
+        NS_TEST_EXPECT_MSG_GT(source.GetTx(raodv::RAODVTYPE_RREQ_REFRESH),
+                              0,
+                              "The source did not refresh the route");
+        NS_TEST_EXPECT_MSG_EQ(discoveries, 1, "The refreshed route expired");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(source.GetTx(raodv::RAODVTYPE_RREQ_REFRESH),
+                              0,
+                              "Refresh sent to a relay that did not advertise it");
+        NS_TEST_EXPECT_MSG_GT(
+            source.GetDropped(raodv::RAODVTYPE_RREQ_REFRESH, raodv::DROP_NO_ROUTE),
+            0,
+            "The source did not try to refresh the route");
+        NS_TEST_EXPECT_MSG_EQ(discoveries, 2, "The last burst did not need a new discovery");
+    }
+}
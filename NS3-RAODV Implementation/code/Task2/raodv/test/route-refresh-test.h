@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef ROUTE_REFRESH_TEST_H
+#define ROUTE_REFRESH_TEST_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup raodv
+ *
+ * \brief raodv route refresh chain test
+ *
+ * The first node of a four node chain sends one-second UDP bursts to the last one, with
+ * EnableRouteRefresh on every node.  The first two pauses are 1.75 s, the last one 4.25 s,
+ * longer than ActiveRouteTimeout.  The source refreshes the route before it expires, so the
+ * last burst needs no new route discovery.  When the first relay does not enable the refresh,
+ * it does not advertise it in its hellos: the source must not send a refresh, and the last
+ * burst waits for a new discovery.  All 16 packets are delivered either way.
+ */
+class RouteRefreshChainTest : public TestCase
+{
+  public:
+    /**
+     * Create test case
+     *
+     * \param refreshingRelay     Enable the route refresh on the first relay too
+     */
+    RouteRefreshChainTest(bool refreshingRelay);
+    ~RouteRefreshChainTest() override;
+
+  private:
+    /// \internal It is important to have pointers here
+    NodeContainer* m_nodes;
+
+    /// Chain size
+    const uint32_t m_size;
+    /// Chain step, meters
+    const double m_step;
+    /// port number
+    const uint16_t m_port;
+    /// Enable the route refresh on the first relay
+    const bool m_refreshingRelay;
+
+    /// Create test topology
+    void CreateNodes();
+    /// Create devices, install TCP/IP stack and applications
+    void CreateDevices();
+    /// Check the delivered packets and the control messages of the source
+    void CheckResults();
+    /// Go
+    void DoRun() override;
+    /**
+     * Receive data function
+     * \param socket the socket to receive from
+     */
+    void HandleRead(Ptr<Socket> socket);
+    /**
+     * Send a burst of four packets, one every 0.25 s
+     * \param count the number of packets left in the burst
+     */
+    void SendBurst(uint32_t count);
+
+    /// Receiving socket
+    Ptr<Socket> m_recvSocket;
+    /// Transmitting socket
+    Ptr<Socket> m_sendSocket;
+
+    /// Received packet count
+    uint32_t m_receivedPackets;
+};
+
+#endif /* ROUTE_REFRESH_TEST_H */
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "rreq-suppression-test.h"
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/raodv-helper.h"
+#include "ns3/raodv-routing-protocol.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/yans-wifi-helper.h"
+
+using namespace ns3;
+
+//-----------------------------------------------------------------------------
+// RreqSuppressionLadderTest
+//-----------------------------------------------------------------------------
+RreqSuppressionLadderTest::RreqSuppressionLadderTest(bool suppression)
+    : TestCase("raodv RREQ suppression ladder test"),
+      m_nodes(nullptr),
+      m_time(Seconds(3)),
+      m_size(4),
+      m_step(120),
+      m_rung(10),
+      m_port(9),
+      m_suppression(suppression),
+      m_sentPackets(0),
+      m_receivedPackets(0)
+{
+}
+
+RreqSuppressionLadderTest::~RreqSuppressionLadderTest()
+{
+    delete m_nodes;
+}
+
+void
+RreqSuppressionLadderTest::SendData(Ptr<Socket> socket)
+{
+    if (Simulator::Now() < m_time)
+    {
+        socket->Send(Create<Packet>(1000));
+        m_sentPackets++;
+        Simulator::ScheduleWithContext(socket->GetNode()->GetId(),
+                                       Seconds(0.25),
+                                       &RreqSuppressionLadderTest::SendData,
+                                       this,
+                                       socket);
+    }
+}
+
+void
+RreqSuppressionLadderTest::HandleRead(Ptr<Socket> socket)
+{
+    m_receivedPackets++;
+}
+
+void
+RreqSuppressionLadderTest::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(2);
+    Config::SetDefault("ns3::ArpCache::PendingQueueSize", UintegerValue(10));
+
+    CreateNodes();
+    CreateDevices();
+
+    Simulator::Stop(m_time + Seconds(1)); // Allow buffered packets to clear
+    Simulator::Run();
+    // Read the counters before Simulator::Destroy disposes of the protocols
+    CheckResults();
+    Simulator::Destroy();
+
+    delete m_nodes, m_nodes = nullptr;
+}
+
+void
+RreqSuppressionLadderTest::CreateNodes()
+{
+    m_nodes = new NodeContainer;
+    m_nodes->Create(2 * m_size);
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator("ns3::GridPositionAllocator",
+                                  "MinX",
+                                  DoubleValue(0.0),
+                                  "MinY",
+                                  DoubleValue(0.0),
+                                  "DeltaX",
+                                  DoubleValue(m_step),
+                                  "DeltaY",
+                                  DoubleValue(m_rung),
+                                  "GridWidth",
+                                  UintegerValue(m_size),
+                                  "LayoutType",
+                                  StringValue("RowFirst"));
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(*m_nodes);
+}
+
+void
+RreqSuppressionLadderTest::CreateDevices()
+{
+    int64_t streamsUsed = 0;
+    // 1. Setup WiFi
+    WifiMacHelper wifiMac;
+    wifiMac.SetType("ns3::AdhocWifiMac");
+    YansWifiPhyHelper wifiPhy;
+    wifiPhy.DisablePreambleDetectionModel();
+    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> chan = wifiChannel.Create();
+    wifiPhy.SetChannel(chan);
+    wifiPhy.Set("TxGain", DoubleValue(1.0));
+    wifiPhy.Set("RxGain", DoubleValue(1.0));
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("OfdmRate6Mbps"),
+                                 "RtsCtsThreshold",
+                                 StringValue("2200"),
+                                 "MaxSlrc",
+                                 UintegerValue(7));
+    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, *m_nodes);
+    streamsUsed += WifiHelper::AssignStreams(devices, streamsUsed);
+    streamsUsed += wifiChannel.AssignStreams(chan, streamsUsed);
+
+    // 2. Setup TCP/IP & raodv
+    RaodvHelper raodv;
+    raodv.Set("RreqSuppression",
+              EnumValue(m_suppression ? raodv::RoutingProtocol::SUPPRESSION_DISTANCE
+                                      : raodv::RoutingProtocol::SUPPRESSION_NONE));
+    // Relays with a hello route to the destination drop the RREQ instead of replying
+    raodv.Set("DestinationOnly", BooleanValue(true));
+    InternetStackHelper internetStack;
+    internetStack.SetRoutingHelper(raodv);
+    internetStack.Install(*m_nodes);
+    streamsUsed += internetStack.AssignStreams(*m_nodes, streamsUsed);
+    streamsUsed += raodv.AssignStreams(*m_nodes, streamsUsed);
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // 3. Setup UDP source and sink
+    m_sendSocket =
+        Socket::CreateSocket(m_nodes->Get(0), TypeId::LookupByName("ns3::UdpSocketFactory"));
+    m_sendSocket->Bind();
+    m_sendSocket->Connect(InetSocketAddress(interfaces.GetAddress(m_size - 1), m_port));
+    Simulator::ScheduleWithContext(m_sendSocket->GetNode()->GetId(),
+                                   Seconds(1.0),
+                                   &RreqSuppressionLadderTest::SendData,
+                                   this,
+                                   m_sendSocket);
+
+    m_recvSocket = Socket::CreateSocket(m_nodes->Get(m_size - 1),
+                                        TypeId::LookupByName("ns3::UdpSocketFactory"));
+    m_recvSocket->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_port));
+    m_recvSocket->SetRecvCallback(MakeCallback(&RreqSuppressionLadderTest::HandleRead, this));
+}
+
+void
+RreqSuppressionLadderTest::CheckResults()
+{
+    // Every 0.25 s from 1 s to 3 s
+    NS_TEST_EXPECT_MSG_EQ(m_sentPackets, 8, "trivial");
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPackets, m_sentPackets, "Did not receive expected packets");
+    uint64_t suppressed = RaodvHelper::GetStats(*m_nodes).GetSuppressed(raodv::RAODVTYPE_RREQ);
+    if (m_suppression)
+    {
+        NS_TEST_EXPECT_MSG_GT(suppressed, 0, "No rung cancelled its rebroadcast");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(suppressed, 0, "Suppressed a RREQ with the suppression off");
+    }
+}
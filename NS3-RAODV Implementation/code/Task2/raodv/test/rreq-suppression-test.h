@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026 raodv contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RREQ_SUPPRESSION_TEST_H
+#define RREQ_SUPPRESSION_TEST_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup raodv
+ *
+ * \brief raodv RREQ suppression ladder test
+ *
+ * Two parallel four node chains, 10 m apart, form a ladder.  The first node of the first chain
+ * sends UDP packets to the last one every 0.25 s.  Every RREQ reaches both nodes of a rung, which
+ * hear each other far above RreqSuppressionRssi.  In Distance mode one of them cancels its
+ * rebroadcast, yet all packets are delivered.  Without suppression nothing is suppressed.
+ */
+class RreqSuppressionLadderTest : public TestCase
+{
+  public:
+    /**
+     * Create test case
+     *
+     * \param suppression         Use the Distance RREQ suppression
+     */
+    RreqSuppressionLadderTest(bool suppression);
+    ~RreqSuppressionLadderTest() override;
+
+  private:
+    /// \internal It is important to have pointers here
+    NodeContainer* m_nodes;
+
+    /// Total simulation time
+    const Time m_time;
+    /// Chain size
+    const uint32_t m_size;
+    /// Chain step, meters
+    const double m_step;
+    /// Distance between the two chains, meters
+    const double m_rung;
+    /// port number
+    const uint16_t m_port;
+    /// Use the Distance RREQ suppression
+    const bool m_suppression;
+
+    /// Create test topology
+    void CreateNodes();
+    /// Create devices, install TCP/IP stack and applications
+    void CreateDevices();
+    /// Check the delivered packets and the suppressed rebroadcasts
+    void CheckResults();
+    /// Go
+    void DoRun() override;
+    /**
+     * Receive data function
+     * \param socket the socket to receive from
+     */
+    void HandleRead(Ptr<Socket> socket);
+    /**
+     * Send data
+     * \param socket the sending socket
+     */
+    void SendData(Ptr<Socket> socket);
+
+    /// Receiving socket
+    Ptr<Socket> m_recvSocket;
+    /// Transmitting socket
+    Ptr<Socket> m_sendSocket;
+
+    /// Sent packet count
+    uint32_t m_sentPackets;
+    /// Received packet count
+    uint32_t m_receivedPackets;
+};
+
+#endif /* RREQ_SUPPRESSION_TEST_H */
@@ -65,8 +65,21 @@
 #include "ns3/olsr-module.h"
 #include "ns3/yans-wifi-helper.h"
 
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 using namespace dsr;
@@ -87,6 +100,13 @@ class RoutingExperiment
      */
     void Run();
 
+    /**
+     * Run the experiment for every combination of the sweep lists, in this process or, with
+     * more than one job, in worker processes.
+     * \return true if every point of the sweep completed.
+     */
+    bool Sweep();
+
     /**
      * Handles the command-line parameters.
      * \param argc The argument count.
@@ -95,6 +115,47 @@ class RoutingExperiment
     void CommandSetup(int argc, char** argv);
 
   private:
+    /// One point of a sweep and the outcome of its runs.
+    struct SweepPoint
+    {
+        std::string protocol;          //!< Routing protocol.
+        int nodes;                     //!< Number of nodes.
+        int rate;                      //!< Packet rate.
+        int speed;                     //!< Node speed.
+        uint64_t run;                  //!< RNG run number.
+        uint32_t attempts{0};          //!< Number of times the point was started.
+        std::string status{"pending"}; //!< "ok", or how the last attempt failed.
+        double seconds{0.0};           //!< Wall clock time of the last attempt.
+    };
+
+    /**
+     * Run the experiment for one point of a sweep.
+     * \param point The point.
+     * \param index The index of the point.
+     */
+    void RunPoint(const SweepPoint& point, size_t index);
+    /**
+     * Run every point in a forked worker process, at most m_jobs at a time, and merge the
+     * per-point CSV shards into the CSV file in point order.
+     * \param points The points, updated with the outcome of their runs.
+     */
+    void RunParallel(std::vector<SweepPoint>& points);
+    /**
+     * Write the manifest of a sweep.
+     * \param points The points and the outcome of their runs.
+     */
+    void WriteManifest(const std::vector<SweepPoint>& points) const;
+    /**
+     * \param index The index of a point.
+     * \return The name of the CSV shard of the point.
+     */
+    std::string GetShardName(size_t index) const;
+    /**
+     * \param name The name of a side file of a run, e.g. --memorySamples.
+     * \return The name with the suffix of the current sweep point before its extension.
+     */
+    std::string GetPointFileName(const std::string& name) const;
+
     /**
      * Setup the receiving socket in a Sink Node.
      * \param addr The address of the node.
@@ -107,6 +168,11 @@ class RoutingExperiment
      * \param socket The receiving socket.
      */
     void ReceivePacket(Ptr<Socket> socket);
+    /**
+     * Account a RAODV control packet handed to a socket.
+     * \param packet The control packet.
+     */
+    void TxControl(Ptr<const Packet> packet);
     /**
      * Compute the throughput.
      */
@@ -115,6 +181,8 @@ class RoutingExperiment
     uint32_t port{9};            //!< Receiving port number.
     uint32_t bytesTotal{0};      //!< Total received bytes.
     uint32_t packetsReceived{0}; //!< Total received packets.
+    uint64_t dataBytesDelivered{0}; //!< Data bytes delivered to sinks over the whole run.
+    uint64_t controlBytesSent{0};   //!< RAODV control bytes sent over the whole run.
 
     std::string m_CSVfileName{"manet-routing.output.csv"}; //!< CSV filename.
     int m_nSinks{10};                                      //!< Number of sink nodes.
@@ -125,8 +193,65 @@ class RoutingExperiment
     int numNode{0};
     int packetRate{0};
     int speed{0};
+    bool m_compact{false}; //!< Enable compact RAODV RREQ encoding.
+    bool m_coalesce{false}; //!< Enable RAODV control message coalescing.
+    std::string m_rreqSuppression{"None"}; //!< RAODV RREQ rebroadcast suppression mode.
+    double m_revRreqGossip{1.0}; //!< RAODV reverse request rebroadcast probability.
+    bool m_localRepair{false}; //!< Enable RAODV local repair of broken routes.
+    uint32_t m_backupRoutes{0}; //!< RAODV backup next hops kept per destination.
+    std::string m_requestZone{"None"}; //!< RAODV location-aided request zone.
+    bool m_adaptiveDiscovery{false}; //!< Enable RAODV adaptive discovery TTLs and timeouts.
+    bool m_routeRefresh{false}; //!< Enable RAODV refresh of the routes of paused flows.
+    double m_offTime{0.0};      //!< OnOff application off time in seconds (bursty traffic).
+    bool m_linkBreakPrediction{false}; //!< Enable RAODV link break prediction from the RSSI.
+    std::string m_pathLoad{"None"};    //!< RAODV load metric for path selection.
+    std::string m_recordOps{""};       //!< File to record RAODV data structure operations to.
+    double m_totalTime{200.0};         //!< Simulated time in seconds.
+    std::string m_memorySamples{""};   //!< File to sample RAODV memory footprints to.
+    std::string m_sweepNodes{""};      //!< Node counts of a sweep, comma separated.
+    std::string m_sweepRates{""};      //!< Packet rates of a sweep, comma separated.
+    std::string m_sweepSpeeds{""};     //!< Node speeds of a sweep, comma separated.
+    std::string m_sweepProtocols{""};  //!< Protocols of a sweep, comma separated.
+    std::string m_sweepRuns{""};       //!< RNG run numbers of a sweep, comma separated.
+    uint32_t m_jobs{1};                //!< Worker processes of a sweep, 1 to run in process.
+    uint32_t m_retries{1};             //!< Reruns of a crashed sweep point.
+    std::string m_manifest{""};        //!< Manifest file of a sweep.
+    std::string m_commandLine{""};     //!< The command line, for the manifest.
+    bool m_perPointFiles{false};       //!< Give the side files of each sweep point a suffix.
+    std::string m_pointSuffix{""};     //!< Suffix of the side files of the current point.
+    bool m_sharedProcess{false};       //!< Several sweep points run in this process.
 };
 
+/**
+ * Split a comma separated list.
+ * \param list The list, e.g. "20,40,70".
+ * \param fallback The only value if the list is empty.
+ * \return The values.
+ */
+template <typename T>
+static std::vector<T>
+ParseList(const std::string& list, T fallback)
+{
+    std::vector<T> values;
+    std::istringstream is(list);
+    std::string item;
+    while (std::getline(is, item, ','))
+    {
+        std::istringstream itemStream(item);
+        T value;
+        if (!(itemStream >> value))
+        {
+            NS_FATAL_ERROR("Bad list item: " << item);
+        }
+        values.push_back(value);
+    }
+    if (values.empty())
+    {
+        values.push_back(fallback);
+    }
+    return values;
+}
+
 RoutingExperiment::RoutingExperiment()
 {
 }
@@ -158,11 +283,18 @@ RoutingExperiment::ReceivePacket(Ptr<Socket> socket)
     while ((packet = socket->RecvFrom(senderAddress)))
     {
         bytesTotal += packet->GetSize();
+        dataBytesDelivered += packet->GetSize();
         packetsReceived += 1;
         NS_LOG_UNCOND(PrintReceivedPacket(socket, packet, senderAddress));
     }
 }
 
+void
+RoutingExperiment::TxControl(Ptr<const Packet> packet)
+{
+    controlBytesSent += packet->GetSize();
+}
+
 void
 RoutingExperiment::CheckThroughput()
 {
@@ -202,178 +334,370 @@ RoutingExperiment::CommandSetup(int argc, char** argv)
     cmd.AddValue("node", "enable node", numNode);
     cmd.AddValue("rate", "enable rate", packetRate);
     cmd.AddValue("speed", "enable speed",speed);
+    cmd.AddValue("compact", "enable compact RAODV RREQ encoding", m_compact);
+    cmd.AddValue("coalesce", "enable RAODV control message coalescing", m_coalesce);
+    cmd.AddValue("rreqSuppression",
+                 "RAODV RREQ rebroadcast suppression: None, Counter or Distance",
+                 m_rreqSuppression);
+    cmd.AddValue("revRreqGossip",
+                 "RAODV reverse request rebroadcast probability beyond the first hop",
+                 m_revRreqGossip);
+    cmd.AddValue("localRepair", "enable RAODV local repair of broken routes", m_localRepair);
+    cmd.AddValue("backupRoutes",
+                 "RAODV backup next hops kept per destination (0 disables failover)",
+                 m_backupRoutes);
+    cmd.AddValue("requestZone",
+                 "RAODV location-aided request zone: None, Rectangle or Cone",
+                 m_requestZone);
+    cmd.AddValue("adaptiveDiscovery",
+                 "enable RAODV discovery TTLs and timeouts learned from observed paths",
+                 m_adaptiveDiscovery);
+    cmd.AddValue("routeRefresh",
+                 "enable RAODV refresh of the routes of paused flows",
+                 m_routeRefresh);
+    cmd.AddValue("offTime",
+                 "off time in seconds between the 1 s bursts of each flow (0 for constant rate)",
+                 m_offTime);
+    cmd.AddValue("linkBreakPrediction",
+                 "enable RAODV link break prediction from the received signal strength",
+                 m_linkBreakPrediction);
+    cmd.AddValue("pathLoad",
+                 "RAODV congestion-aware path selection metric: None, Sum or Max",
+                 m_pathLoad);
+    cmd.AddValue("recordOps",
+                 "record RAODV routing data structure operations to this file for raodv-replay",
+                 m_recordOps);
+    cmd.AddValue("time", "simulated time in seconds", m_totalTime);
+    cmd.AddValue("memorySamples",
+                 "write the RAODV memory footprint of every node each second to this CSV file",
+                 m_memorySamples);
+    cmd.AddValue("sweepNodes", "sweep over these node counts, e.g. 20,40,70,100", m_sweepNodes);
+    cmd.AddValue("sweepRates", "sweep over these packet rates", m_sweepRates);
+    cmd.AddValue("sweepSpeeds", "sweep over these node speeds", m_sweepSpeeds);
+    cmd.AddValue("sweepProtocols", "sweep over these protocols", m_sweepProtocols);
+    cmd.AddValue("sweepRuns", "sweep over these RNG run numbers", m_sweepRuns);
+    cmd.AddValue("jobs", "run the points of a sweep in this many worker processes", m_jobs);
+    cmd.AddValue("retries", "rerun a crashed sweep point up to this many times", m_retries);
+    cmd.AddValue("manifest",
+                 "write the config, seed and duration of every sweep point to this JSON file "
+                 "(default with jobs > 1: <CSVfileName>.manifest.json)",
+                 m_manifest);
     cmd.Parse(argc, argv);
 
+    for (int i = 0; i < argc; ++i)
+    {
+        m_commandLine += (i > 0 ? " " : "") + std::string(argv[i]);
+    }
+    if (m_jobs > 1 && m_manifest.empty())
+    {
+        m_manifest = m_CSVfileName + ".manifest.json";
+    }
+
     std::vector<std::string> allowedProtocols{"OLSR", "RAODV", "DSDV", "DSR"};
 
-    if (std::find(std::begin(allowedProtocols), std::end(allowedProtocols), m_protocolName) ==
-        std::end(allowedProtocols))
+    for (const std::string& protocol : ParseList(m_sweepProtocols, m_protocolName))
     {
-        NS_FATAL_ERROR("No such protocol:" << m_protocolName);
+        if (std::find(std::begin(allowedProtocols), std::end(allowedProtocols), protocol) ==
+            std::end(allowedProtocols))
+        {
+            NS_FATAL_ERROR("No such protocol:" << protocol);
+        }
     }
 }
 
-int
-main(int argc, char* argv[])
+bool
+RoutingExperiment::Sweep()
 {
-    RoutingExperiment experiment;
-    experiment.CommandSetup(argc, argv);
-    experiment.Run();
+    // Each list defaults to the value of the single run option
+    std::vector<std::string> protocols = ParseList(m_sweepProtocols, m_protocolName);
+    std::vector<int> nodes = ParseList(m_sweepNodes, numNode);
+    std::vector<int> rates = ParseList(m_sweepRates, packetRate);
+    std::vector<int> speeds = ParseList(m_sweepSpeeds, speed);
+    std::vector<uint64_t> runs = ParseList(m_sweepRuns, RngSeedManager::GetRun());
+
+    std::vector<SweepPoint> points;
+    for (const std::string& protocol : protocols)
+    {
+        for (int n : nodes)
+        {
+            for (int r : rates)
+            {
+                for (int s : speeds)
+                {
+                    for (uint64_t run : runs)
+                    {
+                        points.push_back({protocol, n, r, s, run});
+                    }
+                }
+            }
+        }
+    }
+
+    // Side files such as --memorySamples would otherwise be rewritten by every point
+    m_perPointFiles = points.size() > 1;
+    if (m_jobs > 1)
+    {
+        RunParallel(points);
+    }
+    else
+    {
+        // getrusage only reports the peak of the whole process, not of one point
+        m_sharedProcess = points.size() > 1;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            SweepPoint& point = points[i];
+            auto start = std::chrono::steady_clock::now();
+            point.attempts = 1;
+            RunPoint(point, i);
+            point.status = "ok";
+            point.seconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
 
-    return 0;
+    if (!m_manifest.empty())
+    {
+        WriteManifest(points);
+    }
+    return std::all_of(points.begin(), points.end(), [](const SweepPoint& point) {
+        return point.status == "ok";
+    });
 }
-/*
-void RoutingExperiment::Run()
+
+void
+RoutingExperiment::RunPoint(const SweepPoint& point, size_t index)
 {
-    Packet::EnablePrinting();
+    NS_LOG_UNCOND("Running simulation: Protocol=" << point.protocol << ", NumNodes=" << point.nodes
+                                                  << ", Rate=" << point.rate
+                                                  << ", Speed=" << point.speed
+                                                  << ", Run=" << point.run);
+    m_protocolName = point.protocol;
+    numNode = point.nodes;
+    packetRate = point.rate;
+    speed = point.speed;
+    RngSeedManager::SetRun(point.run);
+    m_pointSuffix = m_perPointFiles ? "-" + std::to_string(index) : "";
+    Run();
+}
 
-    // Open the CSV file and write the header
-    std::ofstream out(m_CSVfileName);
-    out << "Nodes,Packet Transfer Rate(per s),NodeSpeed,Throughput,End to End Delay,Packet Delivery Ratio,Packet Drop Ratio\n";
-    out.close();
+std::string
+RoutingExperiment::GetShardName(size_t index) const
+{
+    return m_CSVfileName + ".shard" + std::to_string(index);
+}
+
+std::string
+RoutingExperiment::GetPointFileName(const std::string& name) const
+{
+    size_t dot = name.rfind('.');
+    size_t slash = name.rfind('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+        return name + m_pointSuffix;
+    }
+    return name.substr(0, dot) + m_pointSuffix + name.substr(dot);
+}
 
-    // Define parameter ranges
-    // std::vector<int> numNodes = {20, 40, 70, 100};   // Number of nodes
-    // std::vector<int> rates = {100, 200, 300, 400};   // Packet rates in packets per second
-    // std::vector<int> speeds = {5, 10, 15, 20};       // Node speeds in m/s
-    std::vector<int> numNodes = {20};   // Number of nodes
-    std::vector<int> rates = {100};   // Packet rates in packets per second
-    std::vector<int> speeds = {5};       // Node speeds in m/s
+void
+RoutingExperiment::RunParallel(std::vector<SweepPoint>& points)
+{
+    using Clock = std::chrono::steady_clock;
 
-    double TotalTime = 200.0;  // Simulation time in seconds
-    std::string phyMode("DsssRate11Mbps");
+    std::deque<size_t> pending;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        pending.push_back(i);
+    }
+    // Worker process -> point and start time
+    std::map<pid_t, std::pair<size_t, Clock::time_point>> running;
 
-    // Loop through all parameter combinations
-    for (int n : numNodes)
+    while (!pending.empty() || !running.empty())
     {
-        for (int r : rates)
+        while (!pending.empty() && running.size() < m_jobs)
         {
-            for (int s : speeds)
+            size_t index = pending.front();
+            pending.pop_front();
+            SweepPoint& point = points[index];
+            std::remove(GetShardName(index).c_str());
+            point.attempts++;
+            // The worker inherits the buffers; flush them so that nothing is written twice
+            std::cout.flush();
+            std::clog.flush();
+            pid_t pid = fork();
+            if (pid < 0)
             {
-                NS_LOG_UNCOND("Running simulation: NumNodes=" << n << ", Rate=" << r << ", Speed=" << s);
-
-                // Create nodes
-                NodeContainer adhocNodes;
-                adhocNodes.Create(n);
-
-                // Wi-Fi configuration
-                WifiHelper wifi;
-                wifi.SetStandard(WIFI_STANDARD_80211b);
-
-                YansWifiPhyHelper wifiPhy;
-                YansWifiChannelHelper wifiChannel;
-                wifiChannel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
-                wifiChannel.AddPropagationLoss("ns3::FriisPropagationLossModel");
-                wifiPhy.SetChannel(wifiChannel.Create());
-
-                WifiMacHelper wifiMac;
-                wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
-                                             "DataMode", StringValue(phyMode),
-                                             "ControlMode", StringValue(phyMode));
-                wifiMac.SetType("ns3::AdhocWifiMac");
-                NetDeviceContainer adhocDevices = wifi.Install(wifiPhy, wifiMac, adhocNodes);
-
-                // Mobility configuration
-                MobilityHelper mobilityAdhoc;
-                ObjectFactory pos;
-                pos.SetTypeId("ns3::RandomRectanglePositionAllocator");
-                pos.Set("X", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=300.0]"));
-                pos.Set("Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=1500.0]"));
-
-                Ptr<PositionAllocator> taPositionAlloc = pos.Create()->GetObject<PositionAllocator>();
-                mobilityAdhoc.SetPositionAllocator(taPositionAlloc);
-
-                std::stringstream ssSpeed;
-                ssSpeed << "ns3::UniformRandomVariable[Min=0.0|Max=" << s << "]";
-                mobilityAdhoc.SetMobilityModel("ns3::RandomWaypointMobilityModel",
-                                               "Speed", StringValue(ssSpeed.str()),
-                                               "Pause", StringValue("ns3::ConstantRandomVariable[Constant=0.0]"),
-                                               "PositionAllocator", PointerValue(taPositionAlloc));
-                mobilityAdhoc.Install(adhocNodes);
-
-                // Internet stack with AODV
-                AodvHelper aodv;
-                InternetStackHelper internet;
-                internet.SetRoutingHelper(aodv);
-                internet.Install(adhocNodes);
-
-                // Assign IP addresses
-                Ipv4AddressHelper addressAdhoc;
-                addressAdhoc.SetBase("10.1.1.0", "255.255.255.0");
-                Ipv4InterfaceContainer adhocInterfaces = addressAdhoc.Assign(adhocDevices);
-
-                // Traffic configuration
-                OnOffHelper onoff("ns3::UdpSocketFactory", Address());
-                onoff.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1.0]"));
-                onoff.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0.0]"));
-                onoff.SetAttribute("DataRate", DataRateValue(DataRate(std::to_string(r*64*8) + "bps")));
-                onoff.SetAttribute("PacketSize", UintegerValue(64));
-
-                int numFlows = n / 2; // Number of flows is half the total number of nodes
-
-                for (int i = 0; i < numFlows; i++)
-                {
-                    Ptr<Socket> sink = SetupPacketReceive(adhocInterfaces.GetAddress(i), adhocNodes.Get(i));
-                    AddressValue remoteAddress(InetSocketAddress(adhocInterfaces.GetAddress(i), port));
-                    onoff.SetAttribute("Remote", remoteAddress);
-
-                    Ptr<UniformRandomVariable> var = CreateObject<UniformRandomVariable>();
-                    ApplicationContainer app = onoff.Install(adhocNodes.Get(i + numFlows));
-                    app.Start(Seconds(var->GetValue(100.0, 101.0)));
-                    app.Stop(Seconds(TotalTime));
-                }
-
-                // FlowMonitor configuration
-                FlowMonitorHelper flowmonHelper;
-                Ptr<FlowMonitor> flowmon = flowmonHelper.InstallAll();
-
-                // Run the simulation
-                Simulator::Stop(Seconds(TotalTime));
-                Simulator::Run();
-
-                // Collect metrics
-                Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
-                std::map<FlowId, FlowMonitor::FlowStats> stats = flowmon->GetFlowStats();
+                NS_FATAL_ERROR("Cannot fork a sweep worker: " << std::strerror(errno));
+            }
+            if (pid == 0)
+            {
+                // The parent never runs a simulation, so the worker starts from a clean
+                // simulator and writes its rows to its own shard
+                m_CSVfileName = GetShardName(index);
+                RunPoint(point, index);
+                std::cout.flush();
+                std::clog.flush();
+                _exit(0);
+            }
+            running[pid] = std::make_pair(index, Clock::now());
+        }
 
-                double throughput = 0.0, delay = 0.0, pdr = 0.0, dropRatio = 0.0;
-                uint32_t totalTxPackets = 0, totalRxPackets = 0, totalDroppedPackets = 0;
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            NS_FATAL_ERROR("Cannot wait for the sweep workers: " << std::strerror(errno));
+        }
+        auto it = running.find(pid);
+        if (it == running.end())
+        {
+            continue;
+        }
+        size_t index = it->second.first;
+        SweepPoint& point = points[index];
+        point.seconds = std::chrono::duration<double>(Clock::now() - it->second.second).count();
+        running.erase(it);
 
-                for (const auto &flow : stats)
-                {
-                    totalTxPackets += flow.second.txPackets;
-                    totalRxPackets += flow.second.rxPackets;
-                    totalDroppedPackets += (flow.second.txPackets - flow.second.rxPackets);
-                    throughput += (flow.second.rxBytes * 8.0) / (TotalTime * 1000.0); // kbps
-                    delay += (flow.second.rxPackets > 0) ? (flow.second.delaySum.GetSeconds() / flow.second.rxPackets) : 0.0;
-                }
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+            std::ifstream(GetShardName(index)).good())
+        {
+            point.status = "ok";
+            continue;
+        }
+        std::ostringstream reason;
+        if (WIFSIGNALED(status))
+        {
+            reason << "signal " << WTERMSIG(status);
+        }
+        else if (WIFEXITED(status) && WEXITSTATUS(status) != 0)
+        {
+            reason << "exit " << WEXITSTATUS(status);
+        }
+        else
+        {
+            reason << "no output";
+        }
+        point.status = reason.str();
+        bool retry = point.attempts <= m_retries;
+        NS_LOG_UNCOND("Sweep point " << index << " failed (" << point.status << ") after attempt "
+                                     << point.attempts << (retry ? ", retrying" : ", giving up"));
+        if (retry)
+        {
+            pending.push_back(index);
+        }
+    }
 
-                if (totalTxPackets > 0)
+    // Merge the shards in point order, so that the CSV does not depend on the scheduling. Every
+    // shard starts with the header; it is only kept if the CSV file is new.
+    std::ofstream out(m_CSVfileName, std::ios::app);
+    bool needHeader = out.tellp() == 0;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        if (points[i].status == "ok")
+        {
+            std::ifstream shard(GetShardName(i));
+            std::string line;
+            bool first = true;
+            while (std::getline(shard, line))
+            {
+                if (first)
                 {
-                    pdr = (double)totalRxPackets / totalTxPackets * 100.0;
-                    dropRatio = (double)totalDroppedPackets / totalTxPackets * 100.0;
+                    first = false;
+                    if (!needHeader)
+                    {
+                        continue;
+                    }
+                    needHeader = false;
                 }
-
-                // Log results
-                std::ofstream out(m_CSVfileName, std::ios::app);
-                out << n << "," << r << "," << s << "," << throughput << "," << delay << "," << pdr << "," << dropRatio << "\n";
-                out.close();
-
-                Simulator::Destroy();
+                out << line << "\n";
             }
         }
+        std::remove(GetShardName(i).c_str());
     }
 }
 
+/**
+ * Quote a string for JSON.
+ * \param value The string.
+ * \return The quoted string.
+ */
+static std::string
+JsonQuote(const std::string& value)
+{
+    std::ostringstream os;
+    os << '"';
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            os << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            os << ' ';
+        }
+        else
+        {
+            os << c;
+        }
+    }
+    os << '"';
+    return os.str();
+}
 
+void
+RoutingExperiment::WriteManifest(const std::vector<SweepPoint>& points) const
+{
+    std::ofstream manifest(m_manifest);
+    if (!manifest.is_open())
+    {
+        NS_LOG_UNCOND("Cannot write the sweep manifest " << m_manifest);
+        return;
+    }
+    manifest << "{\n"
+             << "  \"command\": " << JsonQuote(m_commandLine) << ",\n"
+             << "  \"output\": " << JsonQuote(m_CSVfileName) << ",\n"
+             << "  \"time\": " << m_totalTime << ",\n"
+             << "  \"jobs\": " << m_jobs << ",\n"
+             << "  \"retries\": " << m_retries << ",\n"
+             << "  \"seed\": " << RngSeedManager::GetSeed() << ",\n"
+             << "  \"points\": [\n";
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const SweepPoint& point = points[i];
+        manifest << "    {\"index\": " << i << ", \"protocol\": " << JsonQuote(point.protocol)
+                 << ", \"nodes\": " << point.nodes << ", \"rate\": " << point.rate
+                 << ", \"speed\": " << point.speed << ", \"run\": " << point.run
+                 << ", \"attempts\": " << point.attempts
+                 << ", \"status\": " << JsonQuote(point.status)
+                 << ", \"seconds\": " << point.seconds << "}"
+                 << (i + 1 < points.size() ? "," : "") << "\n";
+    }
+    manifest << "  ]\n}\n";
+}
 
-
-*/
+int
+main(int argc, char* argv[])
+{
+    RoutingExperiment experiment;
+    experiment.CommandSetup(argc, argv);
+    return experiment.Sweep() ? 0 : 1;
+}
 
 void
 RoutingExperiment::Run()
 {
     Packet::EnablePrinting();
 
+    // Counters of a previous sweep point
+    bytesTotal = 0;
+    packetsReceived = 0;
+    dataBytesDelivered = 0;
+    controlBytesSent = 0;
+
     // blank out the last output file and write the column headers
     // std::ofstream out(m_CSVfileName);
     // out << "SimulationSecond,"
@@ -387,7 +711,7 @@ RoutingExperiment::Run()
     std::ofstream out(m_CSVfileName, std::ios::app);
     //out << "Nodes,Packet Transfer Rate(per s),NodeSpeed,Throughput,End to End Delay,Packet Delivery Ratio,Packet Drop Ratio\n";
     if (out.tellp() == 0) {  // Check if the file is empty
-        out << "Nodes,Packet Transfer Rate(per s),NodeSpeed,Throughput,End to End Delay,Packet Delivery Ratio,Packet Drop Ratio\n";
+        out << "Nodes,Packet Transfer Rate(per s),NodeSpeed,Throughput,End to End Delay,Packet Delivery Ratio,Packet Drop Ratio,Control Bytes per Data Byte,Simulator Events,Normalized Routing Load,Discovery Latency p50 (ms),Discovery Latency p95 (ms),Discovery Latency p99 (ms),Discovery Failure Rate,Wall Clock (s),Events per Second,Peak RSS (KB),RAODV Table Bytes,RAODV Queue Bytes,RAODV Cache Bytes,Protocol,Run\n";
     }
     out.close();
 
@@ -395,7 +719,7 @@ RoutingExperiment::Run()
     
     int nWifis = numNode;
 
-    double TotalTime = 200.0;
+    double TotalTime = m_totalTime;
     std::string rate("2048bps");
     std::string phyMode("DsssRate11Mbps");
     std::string tr_name("manet-routing-compare");
@@ -405,28 +729,6 @@ RoutingExperiment::Run()
     int pktrate=packetRate;
     
 
-    // std::vector<int> numNodes = {20, 40, 70, 100};
-    // std::vector<int> rates = {100, 200, 300, 400};
-    // std::vector<int> speeds = {5, 10, 15, 20};
-        
-    // std::vector<int> numNodes = { 70};
-    // std::vector<int> rates = { 400};
-    // std::vector<int> speeds = {5, 10, 15, 20};
-
-    //Loop through all parameter combinations
-    // for (int nWifis : numNodes)
-    // {
-    //     for (int pktrate : rates)
-    //     {
-    //         for (int nodeSpeed : speeds)
-    //         {
-                    //int nWifis = numNode;
-
-    // double TotalTime = 200.0;
-    // std::string rate("2048bps");
-    // std::string phyMode("DsssRate11Mbps");
-    // std::string tr_name("manet-routing-compare");
-    // int nodePause = 0;
 
 
     Config::SetDefault("ns3::OnOffApplication::PacketSize", StringValue("64"));
@@ -488,6 +790,9 @@ RoutingExperiment::Run()
     mobilityAdhoc.SetPositionAllocator(taPositionAlloc);
     mobilityAdhoc.Install(adhocNodes);
     streamIndex += mobilityAdhoc.AssignStreams(adhocNodes, streamIndex);
+    // Fixed streams for everything else too, so that an in-process sweep point gives the same
+    // result as the same point run on its own
+    streamIndex += wifi.AssignStreams(adhocDevices, streamIndex);
 
     RaodvHelper raodv;
     OlsrHelper olsr;
@@ -502,12 +807,56 @@ RoutingExperiment::Run()
         list.Add(olsr, 100);
         internet.SetRoutingHelper(list);
         internet.Install(adhocNodes);
+        streamIndex += olsr.AssignStreams(adhocNodes, streamIndex);
     }
     else if (m_protocolName == "RAODV")
     {
+        if (m_compact)
+        {
+            raodv.Set("EnableCompactHeaders", BooleanValue(true));
+        }
+        if (m_coalesce)
+        {
+            raodv.Set("EnableCoalescing", BooleanValue(true));
+        }
+        raodv.Set("RreqSuppression", StringValue(m_rreqSuppression));
+        raodv.Set("RevRreqGossipProbability", DoubleValue(m_revRreqGossip));
+        if (m_localRepair)
+        {
+            raodv.Set("EnableLocalRepair", BooleanValue(true));
+        }
+        raodv.Set("MaxBackupRoutes", UintegerValue(m_backupRoutes));
+        raodv.Set("RequestZone", StringValue(m_requestZone));
+        raodv.Set("PathLoadMetric", StringValue(m_pathLoad));
+        if (!m_recordOps.empty() &&
+            !raodv::OperationRecorder::Open(GetPointFileName(m_recordOps)))
+        {
+            NS_FATAL_ERROR("Cannot open " << GetPointFileName(m_recordOps));
+        }
+        if (m_adaptiveDiscovery)
+        {
+            raodv.Set("AdaptiveDiscovery", BooleanValue(true));
+        }
+        if (m_routeRefresh)
+        {
+            raodv.Set("EnableRouteRefresh", BooleanValue(true));
+        }
+        if (m_linkBreakPrediction)
+        {
+            raodv.Set("LinkBreakPrediction", BooleanValue(true));
+        }
         list.Add(raodv, 100);
         internet.SetRoutingHelper(list);
         internet.Install(adhocNodes);
+        streamIndex += raodv.AssignStreams(adhocNodes, streamIndex);
+        Config::ConnectWithoutContext("/NodeList/*/$ns3::raodv::RoutingProtocol/TxControl",
+                                      MakeCallback(&RoutingExperiment::TxControl, this));
+        if (!m_memorySamples.empty())
+        {
+            RaodvHelper::PrintMemoryFootprintAllEvery(
+                Seconds(1),
+                Create<OutputStreamWrapper>(GetPointFileName(m_memorySamples), std::ios::out));
+        }
     }
     else if (m_protocolName == "DSDV")
     {
@@ -541,7 +890,9 @@ RoutingExperiment::Run()
     // Traffic configuration
     OnOffHelper onoff("ns3::UdpSocketFactory", Address());
     onoff.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1.0]"));
-    onoff.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0.0]"));
+    onoff.SetAttribute("OffTime",
+                       StringValue("ns3::ConstantRandomVariable[Constant=" +
+                                   std::to_string(m_offTime) + "]"));
     onoff.SetAttribute("DataRate", DataRateValue(DataRate(std::to_string(pktrate*64*8) + "bps")));
     onoff.SetAttribute("PacketSize", UintegerValue(64));
 
@@ -560,8 +911,12 @@ RoutingExperiment::Run()
         onoff.SetAttribute("Remote", remoteAddress);
 
         Ptr<UniformRandomVariable> var = CreateObject<UniformRandomVariable>();
+        var->SetStream(streamIndex++);
         ApplicationContainer app = onoff.Install(adhocNodes.Get(i + numFlows));
-        app.Start(Seconds(var->GetValue(100.0, 101.0)));
+        streamIndex +=
+            onoff.AssignStreams(NodeContainer(adhocNodes.Get(i + numFlows)), streamIndex);
+        // Traffic starts halfway through, at 100 s for the default 200 s run
+        app.Start(Seconds(var->GetValue(TotalTime / 2, TotalTime / 2 + 1.0)));
         app.Stop(Seconds(TotalTime));
     }
 
@@ -585,7 +940,7 @@ RoutingExperiment::Run()
 
 
     AsciiTraceHelper ascii;
-    MobilityHelper::EnableAsciiAll(ascii.CreateFileStream(tr_name + ".mob"));
+    MobilityHelper::EnableAsciiAll(ascii.CreateFileStream(GetPointFileName(tr_name + ".mob")));
 
     FlowMonitorHelper flowmonHelper;
     Ptr<FlowMonitor> flowmon;
@@ -600,11 +955,14 @@ RoutingExperiment::Run()
 
     // Run the simulation
     Simulator::Stop(Seconds(TotalTime));
+    auto wallStart = std::chrono::steady_clock::now();
     Simulator::Run();
+    std::chrono::duration<double> wallClock = std::chrono::steady_clock::now() - wallStart;
+    raodv::OperationRecorder::Close();
 
     if (m_flowMonitor)
     {
-        flowmon->SerializeToXmlFile(tr_name + ".flowmon", false, false);
+        flowmon->SerializeToXmlFile(GetPointFileName(tr_name + ".flowmon"), false, false);
         // Collect metrics
         Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
         std::map<FlowId, FlowMonitor::FlowStats> stats = flowmon->GetFlowStats();
@@ -634,7 +992,34 @@ RoutingExperiment::Run()
         out.open(m_CSVfileName, std::ios::app); 
         if (out.is_open())
         {
-            out << nWifis << "," << pktrate << "," << nodeSpeed << "," << throughput << "," << delay << "," << pdr << "," << dropRatio << "\n";
+            double controlPerData =
+                dataBytesDelivered > 0 ? double(controlBytesSent) / dataBytesDelivered : 0.0;
+            // Normalized routing load: control messages sent per data packet delivered
+            raodv::RoutingStats routingStats = RaodvHelper::GetStats(adhocNodes);
+            double nrl =
+                totalRxPackets > 0 ? double(routingStats.GetTotalTx()) / totalRxPackets : 0.0;
+            const raodv::LatencyHistogram& discovery = routingStats.GetDiscoveryLatency();
+            out << nWifis << "," << pktrate << "," << nodeSpeed << "," << throughput << "," << delay << "," << pdr << "," << dropRatio << "," << controlPerData << ","
+                << Simulator::GetEventCount() << "," << nrl << ","
+                << discovery.GetPercentile(0.5).GetMilliSeconds() << ","
+                << discovery.GetPercentile(0.95).GetMilliSeconds() << ","
+                << discovery.GetPercentile(0.99).GetMilliSeconds() << ","
+                << discovery.GetFailureRate() << ",";
+            // Cost of the run: ru_maxrss is the peak resident set size in KB on Linux. It
+            // covers the whole process, so it is left empty when sweep points share the process.
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            raodv::MemoryFootprint footprint = RaodvHelper::GetMemoryFootprint(adhocNodes);
+            out << wallClock.count() << ","
+                << (wallClock.count() > 0 ? Simulator::GetEventCount() / wallClock.count() : 0.0)
+                << ",";
+            if (!m_sharedProcess)
+            {
+                out << usage.ru_maxrss;
+            }
+            out << "," << footprint.routingTable << ","
+                << footprint.requestQueue << "," << footprint.idCaches << "," << m_protocolName
+                << "," << RngSeedManager::GetRun() << "\n";
             out.close();
         }
 
@@ -646,5 +1031,3 @@ RoutingExperiment::Run()
 
     Simulator::Destroy();
 }
-
-
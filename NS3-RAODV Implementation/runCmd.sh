@@ -156,4 +156,43 @@ for n in "${nodes[@]}"; do
             #echo "Appending results for Node=${n}, Rate=${pps}, Speed=${speed}" >> results1.csv
         done 
     done 
-done
\ No newline at end of file
+done
+
+
+# RAODV feature comparisons.  Each one is a single sweep of manet-routing-compare
+# over the listed node counts, rates and speeds (see --sweepNodes, --sweepRates
+# and --sweepSpeeds), run once per value of the feature option.
+run_sweep()
+{
+    command="./ns3 run \"scratch/manet-routing-compare --protocol=RAODV --flowMonitor=true $*\""
+    echo "Running: $command"
+    eval $command
+}
+
+run_sweep --CSVfileName=output_result_repair.csv --sweepNodes=70 --sweepRates=300 --sweepSpeeds=5,10,15,20 --localRepair=true
+
+for k in 1 2 3; do
+    run_sweep --CSVfileName=output_result_backup${k}.csv --sweepNodes=70 --sweepRates=300 --sweepSpeeds=20 --backupRoutes=${k}
+done
+
+for zone in None Rectangle Cone; do
+    run_sweep --CSVfileName=output_result_zone_${zone}.csv --sweepNodes=50,70,100 --sweepRates=300 --sweepSpeeds=20 --requestZone=${zone}
+done
+
+for adaptive in false true; do
+    run_sweep --CSVfileName=output_result_adaptive_${adaptive}.csv --sweepNodes=50,70,100 --sweepRates=300 --sweepSpeeds=20 --adaptiveDiscovery=${adaptive}
+done
+
+for refresh in false true; do
+    for off in 2 4 8; do
+        run_sweep --CSVfileName=output_result_refresh_${refresh}.csv --sweepNodes=50 --sweepRates=100 --sweepSpeeds=5 --offTime=${off} --routeRefresh=${refresh}
+    done
+done
+
+for predict in false true; do
+    run_sweep --CSVfileName=output_result_predict_${predict}.csv --sweepNodes=50 --sweepRates=100 --sweepSpeeds=15,20 --linkBreakPrediction=${predict}
+done
+
+for load in None Sum Max; do
+    run_sweep --CSVfileName=output_result_load_${load}.csv --sweepNodes=50 --sweepRates=200,300 --sweepSpeeds=5 --pathLoad=${load}
+done
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Scalability regression suite for RAODV.
+
+Runs manet-routing-compare with RAODV at growing node counts for a short
+simulated time, collects the cost columns of its CSV output (wall clock,
+simulator events per second, peak RSS and RAODV table/queue/cache bytes) and
+compares them against a stored baseline. Exits with status 1 if any metric is
+worse than the baseline by more than the tolerance.
+
+Run it from the ns-3 directory, like runCmd.sh:
+
+    python3 scalability.py                     # compare against the baseline
+    python3 scalability.py --update-baseline   # store the current numbers
+
+A missing baseline file is an error unless --update-baseline is given, so a
+misplaced baseline cannot make the suite pass silently. Wall clock, events
+per second and peak RSS depend on the machine, so baselines are only
+comparable on the machine that recorded them.
+"""
+
+import argparse
+import csv
+import os
+import shlex
+import subprocess
+import sys
+
+# Cost columns of the manet-routing-compare CSV and whether higher is better
+METRICS = [
+    ("Wall Clock (s)", False),
+    ("Events per Second", True),
+    ("Peak RSS (KB)", False),
+    ("RAODV Table Bytes", False),
+    ("RAODV Queue Bytes", False),
+    ("RAODV Cache Bytes", False),
+]
+
+# Metrics measured on the host rather than computed by the simulation
+TIMING_METRICS = {"Wall Clock (s)", "Events per Second"}
+
+
+def run_point(args, nodes):
+    """Run one simulation and return the cost columns of its CSV row."""
+    csv_name = f"scalability_{nodes}.csv"
+    if os.path.exists(csv_name):
+        os.remove(csv_name)
+    program = (
+        f"scratch/manet-routing-compare --CSVfileName={csv_name} --protocol=RAODV "
+        f"--flowMonitor=true --node={nodes} --rate={args.rate} --speed={args.speed} "
+        f"--time={args.time}"
+    )
+    command = [args.ns3, "run", program]
+    print("Running:", " ".join(shlex.quote(c) for c in command), flush=True)
+    if subprocess.run(command).returncode != 0:
+        return None
+    with open(csv_name, newline="") as f:
+        rows = list(csv.DictReader(f))
+    if not rows:
+        return None
+    return {name: float(rows[-1][name]) for name, _ in METRICS}
+
+
+def read_results(filename):
+    """Read a results or baseline file into {nodes: {metric: value}}."""
+    results = {}
+    with open(filename, newline="") as f:
+        for row in csv.DictReader(f):
+            results[int(row["Nodes"])] = {name: float(row[name]) for name, _ in METRICS}
+    return results
+
+
+def write_results(filename, results):
+    """Write {nodes: {metric: value}} with one row per node count."""
+    with open(filename, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["Nodes"] + [name for name, _ in METRICS])
+        for nodes in sorted(results):
+            writer.writerow([nodes] + [results[nodes][name] for name, _ in METRICS])
+
+
+def compare(args, results, baseline):
+    """Print the change of every metric and return the number of regressions."""
+    regressions = 0
+    for nodes in sorted(results):
+        if nodes not in baseline:
+            print(f"{nodes} nodes: not in the baseline")
+            continue
+        for name, higher_is_better in METRICS:
+            base = baseline[nodes][name]
+            value = results[nodes][name]
+            tolerance = args.time_tolerance if name in TIMING_METRICS else args.tolerance
+            if base == 0:
+                # No relative change from zero, e.g. an empty queue at the end of the run
+                change = "n/a"
+                worse = False
+            else:
+                ratio = value / base - 1
+                change = f"{ratio:+.1%}"
+                worse = -ratio > tolerance if higher_is_better else ratio > tolerance
+            status = "REGRESSION" if worse else "ok"
+            print(f"{nodes:>5} nodes  {name:<20} {base:>14g} -> {value:>14g}  {change:>8}  {status}")
+            regressions += worse
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--nodes", default="50,100,200,500,1000", help="node counts to run")
+    parser.add_argument("--time", type=float, default=20.0, help="simulated time in seconds")
+    parser.add_argument("--rate", type=int, default=100, help="packet rate per second")
+    parser.add_argument("--speed", type=int, default=10, help="node speed in m/s")
+    parser.add_argument(
+        "--tolerance",
+        type=float,
+        default=0.10,
+        help="allowed relative regression of the memory metrics",
+    )
+    parser.add_argument(
+        "--time-tolerance",
+        type=float,
+        default=0.25,
+        help="allowed relative regression of wall clock and events per second",
+    )
+    parser.add_argument("--baseline", default="scalability-baseline.csv", help="baseline file")
+    parser.add_argument("--output", default="scalability-result.csv", help="results file")
+    parser.add_argument(
+        "--update-baseline", action="store_true", help="store the results as the baseline"
+    )
+    parser.add_argument("--ns3", default="./ns3", help="ns3 launcher")
+    args = parser.parse_args()
+
+    if not args.update_baseline and not os.path.exists(args.baseline):
+        print(
+            f"No baseline in {args.baseline}; run with --update-baseline to store one",
+            file=sys.stderr,
+        )
+        return 2
+
+    results = {}
+    for nodes in (int(n) for n in args.nodes.split(",")):
+        point = run_point(args, nodes)
+        if point is None:
+            print(f"{nodes} nodes: simulation failed", file=sys.stderr)
+            return 2
+        results[nodes] = point
+    write_results(args.output, results)
+
+    if args.update_baseline:
+        write_results(args.baseline, results)
+        print(f"Stored the baseline in {args.baseline}")
+        return 0
+
+    regressions = compare(args, results, read_results(args.baseline))
+    if regressions:
+        print(f"{regressions} metric(s) regressed beyond the tolerance", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())